@@ -27,9 +27,14 @@
 #include "BattlescapeState.h"
 #include "../Savegame/Tile.h"
 #include "Pathfinding.h"
+#include "ReachabilityCache.h"
+#include "InfluenceMap.h"
 #include "../Engine/RNG.h"
+#include "../Engine/ThreadPool.h"
+#include "../Engine/Options.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Game.h"
+#include "../Engine/Profiler.h"
 #include "../Mod/Armor.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
@@ -218,6 +223,7 @@ void AIModule::dont_think(BattleAction *action)
  */
 void AIModule::think(BattleAction *action)
 {
+	OXCE_PROFILE_ZONE("AIModule::think");
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
@@ -2892,7 +2898,7 @@ bool AIModule::visibleToAnyFriend(BattleUnit* target) const
 void AIModule::brutalThink(BattleAction* action)
 {
 	// Step 1: Check whether we wait for someone else on our team to move first
-	int myReachable = (int)getReachableBy(_unit, _ranOutOfTUs, true).size();
+	int myReachable = (int)getReachableBy(_unit, _ranOutOfTUs, true)->size();
 	float myDist = 0;
 	bool IAmMindControlled = false;
 	if (_unit->getFaction() != _unit->getOriginalFaction())
@@ -2960,7 +2966,7 @@ void AIModule::brutalThink(BattleAction* action)
 				allyDist += Position::distance(ally->getPosition(), enemyPos);
 			}
 		}
-		allyReachable = (int)getReachableBy(ally, allyRanOutOfTUs).size();
+		allyReachable = (int)getReachableBy(ally, allyRanOutOfTUs)->size();
 		if (_ranOutOfTUs == false)
 		{
 			if (myReachable < allyReachable)
@@ -3031,8 +3037,10 @@ void AIModule::brutalThink(BattleAction* action)
 	if (!_unit->getArmor()->allowsMoving() || _unit->getEnergy() == 0)
 		immobile = true;
 	float targetDistanceTofurthestReach = FLT_MAX;
-	std::map<Position, int, PositionComparator> enemyReachable;
-	std::map<Position, int, PositionComparator> friendReachable;
+	InfluenceMap* influence = _save->getInfluenceMap();
+	influence->clear(IL_ENEMY_REACH);
+	influence->clear(IL_FRIEND_REACH);
+	updateThreatSources();
 	bool immobileEnemies = false;
 	float myAggressiveness = _unit->getAggressiveness();
 	if (_myFaction == FACTION_HOSTILE)
@@ -3055,10 +3063,7 @@ void AIModule::brutalThink(BattleAction* action)
 			totalAllyPower += getUnitPower(target);
 			if (target != _unit)
 			{
-				for (auto& reachablePosOfTarget : getReachableBy(target, _ranOutOfTUs, false, false))
-				{
-					friendReachable[reachablePosOfTarget.first] += reachablePosOfTarget.second;
-				}
+				influence->add(IL_FRIEND_REACH, *getReachableBy(target, _ranOutOfTUs, false, false));
 			}
 		}
 		if (isEnemy(target))
@@ -3133,10 +3138,7 @@ void AIModule::brutalThink(BattleAction* action)
 		if (!target->hasPanickedLastTurn())
 		{
 			_save->getPathfinding()->setIgnoreFriends(true);
-			for (auto& reachablePosOfTarget : getReachableBy(target, _ranOutOfTUs, false, true))
-			{
-				enemyReachable[reachablePosOfTarget.first] += reachablePosOfTarget.second;
-			}
+			influence->add(IL_ENEMY_REACH, *getReachableBy(target, _ranOutOfTUs, false, true));
 			_save->getPathfinding()->setIgnoreFriends(false);
 		}
 		BattleUnit* LoFCheckUnitForPath = NULL;
@@ -3173,7 +3175,8 @@ void AIModule::brutalThink(BattleAction* action)
 			float spotterScore = 0;
 			int higherSmoke = target->getTile()->getSmoke();
 			float bestTileSpotterScore = 0;
-			for (auto& reachablePosOfTarget : getReachableBy(target, _ranOutOfTUs, false, false))
+			const auto reachableOfTarget = getReachableBy(target, _ranOutOfTUs, false, false);
+			for (auto& reachablePosOfTarget : *reachableOfTarget)
 			{
 				bool canSpot = false;
 				float smallestEnemyDist = FLT_MAX;
@@ -3232,20 +3235,22 @@ void AIModule::brutalThink(BattleAction* action)
 				if (!_unit->isCheatOnMovement())
 					pos = _save->getTileCoords(target->getTileLastSpotted(_unit->getFaction()));
 				float discoverThreat = 0;
-				for (auto& reachable : friendReachable)
+				// tiles are sorted from highest value, first one in sight is the best one
+				for (int reachableIndex : influence->getTilesByValue(IL_FRIEND_REACH))
 				{
-					if (reachable.second > discoverThreat)
+					float reachableValue = influence->get(IL_FRIEND_REACH, reachableIndex);
+					if (reachableValue <= discoverThreat)
+						break;
+					Position reachablePos = influence->getPosition(reachableIndex);
+					for (int x = 0; x < target->getArmor()->getSize(); ++x)
 					{
-						for (int x = 0; x < target->getArmor()->getSize(); ++x)
+						for (int y = 0; y < target->getArmor()->getSize(); ++y)
 						{
-							for (int y = 0; y < target->getArmor()->getSize(); ++y)
-							{
-								Position compPos = pos;
-								compPos.x += x;
-								compPos.y += y;
-								if (weaponRange >= Position::distance(compPos, reachable.first) && hasTileSight(compPos, reachable.first))
-									discoverThreat = (float)reachable.second;
-							}
+							Position compPos = pos;
+							compPos.x += x;
+							compPos.y += y;
+							if (weaponRange >= Position::distance(compPos, reachablePos) && hasTileSight(compPos, reachablePos))
+								discoverThreat = reachableValue;
 						}
 					}
 				}
@@ -3480,9 +3485,9 @@ void AIModule::brutalThink(BattleAction* action)
 	float tuToSaveForHide = 0.5;
 	bool shouldSaveEnergy = _unit->getEnergy() + getEnergyRecovery(_unit) < _unit->getBaseStats()->stamina;
 	bool saveDistance = true;
-	for (auto& reachable : enemyReachable)
+	for (int reachableIndex : influence->getTiles(IL_ENEMY_REACH))
 	{
-		if (hasTileSight(myPos, reachable.first))
+		if (hasTileSight(myPos, influence->getPosition(reachableIndex)))
 		{
 			saveDistance = false;
 			break;
@@ -3789,20 +3794,21 @@ void AIModule::brutalThink(BattleAction* action)
 				}
 				if (!sweepMode && validCover)
 				{
-					for (auto& reachable : enemyReachable)
+					for (int reachableIndex : influence->getTilesByValue(IL_ENEMY_REACH))
 					{
-						if (reachable.second > discoverThreat)
+						float reachableValue = influence->get(IL_ENEMY_REACH, reachableIndex);
+						if (reachableValue <= discoverThreat)
+							break;
+						Position reachablePos = influence->getPosition(reachableIndex);
+						for (int x = 0; x < _unit->getArmor()->getSize(); ++x)
 						{
-							for (int x = 0; x < _unit->getArmor()->getSize(); ++x)
+							for (int y = 0; y < _unit->getArmor()->getSize(); ++y)
 							{
-								for (int y = 0; y < _unit->getArmor()->getSize(); ++y)
-								{
-									Position compPos = pos;
-									compPos.x += x;
-									compPos.y += y;
-									if (hasTileSight(compPos, reachable.first))
-										discoverThreat = (float)reachable.second;
-								}
+								Position compPos = pos;
+								compPos.x += x;
+								compPos.y += y;
+								if (hasTileSight(compPos, reachablePos))
+									discoverThreat = reachableValue;
 							}
 						}
 					}
@@ -6294,7 +6300,25 @@ bool AIModule::IsEnemyExposedEnough()
 	{
 		Log(LOG_INFO) << "startPos: " << startPosition;
 	}
-	std::vector<PathfindingNode *> enemySimulationNodes = _save->getPathfinding()->findReachablePathFindingNodes(_unit, BattleActionCost(), dummy, true, NULL, &startPosition);
+	InfluenceMap* influence = _save->getInfluenceMap();
+	ReachabilityKey exposureKey;
+	exposureKey.unitId = _unit->getId();
+	exposureKey.startIndex = _save->getTileIndex(startPosition);
+	exposureKey.tuMax = _unit->getTimeUnits();
+	exposureKey.energyMax = _unit->getEnergy();
+	if (!influence->hasExposure(exposureKey))
+	{
+		std::vector<PathfindingNode *> enemySimulationNodes = _save->getPathfinding()->findReachablePathFindingNodes(_unit, BattleActionCost(), dummy, true, NULL, &startPosition);
+		influence->setExposure(exposureKey);
+		for (size_t i = 0; i < enemySimulationNodes.size(); ++i)
+		{
+			int nodeIndex = _save->getTileIndex(enemySimulationNodes[i]->getPosition());
+			if (influence->has(IL_EXPOSURE, nodeIndex))
+				continue;
+			influence->set(IL_EXPOSURE, nodeIndex, InfluenceMap::ExposureCost, (float)enemySimulationNodes[i]->getTUCost(false).time);
+			influence->set(IL_EXPOSURE, nodeIndex, InfluenceMap::ExposureOrder, (float)i);
+		}
+	}
 	for (BattleUnit *enemy : _save->getUnits())
 	{
 		if (!isEnemy(enemy))
@@ -6314,7 +6338,7 @@ bool AIModule::IsEnemyExposedEnough()
 			return false;
 		turnsSinceSeen = std::max(turnsSinceSeen, 1);
 		int requiredTUFromStart = turnsSinceSeen * getMaxTU(enemy);
-		int neededTUToStart = tuCostToReachPosition(currentAssumedPosition, enemySimulationNodes, enemy);
+		int neededTUToStart = getExposureCost(currentAssumedPosition, enemy);
 		bool inSmoke = false;
 		if (_save->getTile(currentAssumedPosition) && _save->getTile(currentAssumedPosition)->getSmoke() > 0)
 			inSmoke = true;
@@ -6331,6 +6355,140 @@ bool AIModule::IsEnemyExposedEnough()
 	return false;
 }
 
+/**
+ * Gets TU cost of reaching position from the closest spawn tile, like `tuCostToReachPosition` with path nodes
+ * stored in exposure layer of influence map. Only nodes close enough to count are checked.
+ * @param pos Position to reach.
+ * @param actor Unit that is going there.
+ * @return TU cost of position or of the closest node that can see it, 10000 if there is none.
+ */
+int AIModule::getExposureCost(Position pos, BattleUnit* actor)
+{
+	float closestDistToTarget = 3;
+	float closestOrder = 0;
+	bool found = false;
+	int tuCostToClosestNode = 10000;
+	Tile *posTile = _save->getTile(pos);
+	if (!posTile)
+		return tuCostToClosestNode;
+	InfluenceMap* influence = _save->getInfluenceMap();
+	int posIndex = _save->getTileIndex(pos);
+	if (influence->has(IL_EXPOSURE, posIndex))
+		return (int)influence->get(IL_EXPOSURE, posIndex, InfluenceMap::ExposureCost);
+	// nodes with distance under 3 on same level, ties go to the one found first by search
+	for (int y = -2; y <= 2; ++y)
+	{
+		for (int x = -2; x <= 2; ++x)
+		{
+			Position nodePos = pos + Position(x, y, 0);
+			Tile *tile = _save->getTile(nodePos);
+			if (!tile)
+				continue;
+			int nodeIndex = _save->getTileIndex(nodePos);
+			if (!influence->has(IL_EXPOSURE, nodeIndex))
+				continue;
+			if (!posTile->hasNoFloor() && tile->hasNoFloor() && actor->getMovementType() != MT_FLY)
+				continue;
+			float currDist = Position::distance(pos, nodePos);
+			float order = influence->get(IL_EXPOSURE, nodeIndex, InfluenceMap::ExposureOrder);
+			if (currDist < closestDistToTarget || (found && currDist == closestDistToTarget && order < closestOrder))
+			{
+				if (hasTileSight(nodePos, pos))
+				{
+					found = true;
+					closestDistToTarget = currDist;
+					closestOrder = order;
+					tuCostToClosestNode = (int)influence->get(IL_EXPOSURE, nodeIndex, InfluenceMap::ExposureCost);
+				}
+			}
+		}
+	}
+	return tuCostToClosestNode;
+}
+
+/**
+ * Stores known positions of enemies in influence map, threat layer is made from them.
+ * Need to be called before asking for cover values when enemies could be seen or move.
+ */
+void AIModule::updateThreatSources()
+{
+	std::vector<Position> sources;
+	for (BattleUnit *enemy : _save->getUnits())
+	{
+		if (!enemy->isOut() && isEnemy(enemy))
+		{
+			if (!_unit->isCheatOnMovement() && enemy->getTileLastSpotted(_unit->getFaction()) == -1)
+				continue;
+			Position pos = _save->getTileCoords(enemy->getTileLastSpotted(_unit->getFaction()));
+			if (_unit->isCheatOnMovement())
+				pos = enemy->getPosition();
+			sources.push_back(pos);
+		}
+	}
+	_save->getInfluenceMap()->setThreatSources(sources);
+}
+
+/**
+ * Fills threat layer of influence map for tile: for every direction sum of inverted distances
+ * to known enemies in that direction.
+ * @param tile Tile to rate.
+ * @return Index of tile in influence map.
+ */
+int AIModule::fillThreat(Tile* tile)
+{
+	InfluenceMap* influence = _save->getInfluenceMap();
+	int tileIndex = _save->getTileIndex(tile->getPosition());
+	if (influence->has(IL_THREAT, tileIndex))
+		return tileIndex;
+	float threat[InfluenceMap::Directions] = { };
+	for (const Position& pos : influence->getThreatSources())
+	{
+		int enemyDir = _save->getTileEngine()->getDirectionTo(tile->getPosition(), pos);
+		float dist = Position::distance(tile->getPosition(), pos);
+		threat[enemyDir] += 1.0f / dist;
+	}
+	for (int direction = 0; direction < InfluenceMap::Directions; ++direction)
+		influence->set(IL_THREAT, tileIndex, direction, threat[direction]);
+	return tileIndex;
+}
+
+/**
+ * Fills cover layer of influence map for tile: for every direction blockage of `DT_NONE`
+ * and `DT_HE` between tile and its neighbour, -1 when there is no neighbour.
+ * @param tile Tile to rate.
+ * @return Index of tile in influence map.
+ */
+int AIModule::fillCover(Tile* tile)
+{
+	InfluenceMap* influence = _save->getInfluenceMap();
+	int tileIndex = _save->getTileIndex(tile->getPosition());
+	if (influence->has(IL_COVER, tileIndex))
+		return tileIndex;
+	for (int direction = 0; direction < InfluenceMap::Directions; ++direction)
+	{
+		Position posInDirection;
+		Pathfinding::directionToVector(direction, &posInDirection);
+		Tile *tileInDirection = _save->getTile(tile->getPosition() + posInDirection);
+		if (!tileInDirection)
+		{
+			influence->set(IL_COVER, tileIndex, direction, -1.0f);
+			continue;
+		}
+		influence->set(IL_COVER, tileIndex, direction, _save->getTileEngine()->horizontalBlockage(tileInDirection, tile, DT_NONE) / 255.0f);
+		influence->set(IL_COVER, tileIndex, InfluenceMap::Directions + direction, _save->getTileEngine()->horizontalBlockage(tileInDirection, tile, DT_HE) / 255.0f);
+	}
+	return tileIndex;
+}
+
+/**
+ * Gets how well tile covers unit from known enemies. Terrain blockage and directions of enemies
+ * come from influence map, they are calculated only when tile is rated first time after they change.
+ * Threat sources need to be up to date, see `updateThreatSources`.
+ * @param tile Tile to rate.
+ * @param bu Unit standing there.
+ * @param coverQuality How strict rating is, 1 and 2 give zero when enemy is in uncovered direction, over 3 count HE blockage always.
+ * @return Cover value.
+ */
 float AIModule::getCoverValue(Tile* tile, BattleUnit* bu, int coverQuality)
 {
 	if (tile == NULL)
@@ -6349,78 +6507,32 @@ float AIModule::getCoverValue(Tile* tile, BattleUnit* bu, int coverQuality)
 		tileFrom = _save->getAboveTile(tile);
 	if (tileFrom == NULL)
 		tileFrom = tile;
-	for (int direction = 0; direction <= 7; ++direction)
+	InfluenceMap* influence = _save->getInfluenceMap();
+	int threatIndex = fillThreat(tile);
+	int coverIndex = fillCover(tileFrom);
+	float threat[InfluenceMap::Directions];
+	float totalEnemies = 0;
+	for (int direction = 0; direction < InfluenceMap::Directions; ++direction)
 	{
-		Position posInDirection = tileFrom->getPosition();
-		switch (direction)
-		{
-		case 0:
-			posInDirection += Position(0, -1, 0);
-			break;
-		case 1:
-			posInDirection += Position(1, -1, 0);
-			break;
-		case 2:
-			posInDirection += Position(1, 0, 0);
-			break;
-		case 3:
-			posInDirection += Position(1, 1, 0);
-			break;
-		case 4:
-			posInDirection += Position(0, 1, 0);
-			break;
-		case 5:
-			posInDirection += Position(-1, 1, 0);
-			break;
-		case 6:
-			posInDirection += Position(-1, 0, 0);
-			break;
-		case 7:
-			posInDirection += Position(-1, -1, 0);
-			break;
-		}
-		Tile *tileInDirection = _save->getTile(posInDirection);
-		if (tileInDirection)
-		{
-			float totalEnemies = 0;
-			float enemiesInThisDirection = 0;
-			float trueDirection = 0;
-			for (BattleUnit *enemy : _save->getUnits())
-			{
-				if (!enemy->isOut() && isEnemy(enemy))
-				{
-					if (!_unit->isCheatOnMovement() && enemy->getTileLastSpotted(_unit->getFaction()) == -1)
-						continue;
-					Position pos = _save->getTileCoords(enemy->getTileLastSpotted(_unit->getFaction()));
-					if (_unit->isCheatOnMovement())
-						pos = enemy->getPosition();
-					int enemyDir = _save->getTileEngine()->getDirectionTo(tile->getPosition(), pos);
-					float dist = Position::distance(tile->getPosition(), pos);
-					if (direction == enemyDir)
-					{
-						enemiesInThisDirection += 1.0f / dist;
-						trueDirection += 1.0f / dist;
-					}
-					if (direction == enemyDir - 1 || (direction == 0 && enemyDir == 7))
-						enemiesInThisDirection += 0.5f / dist;
-					if (direction == enemyDir + 1 || (direction == 7 && enemyDir == 0))
-						enemiesInThisDirection += 0.5f / dist;
-					totalEnemies += 2.0f / dist;
-				}
-			}
-			float dirCoverMod = enemiesInThisDirection / totalEnemies;
-			std::vector<Position> traj;
-			float coverFromDir = 0;
-			coverFromDir += _save->getTileEngine()->horizontalBlockage(tileInDirection, tileFrom, DT_NONE) / 255.0f;
-			if (coverFromDir >= 1 || coverQuality > 3)
-				coverFromDir += _save->getTileEngine()->horizontalBlockage(tileInDirection, tileFrom, DT_HE) / 255.0f;
-			if (coverFromDir > 0)
-				cover += coverFromDir * dirCoverMod;
-			else if (coverQuality == 1 && enemiesInThisDirection > 0)
-				return 0;
-			else if (coverQuality == 2 && trueDirection > 0)
-				return 0;
-		}
+		threat[direction] = influence->get(IL_THREAT, threatIndex, direction);
+		totalEnemies += 2.0f * threat[direction];
+	}
+	for (int direction = 0; direction < InfluenceMap::Directions; ++direction)
+	{
+		float coverFromDir = influence->get(IL_COVER, coverIndex, direction);
+		if (coverFromDir < 0)
+			continue;
+		float trueDirection = threat[direction];
+		float enemiesInThisDirection = trueDirection + 0.5f * threat[(direction + 1) % 8] + 0.5f * threat[(direction + 7) % 8];
+		float dirCoverMod = enemiesInThisDirection / totalEnemies;
+		if (coverFromDir >= 1 || coverQuality > 3)
+			coverFromDir += influence->get(IL_COVER, coverIndex, InfluenceMap::Directions + direction);
+		if (coverFromDir > 0)
+			cover += coverFromDir * dirCoverMod;
+		else if (coverQuality == 1 && enemiesInThisDirection > 0)
+			return 0;
+		else if (coverQuality == 2 && trueDirection > 0)
+			return 0;
 	}
 	return cover;
 }
@@ -6428,6 +6540,7 @@ float AIModule::getCoverValue(Tile* tile, BattleUnit* bu, int coverQuality)
 float AIModule::highestCoverInRange(const std::vector<PathfindingNode *> nodeVector)
 {
 	float highestCover = 0;
+	updateThreatSources();
 	for (auto pn : nodeVector)
 	{
 		if (pn->getTUCost(false).time > getMaxTU(_unit) || pn->getTUCost(false).energy > _unit->getBaseStats()->stamina)
@@ -6467,64 +6580,140 @@ int AIModule::getEnergyRecovery(BattleUnit* unit)
 	return recovery;
 }
 
-std::map<Position, int, PositionComparator> AIModule::getReachableBy(BattleUnit* unit, bool& ranOutOfTUs, bool forceRecalc, bool useMaxTUs)
+/**
+ * Gets tiles reachable by unit, from position where our faction thinks it is.
+ * Results are shared with other AI units through the reachability cache of the battle.
+ * @param unit Unit that moves.
+ * @param ranOutOfTUs Set to true when search ran out of TUs.
+ * @param forceRecalc Ignore cached result.
+ * @param useMaxTUs Use full TUs and energy of unit instead of current ones.
+ * @return Reachable tiles with TUs left after reaching them, stays valid when cache drops them.
+ */
+ReachableAreaPtr AIModule::getReachableBy(BattleUnit* unit, bool& ranOutOfTUs, bool forceRecalc, bool useMaxTUs)
 {
-	std::map<Position, int, PositionComparator> tuAtPositionMap;
-	Position startPosition = _save->getTileCoords(unit->getTileLastSpotted(_unit->getFaction()));
-	if (_unit->isCheatOnMovement() || unit->getFaction() == _unit->getFaction())
-		startPosition = unit->getPosition();
-	if (startPosition == TileEngine::invalid)
-		return tuAtPositionMap;
-	if (unit->getPositionOfUpdate() == startPosition && unit->wasMaxTusOfUpdate() == useMaxTUs && !forceRecalc)
+	static const ReachableAreaPtr empty = std::make_shared<const ReachableArea>();
+	ReachabilityKey key;
+	Position startPosition;
+	if (!getReachabilityKey(unit, useMaxTUs, _save->getPathfinding()->getIgnoreFriends(), key, startPosition))
+		return empty;
+
+	auto* cache = _save->getReachabilityCache();
+	if (!forceRecalc)
 	{
-		ranOutOfTUs = unit->getRanOutOfTUs();
-		return unit->getReachablePositions();
+		if (auto area = cache->find(key))
+		{
+			ranOutOfTUs = area->getRanOutOfTUs();
+			return area;
+		}
 	}
 	std::vector<PathfindingNode*> reachable = _save->getPathfinding()->findReachablePathFindingNodes(unit, BattleActionCost(), ranOutOfTUs, false, NULL, &startPosition, false, useMaxTUs);
 	int TUs = unit->getTimeUnits();
 	if (useMaxTUs)
 		TUs = getMaxTU(unit);
-	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
-	{
-		tuAtPositionMap[(*it)->getPosition()] = TUs - (*it)->getTUCost(false).time;
-		//if (_traceAI && unit->getFaction() == _unit->getFaction())
-		//{
-		//	Tile* tile = _save->getTile((*it)->getPosition());
-		//	tile->setMarkerColor(unit->getId());
-		//	tile->setPreview(10);
-		//	tile->setTUMarker(TUs - (*it)->getTUCost(false).time);
-		//}
-	}
-	unit->setPositionOfUpdate(startPosition, useMaxTUs);
-	unit->setReachablePositions(tuAtPositionMap);
-	unit->setRanOutOfTUs(ranOutOfTUs);
-	return tuAtPositionMap;
+	return cache->store(key, reachable, TUs, ranOutOfTUs);
 }
 
-std::map<Position, int, PositionComparator> AIModule::getSmokeFearMap()
+/**
+ * Builds parameters of reachability search for unit, starting from position where our faction thinks it is.
+ * @param unit Unit that moves.
+ * @param useMaxTUs Use full TUs and energy of unit instead of current ones.
+ * @param ignoreFriends Search ignore units blocking the way.
+ * @param key Filled with parameters of search.
+ * @param startPosition Filled with start of search.
+ * @return False when we do not know where unit is.
+ */
+bool AIModule::getReachabilityKey(BattleUnit* unit, bool useMaxTUs, bool ignoreFriends, ReachabilityKey& key, Position& startPosition) const
 {
-	std::map<Position, int, PositionComparator> smokeFearMap;
-	for (int i = 0; i < _save->getMapSizeXYZ(); i++)
+	startPosition = _save->getTileCoords(unit->getTileLastSpotted(_unit->getFaction()));
+	if (_unit->isCheatOnMovement() || unit->getFaction() == _unit->getFaction())
+		startPosition = unit->getPosition();
+	if (startPosition == TileEngine::invalid)
+		return false;
+
+	key.unitId = unit->getId();
+	key.startIndex = _save->getTileIndex(startPosition);
+	key.tuMax = useMaxTUs ? unit->getBaseStats()->tu : unit->getTimeUnits();
+	key.energyMax = useMaxTUs ? unit->getBaseStats()->stamina : unit->getEnergy();
+	key.useMaxTUs = useMaxTUs;
+	key.ignoreFriends = ignoreFriends;
+	return true;
+}
+
+/**
+ * Speculatively calculates reachability of units that brutal-AI asks for while thinking:
+ * allies with current TUs and enemies with full TUs ignoring friends.
+ * Searches are independent and only read the battle, so they run on worker threads with their own pathfinding,
+ * while main thread waits and nothing can change. Results go to the shared reachability cache,
+ * so areas made outdated by later actions are dropped by its usual invalidation,
+ * and keys that do not match what thinking asks for are simply calculated again.
+ */
+void AIModule::prefetchReachability()
+{
+	/**
+	 * One search to do.
+	 */
+	struct Search
+	{
+		BattleUnit* unit;
+		ReachabilityKey key;
+		Position start;
+		int timeUnits;
+		std::unique_ptr<ReachableArea> area;
+	};
+
+	auto* cache = _save->getReachabilityCache();
+	std::vector<Search> searches;
+	for (BattleUnit* target : _save->getUnits())
 	{
-		Tile* tile = _save->getTile(i);
-		if (tile && tile->getSmoke() > 0)
-		{
-			smokeFearMap[tile->getPosition()] = tile->getSmoke();
-		}
+		if (target->isOut() || target == _unit)
+			continue;
+		bool useMaxTUs;
+		if (isAlly(target))
+			useMaxTUs = false;
+		else if (isEnemy(target) && !target->hasPanickedLastTurn())
+			useMaxTUs = true;
+		else
+			continue;
+
+		Search search;
+		search.unit = target;
+		if (!getReachabilityKey(target, useMaxTUs, useMaxTUs, search.key, search.start) || cache->find(search.key))
+			continue;
+		search.timeUnits = useMaxTUs ? getMaxTU(target) : target->getTimeUnits();
+		searches.push_back(std::move(search));
+	}
+	if (searches.size() <= 1)
+		return;
+
+	ThreadPool& pool = ThreadPool::getGlobal();
+	const auto& pathfinding = _save->getWorkerPathfinding(pool.getWorkerCount());
+	pool.parallelFor(searches.size(), [&](size_t index, size_t worker)
+	{
+		Search& search = searches[index];
+		Pathfinding* pf = pathfinding[worker];
+		bool ranOutOfTUs = false;
+		pf->setIgnoreFriends(search.key.ignoreFriends);
+		std::vector<PathfindingNode*> reachable = pf->findReachablePathFindingNodes(search.unit, BattleActionCost(), ranOutOfTUs, false, NULL, &search.start, false, search.key.useMaxTUs);
+		search.area = std::make_unique<ReachableArea>();
+		cache->fill(*search.area, search.key, reachable, search.timeUnits, ranOutOfTUs);
+	});
+	for (auto& search : searches)
+	{
+		cache->insert(std::move(search.area));
 	}
-	return smokeFearMap;
 }
 
 bool AIModule::hasTileSight(Position from, Position to)
 {
-	if (_save->getTileEngine()->hasEntry(from, to))
+	bool result = true;
+	if (_save->getTileEngine()->tryGetVisibilityCache(from, to, result))
 	{
-		return _save->getTileEngine()->getVisibilityCache(from, to);
+		return result;
 	}
 	Tile* tile = _save->getTile(from);
 	if (!tile)
 		return false;
-	bool result = true;
+	result = true;
 	std::vector<Position> trajectory;
 	trajectory.clear();
 	if (tile->getTerrainLevel() * -1 + _unit->getHeight() - 24 > 0)
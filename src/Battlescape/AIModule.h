@@ -22,6 +22,7 @@
 #include "Position.h"
 #include "Pathfinding.h"
 #include "../Savegame/BattleUnit.h"
+#include <memory>
 #include <vector>
 
 
@@ -33,6 +34,8 @@ class BattleUnit;
 struct BattleAction;
 class BattlescapeState;
 class Node;
+class ReachableArea;
+struct ReachabilityKey;
 
 enum AIMode { AI_PATROL, AI_AMBUSH, AI_COMBAT, AI_ESCAPE };
 /**
@@ -225,6 +228,14 @@ public:
 	float getItemPickUpScore(BattleItem *item);
 	/// Non-cheating-AI needs to be able to determine whether the enemy is doing Triton-shenanigans, where we should prevent exposing ourselves or is exposed enough themselves for us to strike
 	bool IsEnemyExposedEnough();
+	/// Gets TU cost of reaching position from the closest spawn tile, using exposure layer of influence map
+	int getExposureCost(Position pos, BattleUnit* actor);
+	/// Stores known positions of enemies that threat layer of influence map is made from
+	void updateThreatSources();
+	/// Fills threat layer of influence map for tile, if it is not there yet
+	int fillThreat(Tile *tile);
+	/// Fills cover layer of influence map for tile, if it is not there yet
+	int fillCover(Tile *tile);
 	/// Get the cover-value of a tile
 	float getCoverValue(Tile *tile, BattleUnit *bu, int coverQuality = 1);
 	/// checks whethere there's any cover in range
@@ -234,15 +245,17 @@ public:
 	/// returns how much energy the unit can recover each turn
 	int getEnergyRecovery(BattleUnit* unit);
 	/// returns reachable tile-Ids by a particular unit
-	std::map<Position, int, PositionComparator> getReachableBy(BattleUnit* unit, bool& ranOutOfTUs, bool forceRecalc = false, bool useMaxTUs = false);
+	std::shared_ptr<const ReachableArea> getReachableBy(BattleUnit* unit, bool& ranOutOfTUs, bool forceRecalc = false, bool useMaxTUs = false);
+	/// builds parameters of reachability search for unit, false when we do not know where it is
+	bool getReachabilityKey(BattleUnit* unit, bool useMaxTUs, bool ignoreFriends, ReachabilityKey& key, Position& startPosition) const;
+	/// calculates reachability of all units that brutal-AI will ask for, using worker threads
+	void prefetchReachability();
 	/// checks whether it would be possible to see one tile from another
 	bool hasTileSight(Position from, Position to);
 	/// returns the amount of blaster-waypoints to reach a target-positon
 	int requiredWayPointCount(Position to, const std::vector<PathfindingNode*> nodeVector);
 	/// returns a vector of all positions we'd have to walk towards a specific location
 	std::vector<Position> getPositionsOnPathTo(Position target, const std::vector<PathfindingNode*> nodeVector);
-	/// returns fear of smoke
-	std::map<Position, int, PositionComparator> getSmokeFearMap();
 	/// returns how urgent it is to get rid of a grenade
 	float grenadeRiddingUrgency();
 	/// returns which side of the unit is facing the given position
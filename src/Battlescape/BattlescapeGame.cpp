@@ -56,6 +56,7 @@
 #include "InfoboxOKState.h"
 #include "UnitFallBState.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/BattleUnitStatistics.h"
 #include "ConfirmEndMissionState.h"
 #include "../fmath.h"
@@ -304,6 +305,7 @@ void BattlescapeGame::init()
  */
 void BattlescapeGame::handleAI(BattleUnit *unit)
 {
+	OXCE_PROFILE_ZONE("BattlescapeGame::handleAI");
 	std::ostringstream ss;
 
 	if ((unit->getTimeUnits() <= 5 && !unit->isBrutal()) || unit->getTimeUnits() < 1 || unit->getWantToEndTurn())
@@ -358,6 +360,13 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 	BattleAction action;
 	action.actor = unit;
 	action.number = _AIActionCounter;
+	if (unit->isBrutal() && Options::oxceAISpeculativeSearch)
+	{
+		// searches of other units that thinking will need can run in parallel before it
+		ai->prefetchReachability();
+	}
+	// world does not change while AI is thinking, its path searches can share TU costs
+	_save->getPathfinding()->beginTUCostCache();
 	unit->think(&action);
 
 	if (action.type == BA_RETHINK)
@@ -365,6 +374,7 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 		_parentState->debug("Rethink");
 		unit->think(&action);
 	}
+	_save->getPathfinding()->endTUCostCache();
 	if (action.type == BA_RETHINK)
 	{
 		// You didn't come up with anything twice in a row? Just skip your turn then!
@@ -405,7 +415,9 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 		// you have just picked up a weapon... use it if you can!
 		_parentState->debug("Re-Rethink");
 		unit->getAIModule()->setWeaponPickedUp();
+		_save->getPathfinding()->beginTUCostCache();
 		unit->think(&action);
+		_save->getPathfinding()->endTUCostCache();
 	}
 
 	if (unit->getCharging() != 0)
@@ -668,6 +680,20 @@ void BattlescapeGame::endTurn()
 
 
 		_save->endTurn();
+#ifdef OXCE_PROFILER
+		if (Options::oxceProfileAlienTurn)
+		{
+			// whole alien turn, from its first to last frame, is saved as one trace
+			if (_save->getSide() == FACTION_HOSTILE)
+			{
+				Profiler::startCapture(0);
+			}
+			else if (Profiler::isCapturing())
+			{
+				Profiler::saveTrace("alien_turn");
+			}
+		}
+#endif
 		t = _save->getTileEngine()->checkForTerrainExplosions();
 		if (t)
 		{
@@ -0,0 +1,318 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "InfluenceMap.h"
+#include "ReachabilityCache.h"
+#include <algorithm>
+
+namespace OpenXcom
+{
+
+/**
+ * Creates empty map, it need be initialized before usage.
+ */
+InfluenceMap::InfluenceMap() : _mapSizeX(1), _mapSizeY(1), _mapSizeZ(1)
+{
+
+}
+
+/**
+ * Prepares all layers for a map of given size.
+ * @param mapSizeX Size of map in X.
+ * @param mapSizeY Size of map in Y.
+ * @param mapSizeZ Size of map in Z.
+ */
+void InfluenceMap::init(int mapSizeX, int mapSizeY, int mapSizeZ)
+{
+	_mapSizeX = std::max(mapSizeX, 1);
+	_mapSizeY = std::max(mapSizeY, 1);
+	_mapSizeZ = std::max(mapSizeZ, 1);
+
+	const size_t tiles = size_t(_mapSizeX) * _mapSizeY * _mapSizeZ;
+	_layers[IL_THREAT].channels = Directions;
+	_layers[IL_COVER].channels = 2 * Directions;
+	_layers[IL_EXPOSURE].channels = 2;
+	for (Layer& l : _layers)
+	{
+		l.values.assign(tiles * l.channels, 0.0f);
+		l.stamps.assign(tiles, 0);
+		l.tiles.clear();
+		l.tilesByValue.clear();
+		l.generation = 1;
+		l.sorted = true;
+	}
+	_threatSources.clear();
+	_exposureKey = ReachabilityKey();
+}
+
+/**
+ * Drops all values of layer, only bump generation stamp, memory is touched only when stamp wraps around.
+ * @param layer Layer to clear.
+ */
+void InfluenceMap::clear(InfluenceLayer layer)
+{
+	Layer& l = _layers[layer];
+	++l.generation;
+	if (l.generation == 0)
+	{
+		std::fill(l.stamps.begin(), l.stamps.end(), 0);
+		l.generation = 1;
+	}
+	l.tiles.clear();
+	l.tilesByValue.clear();
+	l.sorted = true;
+}
+
+/**
+ * Drops values of tiles in part of map, on all levels.
+ * @param layer Layer to change.
+ * @param area Part of map.
+ */
+void InfluenceMap::clear(InfluenceLayer layer, MapSubset area)
+{
+	Layer& l = _layers[layer];
+	const int begX = std::max<int>(area.beg_x, 0), endX = std::min<int>(area.end_x, _mapSizeX);
+	const int begY = std::max<int>(area.beg_y, 0), endY = std::min<int>(area.end_y, _mapSizeY);
+	bool changed = false;
+	for (int z = 0; z < _mapSizeZ; ++z)
+	{
+		for (int y = begY; y < endY; ++y)
+		{
+			for (int x = begX; x < endX; ++x)
+			{
+				Uint32& stamp = l.stamps[getTileIndex(Position(x, y, z))];
+				if (stamp == l.generation)
+				{
+					stamp = 0;
+					changed = true;
+				}
+			}
+		}
+	}
+	if (changed)
+	{
+		std::erase_if(l.tiles, [&](int tileIndex){ return l.stamps[tileIndex] != l.generation; });
+		l.sorted = false;
+	}
+}
+
+/**
+ * Drops all values of every layer.
+ */
+void InfluenceMap::clear()
+{
+	for (int i = 0; i < IL_MAX; ++i)
+	{
+		clear((InfluenceLayer)i);
+	}
+	_threatSources.clear();
+	_exposureKey = ReachabilityKey();
+}
+
+/**
+ * Adds value to tile, tile that had no value start from zero.
+ * @param layer Layer to change.
+ * @param tileIndex Index of tile.
+ * @param value Value to add.
+ */
+void InfluenceMap::add(InfluenceLayer layer, int tileIndex, float value)
+{
+	Layer& l = _layers[layer];
+	if (tileIndex < 0 || tileIndex >= (int)l.stamps.size())
+	{
+		return;
+	}
+	if (l.stamps[tileIndex] != l.generation)
+	{
+		l.stamps[tileIndex] = l.generation;
+		std::fill_n(l.values.begin() + tileIndex * l.channels, l.channels, 0.0f);
+		l.tiles.push_back(tileIndex);
+	}
+	l.values[tileIndex * l.channels] += value;
+	l.sorted = false;
+}
+
+/**
+ * Adds TUs left after reaching each tile of area to the layer.
+ * @param layer Layer to change.
+ * @param area Area reachable by some unit.
+ */
+void InfluenceMap::add(InfluenceLayer layer, const ReachableArea& area)
+{
+	for (auto& reachable : area)
+	{
+		add(layer, getTileIndex(reachable.first), (float)reachable.second);
+	}
+}
+
+/**
+ * Sets value of one channel of tile, tile that had no value get zero in other channels.
+ * @param layer Layer to change.
+ * @param tileIndex Index of tile.
+ * @param channel Channel to set.
+ * @param value New value.
+ */
+void InfluenceMap::set(InfluenceLayer layer, int tileIndex, int channel, float value)
+{
+	Layer& l = _layers[layer];
+	if (tileIndex < 0 || tileIndex >= (int)l.stamps.size())
+	{
+		return;
+	}
+	if (l.stamps[tileIndex] != l.generation)
+	{
+		l.stamps[tileIndex] = l.generation;
+		std::fill_n(l.values.begin() + tileIndex * l.channels, l.channels, 0.0f);
+		l.tiles.push_back(tileIndex);
+	}
+	l.values[tileIndex * l.channels + channel] = value;
+	l.sorted = false;
+}
+
+/**
+ * Checks if tile have value, even zero one.
+ * @param layer Layer to check.
+ * @param tileIndex Index of tile.
+ * @return True when value was set after last clear.
+ */
+bool InfluenceMap::has(InfluenceLayer layer, int tileIndex) const
+{
+	const Layer& l = _layers[layer];
+	return tileIndex >= 0 && tileIndex < (int)l.stamps.size() && l.stamps[tileIndex] == l.generation;
+}
+
+/**
+ * Gets value of channel of tile.
+ * @param layer Layer to check.
+ * @param tileIndex Index of tile.
+ * @param channel Channel to get.
+ * @return Value, or zero when tile have none.
+ */
+float InfluenceMap::get(InfluenceLayer layer, int tileIndex, int channel) const
+{
+	if (!has(layer, tileIndex))
+	{
+		return 0.0f;
+	}
+	const Layer& l = _layers[layer];
+	return l.values[tileIndex * l.channels + channel];
+}
+
+/**
+ * Gets tiles with value ordered from highest value (of first channel), ties are ordered by tile index.
+ * Used by queries looking for best tile that match some condition, they can stop on first match.
+ * Sorted list is separate copy, so order of `getTiles` is not changed.
+ * @param layer Layer to check.
+ * @return List of tile indexes, valid until layer changes.
+ */
+const std::vector<int>& InfluenceMap::getTilesByValue(InfluenceLayer layer)
+{
+	Layer& l = _layers[layer];
+	if (!l.sorted)
+	{
+		l.tilesByValue = l.tiles;
+		std::sort(l.tilesByValue.begin(), l.tilesByValue.end(), [&](int a, int b)
+		{
+			const float va = l.values[a * l.channels], vb = l.values[b * l.channels];
+			return va != vb ? va > vb : a < b;
+		});
+		l.sorted = true;
+	}
+	return l.tilesByValue;
+}
+
+/**
+ * Gets position of tile with given index.
+ * @param tileIndex Index of tile.
+ * @return Position of tile.
+ */
+Position InfluenceMap::getPosition(int tileIndex) const
+{
+	const int layer = _mapSizeX * _mapSizeY;
+	const int z = tileIndex / layer;
+	const int y = (tileIndex % layer) / _mapSizeX;
+	const int x = tileIndex % _mapSizeX;
+	return Position(x, y, z);
+}
+
+/**
+ * Sets known positions of enemies, when they differ from last ones threat layer is dropped.
+ * @param sources Positions in order of units in battle.
+ */
+void InfluenceMap::setThreatSources(const std::vector<Position>& sources)
+{
+	if (sources != _threatSources)
+	{
+		clear(IL_THREAT);
+		_threatSources = sources;
+	}
+}
+
+/**
+ * Drops exposure layer, it will be filled with result of search with given key.
+ * @param key Search that give TU costs of layer.
+ */
+void InfluenceMap::setExposure(const ReachabilityKey& key)
+{
+	clear(IL_EXPOSURE);
+	_exposureKey = key;
+}
+
+/**
+ * Drops values that could change because unit stand at or leave given position.
+ * Unit can block any path, so whole exposure is dropped. Threat is dropped when
+ * enemy was known to stand there, cover do not depend on units.
+ * @param pos Position of unit.
+ * @param size Size of unit.
+ */
+void InfluenceMap::invalidate(Position pos, int size)
+{
+	if (_exposureKey.unitId != -1)
+	{
+		setExposure(ReachabilityKey());
+	}
+	for (const Position& source : _threatSources)
+	{
+		if (source.z == pos.z && source.x >= pos.x && source.x < pos.x + size && source.y >= pos.y && source.y < pos.y + size)
+		{
+			clear(IL_THREAT);
+			_threatSources.clear();
+			break;
+		}
+	}
+}
+
+/**
+ * Drops values that could change because terrain changed in given part of map.
+ * Cover is dropped only there, paths from anywhere could go through it so whole exposure is dropped.
+ * @param changed Changed part of map, all levels.
+ */
+void InfluenceMap::invalidate(MapSubset changed)
+{
+	if (!changed)
+	{
+		return;
+	}
+	clear(IL_COVER, changed);
+	if (_exposureKey.unitId != -1)
+	{
+		setExposure(ReachabilityKey());
+	}
+}
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_types.h>
+#include "Position.h"
+#include "ReachabilityCache.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Layers of influence map.
+ */
+enum InfluenceLayer
+{
+	IL_ENEMY_REACH,
+	IL_FRIEND_REACH,
+	IL_THREAT,
+	IL_COVER,
+	IL_EXPOSURE,
+	IL_MAX
+};
+
+/**
+ * Dense per tile scores used by the AI when rating positions.
+ * Every layer is flat array indexed like tiles, with list of tiles that have value in it.
+ * Values are stamped with generation number, so clearing layer do not touch whole array.
+ *
+ * Reach layers are summed again on every think. Threat, cover and exposure are filled by AI
+ * when tile is first asked for and stay valid until something they depend on changes:
+ * threat (8 channels, one per direction) until known enemy positions change,
+ * cover (8 channels for `DT_NONE` and 8 for `DT_HE` blockage) until terrain near tile changes,
+ * exposure (TU cost and order of path node) until any unit moves or terrain changes.
+ */
+class InfluenceMap
+{
+	/**
+	 * Single layer of scores.
+	 */
+	struct Layer
+	{
+		std::vector<float> values;
+		std::vector<Uint32> stamps;
+		std::vector<int> tiles;
+		std::vector<int> tilesByValue;
+		int channels = 1;
+		Uint32 generation = 1;
+		bool sorted = true;
+	};
+
+	Layer _layers[IL_MAX];
+	int _mapSizeX, _mapSizeY, _mapSizeZ;
+	std::vector<Position> _threatSources;
+	ReachabilityKey _exposureKey;
+
+	/// Drops values of tiles in part of map.
+	void clear(InfluenceLayer layer, MapSubset area);
+
+public:
+	/// Number of channels in layers with value for every direction.
+	static constexpr int Directions = 8;
+	/// Channel of exposure with TU cost of path node.
+	static constexpr int ExposureCost = 0;
+	/// Channel of exposure with index of path node in search result.
+	static constexpr int ExposureOrder = 1;
+
+	/// Creates empty map.
+	InfluenceMap();
+
+	/// Prepares layers for map of given size.
+	void init(int mapSizeX, int mapSizeY, int mapSizeZ);
+	/// Drops all values of layer.
+	void clear(InfluenceLayer layer);
+	/// Drops all values of every layer.
+	void clear();
+	/// Adds value to tile.
+	void add(InfluenceLayer layer, int tileIndex, float value);
+	/// Adds TUs left of every tile in area.
+	void add(InfluenceLayer layer, const ReachableArea& area);
+	/// Sets value of one channel of tile, other channels of new tile are zero.
+	void set(InfluenceLayer layer, int tileIndex, int channel, float value);
+	/// Checks if tile have value.
+	bool has(InfluenceLayer layer, int tileIndex) const;
+	/// Gets value of tile, zero for tiles without value.
+	float get(InfluenceLayer layer, int tileIndex) const { return get(layer, tileIndex, 0); }
+	/// Gets value of channel of tile, zero for tiles without value.
+	float get(InfluenceLayer layer, int tileIndex, int channel) const;
+	/// Gets tiles with value, in order they got it.
+	const std::vector<int>& getTiles(InfluenceLayer layer) const { return _layers[layer].tiles; }
+	/// Gets copy of tiles with value, ordered from highest value.
+	const std::vector<int>& getTilesByValue(InfluenceLayer layer);
+	/// Gets index of tile at position.
+	int getTileIndex(Position pos) const { return pos.x + pos.y * _mapSizeX + pos.z * _mapSizeX * _mapSizeY; }
+	/// Gets position of tile index.
+	Position getPosition(int tileIndex) const;
+
+	/// Sets known positions of enemies that threat layer is made from, layer is dropped if they changed.
+	void setThreatSources(const std::vector<Position>& sources);
+	/// Gets known positions of enemies that threat layer is made from.
+	const std::vector<Position>& getThreatSources() const { return _threatSources; }
+	/// Checks if exposure layer was filled for given search.
+	bool hasExposure(const ReachabilityKey& key) const { return _exposureKey == key && key.unitId != -1; }
+	/// Drops exposure layer and marks it as filled for given search.
+	void setExposure(const ReachabilityKey& key);
+
+	/// Drops values affected by unit standing at or leaving given position.
+	void invalidate(Position pos, int size);
+	/// Drops values affected by change of terrain in given part of map.
+	void invalidate(MapSubset area);
+};
+
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "LightStamp.h"
+#include <algorithm>
+#include <cstring>
+#include "../fmath.h"
+
+#if (_MSC_VER >= 1400) && (defined(_M_X64) || _M_IX86_FP >= 2)
+#ifndef __SSE2__
+#define __SSE2__ true
+#endif
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace OpenXcom
+{
+
+/**
+ * Creates stamp, light falls by one for every tile of distance, one level is one and half tile.
+ * @param power Power of light source.
+ */
+LightStamp::LightStamp(int power) : _power(std::max(power, 0)), _radius(std::max(power - 1, 0)), _radiusZ(std::max(power - 1, 0))
+{
+	const int size = 2 * _radius + 1;
+	_values.resize(size * size * (2 * _radiusZ + 1));
+	size_t i = 0;
+	for (int z = -_radiusZ; z <= _radiusZ; ++z)
+	{
+		for (int y = -_radius; y <= _radius; ++y)
+		{
+			for (int x = -_radius; x <= _radius; ++x)
+			{
+				const int distance = (int)Round(Position::distance(Position(x, y, z).toVoxel(), Position(0, 0, 0)) / Position::TileXY);
+				_values[i++] = (Uint8)std::clamp(_power - distance, 0, 255);
+			}
+		}
+	}
+}
+
+/**
+ * Gets light that reach tile at given offset from light source.
+ * @param diff Offset from source.
+ * @return Light value.
+ */
+int LightStamp::get(Position diff) const
+{
+	if (std::abs(diff.x) > _radius || std::abs(diff.y) > _radius || std::abs(diff.z) > _radiusZ)
+	{
+		return 0;
+	}
+	return getRow(diff.y, diff.z)[diff.x + _radius];
+}
+
+/**
+ * Blends row of light into selected layer. Tile is updated only when new light is brighter than
+ * light in this and every lower layer, this match `Tile::getLightMulti` check done for single tile.
+ * @param layers Array of light layers of whole map.
+ * @param layer Layer that is updated.
+ * @param offset Index of first tile of row.
+ * @param light Row of new light values.
+ * @param size Length of row.
+ */
+void LightStamp::blendRow(Uint8* const* layers, int layer, size_t offset, const Uint8* light, int size)
+{
+	Uint8* dest = layers[layer] + offset;
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i value = _mm_loadu_si128((const __m128i*)(light + i));
+		__m128i lower = _mm_setzero_si128();
+		for (int l = 0; l < layer; ++l)
+		{
+			lower = _mm_max_epu8(lower, _mm_loadu_si128((const __m128i*)(layers[l] + offset + i)));
+		}
+		// `value > lower` for unsigned bytes is `max(value, lower) != lower`
+		const __m128i notBrighter = _mm_cmpeq_epi8(_mm_max_epu8(value, lower), lower);
+		const __m128i current = _mm_loadu_si128((const __m128i*)(dest + i));
+		_mm_storeu_si128((__m128i*)(dest + i), _mm_max_epu8(current, _mm_andnot_si128(notBrighter, value)));
+	}
+#endif
+	for (; i < size; ++i)
+	{
+		Uint8 lower = 0;
+		for (int l = 0; l < layer; ++l)
+		{
+			lower = std::max(lower, layers[l][offset + i]);
+		}
+		if (light[i] > lower && light[i] > dest[i])
+		{
+			dest[i] = light[i];
+		}
+	}
+}
+
+/**
+ * Clears row of light in given layer and all layers above it.
+ * @param layers Array of light layers of whole map.
+ * @param layer First layer to clear.
+ * @param layerCount Number of layers.
+ * @param offset Index of first tile of row.
+ * @param size Length of row.
+ */
+void LightStamp::resetRow(Uint8* const* layers, int layer, int layerCount, size_t offset, int size)
+{
+	for (int l = layer; l < layerCount; ++l)
+	{
+		std::memset(layers[l] + offset, 0, size);
+	}
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_types.h>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Precomputed light falloff around a light source of given power.
+ * Value for every offset is power reduced by distance rounded to whole tiles, same as per tile calculation in `TileEngine::addLight`.
+ * Stamp rows are stored along X, so whole row of map can be blended with one call.
+ */
+class LightStamp
+{
+	int _power;
+	int _radius;
+	int _radiusZ;
+	std::vector<Uint8> _values;
+
+public:
+	/// Creates stamp for light source of given power.
+	explicit LightStamp(int power);
+
+	/// Gets power of light source.
+	int getPower() const { return _power; }
+	/// Gets max offset in X and Y that can receive light.
+	int getRadius() const { return _radius; }
+	/// Gets max offset in Z that can receive light.
+	int getRadiusZ() const { return _radiusZ; }
+	/// Gets light for offset from source, zero outside of stamp.
+	int get(Position diff) const;
+	/// Gets row of light values for offsets from -radius to +radius in X.
+	const Uint8* getRow(int diffY, int diffZ) const
+	{
+		const int size = 2 * _radius + 1;
+		return &_values[((diffZ + _radiusZ) * size + (diffY + _radius)) * size];
+	}
+
+	/// Blends row of light into one layer, value is used only when it is brighter than this and all lower layers.
+	static void blendRow(Uint8* const* layers, int layer, size_t offset, const Uint8* light, int size);
+	/// Clears row of light in all layers starting from given one.
+	static void resetRow(Uint8* const* layers, int layer, int layerCount, size_t offset, int size);
+};
+
+}
@@ -36,6 +36,7 @@
 #include "../Engine/Screen.h"
 #include "../Engine/ShaderDraw.h"
 #include "../Engine/ShaderMove.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
@@ -108,7 +109,7 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 	_game(game), _arrow(0), _anyIndicator(false), _isAltPressed(false),
 	_selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0),
 	_projectile(0), _followProjectile(true), _projectileInFOV(false), _explosionInFOV(false), _launch(false), _visibleMapHeight(visibleMapHeight),
-	_unitDying(false), _smoothingEngaged(false), _flashScreen(false), _bgColor(15), _projectileSet(0), _showObstacles(false)
+	_unitDying(false), _smoothingEngaged(false), _flashScreen(false), _bgColor(15), _projectileSet(0), _frameKey(0), _showObstacles(false)
 {
 	_iconHeight = _game->getMod()->getInterface("battlescape")->getElement("icons")->h;
 	_iconWidth = _game->getMod()->getInterface("battlescape")->getElement("icons")->w;
@@ -291,27 +292,18 @@ void Map::think()
 
 /**
  * Draws the whole map, part by part.
+ * Last frame is kept in back buffer, when only some tiles, units or cursor changed
+ * only screen cells they cover are cleared and composited again in normal draw order.
  */
 void Map::draw()
 {
+	OXCE_PROFILE_ZONE("Map::draw");
 	if (!_redraw)
 	{
 		return;
 	}
 
-	// normally we'd call for a Surface::draw();
-	// but we don't want to clear the background with colour 0, which is transparent (aka black)
-	// we use colour 15 because that actually corresponds to the colour we DO want in all variations of the xcom and tftd palettes.
-	// Note: un-hardcoded the color from 15 to ruleset value, default 15
 	_redraw = false;
-	ShaderDrawFunc(
-		[](Uint8& dest, Uint8 color)
-		{
-			dest = color;
-		},
-		ShaderSurface(this),
-		ShaderScalar<Uint8>(Palette::blockOffset(0) + _bgColor)
-	);
 
 	Tile *t;
 
@@ -338,13 +330,68 @@ void Map::draw()
 		}
 	}
 
+	// normally we'd call for a Surface::draw();
+	// but we don't want to clear the background with colour 0, which is transparent (aka black)
+	// we use colour 15 because that actually corresponds to the colour we DO want in all variations of the xcom and tftd palettes.
+	// Note: un-hardcoded the color from 15 to ruleset value, default 15
+	auto fillBackground = [&](const GraphSubset& area)
+	{
+		ShaderMove<Uint8> dest(this);
+		dest.setDomain(area);
+		ShaderDrawFunc(
+			[](Uint8& dest, Uint8 color)
+			{
+				dest = color;
+			},
+			dest,
+			ShaderScalar<Uint8>(Palette::blockOffset(0) + _bgColor)
+		);
+	};
+
 	if ((_save->getSelectedUnit() && _save->getSelectedUnit()->getVisible()) || _unitDying || _save->getSide() == FACTION_PLAYER || _save->getDebugMode() || _projectileInFOV || _explosionInFOV)
 	{
-		drawTerrain(this);
+		updateDirtyRegions();
+		if (_dirty.isClean())
+		{
+			return;
+		}
+
+		SurfaceRaw<Uint8> backBuffer(_backBuffer, getWidth(), getHeight());
+		auto copyArea = [](SurfaceRaw<Uint8> to, SurfaceRaw<Uint8> from, const GraphSubset& area)
+		{
+			ShaderMove<Uint8> dest(to);
+			dest.setDomain(area);
+			ShaderDrawFunc(
+				[](Uint8& dest, const Uint8& src)
+				{
+					dest = src;
+				},
+				dest,
+				ShaderMove<Uint8>(from)
+			);
+		};
+
+		if (_dirty.isAllDirty())
+		{
+			fillBackground(GraphSubset{ getWidth(), getHeight() });
+			drawTerrain(this);
+			copyArea(backBuffer, this, GraphSubset{ getWidth(), getHeight() });
+		}
+		else
+		{
+			// tiles that touch dirty cells draw outside of them too, pixels there are restored from last frame
+			_dirty.forEachRun(true, fillBackground);
+			drawTerrain(this);
+			_dirty.forEachRun(false, [&](const GraphSubset& area){ copyArea(this, backBuffer, area); });
+			_dirty.forEachRun(true, [&](const GraphSubset& area){ copyArea(backBuffer, this, area); });
+		}
+		_dirty.clear();
 	}
 	else
 	{
+		fillBackground(GraphSubset{ getWidth(), getHeight() });
 		_message->blit(this->getSurface());
+		_dirty.invalidateAll();
 	}
 }
 
@@ -370,6 +417,7 @@ void Map::refreshAIProgress(int progress)
 void Map::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
+	_dirty.invalidateAll();
 	for (MapDataSet* mds : _save->getMapDataSets())
 	{
 		mds->getSurfaceset()->setPalette(colors, firstcolor, ncolors);
@@ -732,7 +780,6 @@ void Map::drawTerrain(Surface *surface)
 	int beginZ = 0, endZ = _save->getMapSizeZ() - 1;
 	Position mapPosition, screenPosition, bulletPositionScreen, movingUnitPosition;
 	int bulletLowX=16000, bulletLowY=16000, bulletLowZ=16000, bulletHighX=0, bulletHighY=0, bulletHighZ=0;
-	int dummy;
 	BattleUnit *movingUnit = _save->getTileEngine()->getMovingUnit();
 	int tileShade, tileColor, obstacleShade;
 	UnitSprite unitSprite(surface, _game->getMod(), _save, _animFrame, _save->getDepth() != 0);
@@ -844,22 +891,9 @@ void Map::drawTerrain(Surface *surface)
 		}
 	}
 
-	// get corner map coordinates to give rough boundaries in which tiles to redraw are
-	_camera->convertScreenToMap(0, 0, &beginX, &dummy);
-	_camera->convertScreenToMap(surface->getWidth(), 0, &dummy, &beginY);
-	_camera->convertScreenToMap(surface->getWidth() + _spriteWidth, surface->getHeight() + _spriteHeight, &endX, &dummy);
-	_camera->convertScreenToMap(0, surface->getHeight() + _spriteHeight, &dummy, &endY);
-	beginY -= (_camera->getViewLevel() * 2);
-	beginX -= (_camera->getViewLevel() * 2);
-	if (beginX < 0)
-		beginX = 0;
-	if (beginY < 0)
-		beginY = 0;
-
-	if (!_camera->getShowAllLayers())
-	{
-		endZ = std::min(endZ, _camera->getViewLevel());
-	}
+	getDrawRange(beginX, endX, beginY, endY, endZ);
+	// when only part of screen is dirty, tiles that can't touch it are skipped
+	const bool partial = !_dirty.isAllDirty();
 
 
 	bool pathfinderTurnedOn = _save->getPathfinding()->isPathPreviewed();
@@ -897,7 +931,8 @@ void Map::drawTerrain(Surface *surface)
 
 				// only render cells that are inside the surface
 				if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
-					screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
+					screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight &&
+					(!partial || _dirty.intersects(getTileScreenArea(screenPosition))))
 				{
 					auto isUnitMovingNearby = movingUnit && positionInRangeXY(movingUnitPosition, mapPosition, 2);
 
@@ -1896,7 +1931,8 @@ void Map::drawTerrain(Surface *surface)
 
 					// only render cells that are inside the surface
 					if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
-						screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
+						screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight &&
+						(!partial || _dirty.intersects(getTileScreenArea(screenPosition))))
 					{
 						tile = _save->getTile(mapPosition);
 						if (!tile || !tile->isDiscovered(O_FLOOR) || tile->getPreview() == -1)
@@ -2125,6 +2161,305 @@ void Map::drawTerrain(Surface *surface)
 	surface->unlock();
 }
 
+namespace
+{
+
+/// Adds value to FNV-1a style hash.
+template<typename T>
+inline void hashMix(T& hash, Uint64 value)
+{
+	hash = (T)((hash ^ value) * (sizeof(T) == 8 ? 1099511628211ull : 16777619u));
+}
+
+/// Adds pointer to hash.
+template<typename T>
+inline void hashMix(T& hash, const void* ptr)
+{
+	const Uint64 value = (Uint64)(uintptr_t)ptr;
+	hashMix(hash, value ^ (value >> 32));
+}
+
+/// Union of two areas, empty areas are ignored.
+GraphSubset unionArea(const GraphSubset& a, const GraphSubset& b)
+{
+	if (!a)
+	{
+		return b;
+	}
+	if (!b)
+	{
+		return a;
+	}
+	return GraphSubset(
+		std::make_pair(std::min(a.beg_x, b.beg_x), std::max(a.end_x, b.end_x)),
+		std::make_pair(std::min(a.beg_y, b.beg_y), std::max(a.end_y, b.end_y))
+	);
+}
+
+}
+
+/**
+ * Gets range of tiles that could be visible on screen.
+ * @param beginX First column.
+ * @param endX End of columns.
+ * @param beginY First row.
+ * @param endY End of rows.
+ * @param endZ Last level.
+ */
+void Map::getDrawRange(int &beginX, int &endX, int &beginY, int &endY, int &endZ) const
+{
+	int dummy;
+	// get corner map coordinates to give rough boundaries in which tiles to redraw are
+	_camera->convertScreenToMap(0, 0, &beginX, &dummy);
+	_camera->convertScreenToMap(getWidth(), 0, &dummy, &beginY);
+	_camera->convertScreenToMap(getWidth() + _spriteWidth, getHeight() + _spriteHeight, &endX, &dummy);
+	_camera->convertScreenToMap(0, getHeight() + _spriteHeight, &dummy, &endY);
+	beginY -= (_camera->getViewLevel() * 2);
+	beginX -= (_camera->getViewLevel() * 2);
+	if (beginX < 0)
+		beginX = 0;
+	if (beginY < 0)
+		beginY = 0;
+
+	endZ = _save->getMapSizeZ() - 1;
+	if (!_camera->getShowAllLayers())
+	{
+		endZ = std::min(endZ, _camera->getViewLevel());
+	}
+}
+
+/**
+ * Gets screen area that can be changed by drawing of tile.
+ * It cover tile sprites, units walking from or to neighbour tiles, units from tile below, cursor and markers.
+ * @param screenPosition Position of tile on screen.
+ * @return Area on screen.
+ */
+GraphSubset Map::getTileScreenArea(Position screenPosition) const
+{
+	return GraphSubset(3 * _spriteWidth, 4 * _spriteHeight).offset(screenPosition.x - _spriteWidth, screenPosition.y - 2 * _spriteHeight);
+}
+
+/**
+ * Gets screen area that can be changed by drawing of any tile in box.
+ * @param begin Lowest corner of box.
+ * @param end Highest corner of box.
+ * @return Area on screen.
+ */
+GraphSubset Map::getMapScreenArea(Position begin, Position end) const
+{
+	GraphSubset area;
+	for (int z : { begin.z, end.z })
+	{
+		for (int y : { begin.y, end.y })
+		{
+			for (int x : { begin.x, end.x })
+			{
+				Position screenPosition;
+				_camera->convertMapToScreen(Position(x, y, z), &screenPosition);
+				area = unionArea(area, getTileScreenArea(screenPosition + _camera->getMapOffset()));
+			}
+		}
+	}
+	return area;
+}
+
+/**
+ * Gets hash of everything that drawTerrain read from tile, its unit, items and particles.
+ * Animation frame is only mixed in for tiles that have something animated by it.
+ * @param tile Tile to check.
+ * @return Hash of tile state, change mean tile look different.
+ */
+Uint32 Map::getTileSignature(Tile *tile)
+{
+	Uint32 hash = 2166136261u;
+	bool animated = false;
+
+	hashMix(hash, tile->getShade());
+	for (int part = O_FLOOR; part < O_MAX; ++part)
+	{
+		hashMix(hash, tile->getSprite((TilePart)part).getBuffer());
+		hashMix(hash, tile->isDiscovered((TilePart)part) | (tile->getObstacle(part) << 1));
+	}
+	for (TilePart part : { O_WESTWALL, O_NORTHWALL })
+	{
+		if (tile->isDoor(part) || tile->isUfoDoor(part))
+		{
+			const Tile *tileBehind = _save->getTile(tile->getPosition() - (part == O_NORTHWALL ? Position(1, 0, 0) : Position(0, 1, 0)));
+			hashMix(hash, tileBehind ? tileBehind->getShade() : 16);
+		}
+	}
+	hashMix(hash, tile->getSmoke() | (tile->getFire() << 8));
+	hashMix(hash, tile->getMarkerColor() | (tile->getPreview() << 8));
+	hashMix(hash, tile->getTUMarker() | (tile->getEnergyMarker() << 16));
+	if (tile->getSmoke() || (_showObstacles && tile->isObstacle()))
+	{
+		animated = true;
+	}
+
+	if (BattleItem *item = tile->getTopItem())
+	{
+		hashMix(hash, item);
+		if (const BattleUnit *itemUnit = item->getUnit())
+		{
+			hashMix(hash, itemUnit->getStatus() | (itemUnit->getFire() << 8) | (itemUnit->getFatalWounds() << 16));
+		}
+		animated = true;
+	}
+
+	if (const BattleUnit *unit = tile->getUnit())
+	{
+		hashMix(hash, unit);
+		hashMix(hash, unit->getVisible() | (unit->isKneeled() << 1) | (unit->getStatus() << 2) | (unit->getDirection() << 8) | (unit->getFaceDirection() << 16));
+		hashMix(hash, unit->getWalkingPhase() | (unit->getVerticalDirection() << 8) | (unit->getFloatHeight() << 16));
+		hashMix(hash, unit->getFire());
+		animated = true;
+	}
+
+	const auto& vapor = _vaporParticles[_camera->getMapSizeX() * tile->getPosition().y + tile->getPosition().x];
+	if (!vapor.empty())
+	{
+		hashMix(hash, vapor.size());
+		animated = true;
+	}
+
+	if (animated)
+	{
+		hashMix(hash, _animFrame);
+	}
+	return hash;
+}
+
+/**
+ * Gets hash of state that change look of whole map, like camera, night vision or selected unit.
+ * @return Hash of state, change mean whole map need to be drawn again.
+ */
+Uint64 Map::getFrameKey()
+{
+	Uint64 hash = 14695981039346656037ull;
+	const Position cameraPos = _camera->getMapOffset();
+	hashMix(hash, getWidth() | (getHeight() << 16));
+	hashMix(hash, (Uint16)cameraPos.x | ((Uint16)cameraPos.y << 16) | ((Uint64)(Uint16)cameraPos.z << 32) | ((Uint64)_camera->getShowAllLayers() << 48));
+	hashMix(hash, _nvColor | (_fadeShade << 8) | (_debugVisionMode << 16) | ((Uint64)_bgColor << 32));
+	hashMix(hash, _showObstacles | (_save->getDebugMode() << 1) | (_game->isAltPressed(true) << 2) | (_save->getPathfinding()->isPathPreviewed() << 3) | (_unitDying << 4));
+	hashMix(hash, _save->getSide() | (_cursorType << 8) | ((Uint64)Options::oxceFOW << 16));
+	hashMix(hash, _save->getTurn());
+	hashMix(hash, _save->getSelectedUnit());
+	hashMix(hash, _projectile);
+	hashMix(hash, _explosions.size());
+
+	if (!_waypoints.empty())
+	{
+		hashMix(hash, _save->getBattleGame()->getCurrentAction()->type);
+		for (const auto& waypoint : _waypoints)
+		{
+			hashMix(hash, (Uint16)waypoint.x | ((Uint16)waypoint.y << 16) | ((Uint64)(Uint16)waypoint.z << 32));
+		}
+	}
+
+	// local night vision depends on positions of all soldiers
+	if (_nvColor != 0)
+	{
+		for (const BattleUnit* bu : _save->getUnits())
+		{
+			if (bu->getFaction() == FACTION_PLAYER && !bu->isOut())
+			{
+				const Position pos = bu->getPosition();
+				hashMix(hash, (Uint16)pos.x | ((Uint16)pos.y << 16) | ((Uint64)(Uint16)pos.z << 32));
+			}
+		}
+	}
+	return hash;
+}
+
+/**
+ * Finds parts of screen that look different than in last frame.
+ * Whole map is invalidated when global state changes or something that is hard to track is visible
+ * (projectiles, explosions, dying units, motion scanner). Otherwise every visible tile is compared
+ * with its signature from last frame, so changes of smoke, fire, light or doors are found without
+ * any notification from code that made them. Cursor and moving unit are always drawn again.
+ */
+void Map::updateDirtyRegions()
+{
+	if (_dirty.getWidth() != getWidth() || _dirty.getHeight() != getHeight())
+	{
+		_dirty.resize(getWidth(), getHeight());
+		_backBuffer.assign(getWidth() * getHeight(), 0);
+	}
+
+	const Uint64 frameKey = getFrameKey();
+	if (frameKey != _frameKey || !Options::oxceMapDirtyRects || Options::oxceFOW || _projectile || !_explosions.empty() || _unitDying || _game->isAltPressed(true))
+	{
+		_frameKey = frameKey;
+		_dirty.invalidateAll();
+	}
+
+	if ((int)_tileSignatures.size() != _save->getMapSizeXYZ())
+	{
+		_tileSignatures.assign(_save->getMapSizeXYZ(), 0);
+		_dirty.invalidateAll();
+	}
+
+	// signatures are updated even when everything is redrawn, next frame compare with them
+	int beginX, endX, beginY, endY, endZ;
+	getDrawRange(beginX, endX, beginY, endY, endZ);
+	const Position cameraPos = _camera->getMapOffset();
+	for (int itZ = 0; itZ <= endZ; itZ++)
+	{
+		for (int itY = beginY; itY < endY; itY++)
+		{
+			for (int itX = beginX; itX < endX; itX++)
+			{
+				Tile *tile = _save->getTile(Position(itX, itY, itZ));
+				if (!tile)
+				{
+					continue;
+				}
+				Position screenPosition;
+				_camera->convertMapToScreen(tile->getPosition(), &screenPosition);
+				screenPosition += cameraPos;
+				if (screenPosition.x > -_spriteWidth && screenPosition.x < getWidth() + _spriteWidth &&
+					screenPosition.y > -_spriteHeight && screenPosition.y < getHeight() + _spriteHeight)
+				{
+					const Uint32 signature = getTileSignature(tile);
+					Uint32 &last = _tileSignatures[tile->getIndex()];
+					if (last != signature)
+					{
+						last = signature;
+						_dirty.invalidate(getTileScreenArea(screenPosition));
+					}
+				}
+			}
+		}
+	}
+
+	// moving unit is drawn by all neighbour tiles with offset that change every step
+	if (BattleUnit *movingUnit = _save->getTileEngine()->getMovingUnit())
+	{
+		const Position pos = movingUnit->getPosition();
+		const int size = movingUnit->getArmor()->getSize();
+		_dirty.invalidate(getMapScreenArea(pos - Position(2, 2, 1), pos + Position(size + 1, size + 1, 1)));
+	}
+
+	// cursor is small and animated, simpler to always draw it again in old and new position
+	GraphSubset cursorArea;
+	if (_cursorType != CT_NONE && !_save->getBattleState()->getMouseOverIcons())
+	{
+		cursorArea = getMapScreenArea(
+			Position(_selectorX - _cursorSize + 1, _selectorY - _cursorSize + 1, 0),
+			Position(_selectorX, _selectorY, _camera->getViewLevel())
+		);
+	}
+	_dirty.invalidate(_cursorArea);
+	_dirty.invalidate(cursorArea);
+	_cursorArea = cursorArea;
+
+	// when most of screen changed, drawing all tiles is cheaper than tests and copies
+	if (_dirty.getDirtyRatio() > 0.6f)
+	{
+		_dirty.invalidateAll();
+	}
+}
+
 /**
  * Handles mouse presses on the map.
  * @param action Pointer to an action.
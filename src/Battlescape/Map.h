@@ -19,6 +19,7 @@
  */
 #include "../Engine/InteractiveSurface.h"
 #include "../Engine/Collections.h"
+#include "../Engine/DirtyGrid.h"
 #include "../Mod/MapData.h"
 #include "Position.h"
 #include "Particle.h"
@@ -106,11 +107,28 @@ private:
 	bool _previewSettingArrows, _previewSettingTu, _previewSettingEnergy;
 	Text *_txtAccuracy;
 	SurfaceSet *_projectileSet;
+	DirtyGrid _dirty;
+	std::vector<Uint8> _backBuffer;
+	std::vector<Uint32> _tileSignatures;
+	Uint64 _frameKey;
+	GraphSubset _cursorArea;
 
 	void drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Position tileScreenPosition, bool topLayer, BattleUnit* movingUnit = nullptr);
 	void drawTerrain(Surface *surface);
 	int getTerrainLevel(const Position& pos, int size) const;
 	int getWallShade(TilePart part, Tile* tileFrot);
+	/// Gets range of tiles that can be seen on screen.
+	void getDrawRange(int &beginX, int &endX, int &beginY, int &endY, int &endZ) const;
+	/// Gets screen area that drawing of tile can change.
+	GraphSubset getTileScreenArea(Position screenPosition) const;
+	/// Gets screen area that drawing of box of tiles can change.
+	GraphSubset getMapScreenArea(Position begin, Position end) const;
+	/// Gets hash of everything that change how tile looks.
+	Uint32 getTileSignature(Tile *tile);
+	/// Gets hash of state that affect whole map.
+	Uint64 getFrameKey();
+	/// Finds parts of screen that changed since last frame.
+	void updateDirtyRegions();
 	int _iconHeight, _iconWidth, _messageColor;
 	int _hostileBarColor, _neutralBarColor, _borderBarColor;
 	const std::vector<Uint8> *_transparencies;
@@ -26,6 +26,7 @@
 #include "../Mod/Mod.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../fmath.h"
 #include "BattlescapeGame.h"
 
@@ -74,9 +75,104 @@ Pathfinding::~Pathfinding()
  */
 PathfindingNode *Pathfinding::getNode(Position pos, bool alt)
 {
-	if (alt)
-		return &_altNodes[_save->getTileIndex(pos)];
-	return &_nodes[_save->getTileIndex(pos)];
+	PathfindingNode *node = alt ? &_altNodes[_save->getTileIndex(pos)] : &_nodes[_save->getTileIndex(pos)];
+	if (node->getGeneration() != _nodeGeneration)
+	{
+		node->reset(_nodeGeneration);
+	}
+	return node;
+}
+
+/**
+ * Starts new search. Nodes are not touched here, each node is reset when `getNode` first see it in new search.
+ */
+void Pathfinding::resetNodes()
+{
+	if (++_nodeGeneration == 0)
+	{
+		for (auto& pn : _nodes)
+		{
+			pn.reset(0);
+		}
+		for (auto& pn : _altNodes)
+		{
+			pn.reset(0);
+		}
+		_nodeGeneration = 1;
+	}
+	_openSet.clear();
+}
+
+/**
+ * Gets the TU cost to move from 1 tile to the other, when cache is enabled result is reused
+ * for the same tile and direction until world or context of query change.
+ * @param startPosition The position to start from.
+ * @param direction The direction we are facing.
+ * @param unit The unit moving.
+ * @param missileTarget The target unit used for BAM_MISSILE.
+ * @param bam What move type is required.
+ * @return Same as `getTUCost`.
+ */
+PathfindingStep Pathfinding::getCachedTUCost(Position startPosition, int direction, const BattleUnit *unit, const BattleUnit *missileTarget, BattleActionMove bam)
+{
+	if (_tuCostCacheScope <= 0 || !_save->getTile(startPosition))
+	{
+		return getTUCost(startPosition, direction, unit, missileTarget, bam);
+	}
+
+	const CacheContext context = { unit, missileTarget, bam, unit->getDirection(), _strafeMove, _ignoreFriends };
+	if (!(context == _tuCostCacheContext))
+	{
+		invalidateTUCostCache();
+		_tuCostCacheContext = context;
+	}
+	if (_tuCostCache.empty())
+	{
+		_tuCostCache.resize((size_t)_size * dir_max);
+	}
+
+	auto& cached = _tuCostCache[(size_t)_save->getTileIndex(startPosition) * dir_max + direction];
+	if (cached.generation != _tuCostCacheGeneration)
+	{
+		cached.step = getTUCost(startPosition, direction, unit, missileTarget, bam);
+		cached.generation = _tuCostCacheGeneration;
+	}
+	return cached.step;
+}
+
+/**
+ * Enables cache of TU costs. Calls can be nested, first one drops old content of cache.
+ * Between begin and end nothing that change TU costs (terrain, units positions) should change.
+ */
+void Pathfinding::beginTUCostCache()
+{
+	if (_tuCostCacheScope++ == 0)
+	{
+		invalidateTUCostCache();
+	}
+}
+
+/**
+ * Disables cache of TU costs when last scope ends.
+ */
+void Pathfinding::endTUCostCache()
+{
+	--_tuCostCacheScope;
+}
+
+/**
+ * Drops all cached TU costs, only bump generation stamp.
+ */
+void Pathfinding::invalidateTUCostCache()
+{
+	if (++_tuCostCacheGeneration == 0)
+	{
+		for (auto& c : _tuCostCache)
+		{
+			c.generation = 0;
+		}
+		_tuCostCacheGeneration = 1;
+	}
 }
 
 /**
@@ -101,6 +197,7 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleAction
  */
 void Pathfinding::calculate(BattleUnit *unit, Position startPosition, Position endPosition, BattleActionMove bam, const BattleUnit *missileTarget, int maxTUCost)
 {
+	OXCE_PROFILE_ZONE("Pathfinding::calculate");
 	_totalTUCost = {};
 	_path.clear();
 
@@ -203,16 +300,13 @@ void Pathfinding::calculate(BattleUnit *unit, Position startPosition, Position e
  */
 bool Pathfinding::aStarPath(Position startPosition, Position endPosition, BattleActionMove bam, const BattleUnit *missileTarget, bool sneak, int maxTUCost)
 {
-	// reset every node, so we have to check them all
-	for (auto& pn : _nodes)
-	{
-		pn.reset();
-	}
+	// start new search, nodes from previous one are reset when touched
+	resetNodes();
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
 	start->connect({}, 0, 0, endPosition);
-	PathfindingOpenSet openList;
+	PathfindingOpenSet &openList = _openSet;
 	openList.push(start);
 	bool missile = (bam == BAM_MISSILE);
 	// if the open list is empty, we've reached the end
@@ -236,7 +330,7 @@ bool Pathfinding::aStarPath(Position startPosition, Position endPosition, Battle
 		// Try all reachable neighbours.
 		for (int direction = 0; direction < 10; direction++)
 		{
-			auto r = getTUCost(currentPos, direction, _unit, missileTarget, bam);
+			auto r = getCachedTUCost(currentPos, direction, _unit, missileTarget, bam);
 			if (r.cost.time == INVALID_MOVE_COST) // Skip unreachable / blocked
 				continue;
 
@@ -1500,23 +1594,10 @@ std::vector<PathfindingNode*> Pathfinding::findReachablePathFindingNodes(BattleU
 
 	PathfindingCost costMax = {tuMax, energyMax};
 
-	if (alternateStart)
-	{
-		for (auto& pn : _altNodes)
-		{
-			pn.reset();
-		}
-	}
-	else
-	{
-		for (auto& pn : _nodes)
-		{
-			pn.reset();
-		}
-	}
+	resetNodes();
 	PathfindingNode *startNode = getNode(start, alternateStart);
 	startNode->connect({}, 0, 0);
-	PathfindingOpenSet unvisited;
+	PathfindingOpenSet &unvisited = _openSet;
 	unvisited.push(startNode);
 	std::vector<PathfindingNode *> reachable;
 	int maxTilesToReturn = _size;
@@ -1544,7 +1625,7 @@ std::vector<PathfindingNode*> Pathfinding::findReachablePathFindingNodes(BattleU
 		// Try all reachable neighbours.
 		for (int direction = 0; direction < 10; direction++)
 		{
-			auto r = getTUCost(currentPos, direction, unit, missileTarget, bam);
+			auto r = getCachedTUCost(currentPos, direction, unit, missileTarget, bam);
 			if (r.cost.time == INVALID_MOVE_COST) // Skip unreachable / blocked
 				continue;
 			auto totalTuCost = currentNode->getTUCost(false) + r.cost + r.penalty;
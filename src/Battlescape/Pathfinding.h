@@ -20,6 +20,7 @@
 #include <vector>
 #include "Position.h"
 #include "PathfindingNode.h"
+#include "PathfindingOpenSet.h"
 #include "../Mod/MapData.h"
 
 namespace OpenXcom
@@ -51,8 +52,38 @@ private:
 	constexpr static int dir_y[dir_max] = { -1, -1,  0, +1, +1, +1,  0, -1,  0,  0};
 	constexpr static int dir_z[dir_max] = {  0,  0,  0,  0,  0,  0,  0,  0, +1, -1};
 
+	/**
+	 * Result of `getTUCost` stored in cache.
+	 */
+	struct CachedStep
+	{
+		PathfindingStep step;
+		Uint32 generation = 0;
+	};
+
+	/**
+	 * Everything beside map that change result of `getTUCost`, cache is dropped when it change.
+	 */
+	struct CacheContext
+	{
+		const BattleUnit *unit = nullptr;
+		const BattleUnit *missileTarget = nullptr;
+		BattleActionMove bam = BAM_NORMAL;
+		int unitDirection = -1;
+		bool strafeMove = false;
+		bool ignoreFriends = false;
+
+		bool operator==(const CacheContext&) const = default;
+	};
+
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes, _altNodes;
+	Uint32 _nodeGeneration = 0;
+	PathfindingOpenSet _openSet;
+	std::vector<CachedStep> _tuCostCache;
+	Uint32 _tuCostCacheGeneration = 0;
+	int _tuCostCacheScope = 0;
+	CacheContext _tuCostCacheContext;
 	int _size;
 	BattleUnit *_unit;
 	bool _pathPreviewed;
@@ -64,6 +95,10 @@ private:
 
 	/// Gets the node at certain position.
 	PathfindingNode *getNode(Position pos, bool alt = false);
+	/// Starts new search, all nodes become reset.
+	void resetNodes();
+	/// Gets the TU cost, using cache when it is enabled.
+	PathfindingStep getCachedTUCost(Position startPosition, int direction, const BattleUnit *unit, const BattleUnit *missileTarget, BattleActionMove bam);
 
 	/// Gets movement type of unit or movement of missile.
 	MovementType getMovementType(const BattleUnit *unit, const BattleUnit *missileTarget, BattleActionMove bam) const;
@@ -82,6 +117,7 @@ private:
 	std::vector<int> _path;
 public:
 	void setIgnoreFriends(bool ignore) { _ignoreFriends = ignore; }
+	bool getIgnoreFriends() const { return _ignoreFriends; }
 	/// Determines whether the unit is going up a stairs.
 	bool isOnStairs(Position startPosition, Position endPosition) const;
 	/// Determines whether or not movement between start tile and end tile is possible in the direction.
@@ -261,6 +297,12 @@ public:
 	int dequeuePath();
 	/// Gets the TU cost to move from 1 tile to the other.
 	PathfindingStep getTUCost(Position startPosition, int direction, const BattleUnit *unit, const BattleUnit *missileTarget, BattleActionMove bam) const;
+	/// Enables cache of TU costs, world must not change until matching `endTUCostCache`.
+	void beginTUCostCache();
+	/// Disables cache of TU costs.
+	void endTUCostCache();
+	/// Drops all cached TU costs, used when terrain changes.
+	void invalidateTUCostCache();
 	/// Aborts the current path.
 	void abortPath();
 	/// Gets the strafe move setting.
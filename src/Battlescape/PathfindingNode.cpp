@@ -25,7 +25,7 @@ namespace OpenXcom
  * Sets up a PathfindingNode.
  * @param pos Position.
  */
-PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _prevNode(0), _prevDir(0), _tuGuess(0), _checked(0), _openentry(0)
+PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _prevNode(0), _prevDir(0), _tuGuess(0), _checked(0), _generation(0), _openIndex(-1), _openCost(0)
 {
 
 }
@@ -48,12 +48,14 @@ Position PathfindingNode::getPosition() const
 }
 
 /**
- * Resets the node.
+ * Resets the node, called lazily when node is first touched by new search.
+ * @param generation Number of the search that now owns this node.
  */
-void PathfindingNode::reset()
+void PathfindingNode::reset(Uint32 generation)
 {
 	_checked = false;
-	_openentry = 0;
+	_generation = generation;
+	_openIndex = -1;
 }
 
 /**
@@ -24,7 +24,7 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Cleans up the set.
  */
 PathfindingOpenSet::~PathfindingOpenSet()
 {
@@ -32,50 +32,123 @@ PathfindingOpenSet::~PathfindingOpenSet()
 }
 
 /**
- * Keeps removing all discarded entries that have come to the top of the queue.
+ * Removes all nodes from the set, allocated memory is reused by next search.
  */
-void PathfindingOpenSet::removeDiscarded()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty() && _queue.top()._node->_openentry != _queue.top()._openentry)
+	for (PathfindingNode *node : _heap)
 	{
-		_queue.pop();
+		node->_openIndex = -1;
 	}
+	_heap.clear();
 }
 
 /**
- * Gets the node with the least cost.
- * After this call, the node is no longer in the set. It is an error to call this when the set is empty.
- * @return A pointer to the node which had the least cost.
+ * Puts node at given position in heap and updates its index.
+ * @param index Position in heap.
+ * @param node Node to store.
+ */
+void PathfindingOpenSet::place(size_t index, PathfindingNode *node)
+{
+	_heap[index] = node;
+	node->_openIndex = (int)index;
+}
+
+/**
+ * Moves node up until its parent is not more expensive.
+ * @param index Current position of node.
+ */
+void PathfindingOpenSet::siftUp(size_t index)
+{
+	PathfindingNode *node = _heap[index];
+	while (index > 0)
+	{
+		const size_t parent = (index - 1) / 2;
+		if (_heap[parent]->_openCost <= node->_openCost)
+		{
+			break;
+		}
+		place(index, _heap[parent]);
+		index = parent;
+	}
+	place(index, node);
+}
+
+/**
+ * Moves node down until both children are not cheaper.
+ * @param index Current position of node.
+ */
+void PathfindingOpenSet::siftDown(size_t index)
+{
+	PathfindingNode *node = _heap[index];
+	const size_t size = _heap.size();
+	while (true)
+	{
+		size_t child = index * 2 + 1;
+		if (child >= size)
+		{
+			break;
+		}
+		if (child + 1 < size && _heap[child + 1]->_openCost < _heap[child]->_openCost)
+		{
+			++child;
+		}
+		if (node->_openCost <= _heap[child]->_openCost)
+		{
+			break;
+		}
+		place(index, _heap[child]);
+		index = child;
+	}
+	place(index, node);
+}
+
+/**
+ * Gets the node with the cheapest cost and removes it from the set.
+ * @return The node to check.
  */
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
 
-	PathfindingNode *nd = _queue.top()._node;
-	_queue.pop();
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
+	PathfindingNode *nd = _heap.front();
+	PathfindingNode *last = _heap.back();
+	_heap.pop_back();
+	nd->_openIndex = -1;
+	if (!_heap.empty())
+	{
+		place(0, last);
+		siftDown(0);
+	}
 	return nd;
 }
 
 /**
- * Places the node in the set.
- * If the node was already in the set, the previous entry is discarded.
- * It is the caller's responsibility to never re-add a node with a worse cost.
+ * Places the node in the set. If the node was already in the set, its position is updated to the new cost.
  * @param node A pointer to the node to add.
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	assert(node->_openentry != 255u);
-
-	OpenSetEntry entry = {};
-	entry._node = node;
-	entry._cost = node->getTUCost(false).time * 4 + node->getTUGuess(); //HACK: this is not real cost, more rough approximation for algorithm, as bonus `getTUGuess` work more like gravity/potential than normal cost.
-	entry._openentry = ++node->_openentry; // next unique number, used to check if old recode is still valid.
-	_queue.push(entry);
+	const int cost = node->getTUCost(false).time * 4 + node->getTUGuess(); //HACK: this is not real cost, more rough approximation for algorithm, as bonus `getTUGuess` work more like gravity/potential than normal cost.
+	if (node->inOpenSet())
+	{
+		const int oldCost = node->_openCost;
+		node->_openCost = cost;
+		if (cost < oldCost)
+		{
+			siftUp(node->_openIndex);
+		}
+		else
+		{
+			siftDown(node->_openIndex);
+		}
+	}
+	else
+	{
+		node->_openCost = cost;
+		_heap.push_back(node);
+		siftUp(_heap.size() - 1);
+	}
 }
 
-
 }
@@ -17,59 +17,42 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <queue>
-#include <SDL_stdinc.h>
+#include <cstddef>
+#include <vector>
 
 namespace OpenXcom
 {
 
 class PathfindingNode;
 
-struct OpenSetEntry
-{
-	PathfindingNode *_node;
-	Sint16 _cost;
-	Uint8 _openentry;
-};
-
-/**
- * Helper class to compare entries through pointers.
- */
-class EntryCompare
-{
-public:
-	/**
-	 * Compares entries @a *a and @a *b.
-	 * @param a Pointer to first entry.
-	 * @param b Pointer to second entry.
-	 * @return True if entry @a *b must come before @a *a.
-	 */
-	bool operator()(const OpenSetEntry& a, const OpenSetEntry& b) const
-	{
-		return b._cost < a._cost;
-	}
-};
-
 /**
- * A class that holds references to the nodes to be examined in pathfinding.
+ * Open set of A* and Dijkstra searches.
+ * Binary heap indexed by nodes themselves, so node already in set is moved in place when its cost change
+ * instead of adding second entry. Memory is kept between searches.
  */
 class PathfindingOpenSet
 {
 public:
-	/// Cleans up the set and frees allocated memory.
+	/// Cleans up the set.
 	~PathfindingOpenSet();
+	/// Removes all nodes from the set, keeps allocated memory.
+	void clear();
 	/// Gets the next node to check.
 	PathfindingNode *pop();
-	/// Adds a node to the set.
+	/// Adds a node to the set or updates its position when it is already there.
 	void push(PathfindingNode *node);
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
+	bool empty() const { return _heap.empty(); }
 
 private:
-	std::priority_queue<OpenSetEntry, std::vector<OpenSetEntry>, EntryCompare> _queue;
-
-	/// Removes reachable discarded entries.
-	void removeDiscarded();
+	std::vector<PathfindingNode*> _heap;
+
+	/// Puts node at given position in heap.
+	void place(size_t index, PathfindingNode *node);
+	/// Moves node toward the top of the heap.
+	void siftUp(size_t index);
+	/// Moves node toward the bottom of the heap.
+	void siftDown(size_t index);
 };
 
 }
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include "ReachabilityCache.h"
+#include "PathfindingNode.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates empty cache, it need be initialized before usage.
+ */
+ReachabilityCache::ReachabilityCache() : _mapSizeX(0), _mapSizeY(0), _mapSizeZ(0), _stamp(0)
+{
+
+}
+
+/**
+ * Prepares cache for a map of given size, all old areas are dropped.
+ * @param mapSizeX Size of map in X.
+ * @param mapSizeY Size of map in Y.
+ * @param mapSizeZ Size of map in Z.
+ */
+void ReachabilityCache::init(int mapSizeX, int mapSizeY, int mapSizeZ)
+{
+	_mapSizeX = mapSizeX;
+	_mapSizeY = mapSizeY;
+	_mapSizeZ = mapSizeZ;
+	_areas.clear();
+}
+
+/**
+ * Checks if position is inside bounds of area or next to it, unit there can block or unblock some path.
+ * @param area Area to check.
+ * @param pos Position to check.
+ * @return True if position is near.
+ */
+bool ReachabilityCache::nearArea(const ReachableArea& area, Position pos)
+{
+	return pos.x >= area._boundMin.x - 1 && pos.x <= area._boundMax.x + 1 &&
+		pos.y >= area._boundMin.y - 1 && pos.y <= area._boundMax.y + 1 &&
+		pos.z >= area._boundMin.z - 1 && pos.z <= area._boundMax.z + 1;
+}
+
+/**
+ * Finds valid area stored for given key.
+ * @param key Parameters of search.
+ * @return Area or null if there is no valid one.
+ */
+ReachableAreaPtr ReachabilityCache::find(const ReachabilityKey& key) const
+{
+	for (const auto& area : _areas)
+	{
+		if (area->_valid && area->_key == key)
+		{
+			return area;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Finds slot for area with given key, it is slot already used by this key, first slot with dropped area,
+ * new slot when there is still space or slot of oldest area.
+ * @param key Parameters of search.
+ * @return Index of slot, equal to number of areas when new one should be added.
+ */
+size_t ReachabilityCache::findSlot(const ReachabilityKey& key) const
+{
+	size_t slot = _areas.size();
+	for (size_t i = 0; i < _areas.size(); ++i)
+	{
+		if (_areas[i]->_key == key)
+		{
+			return i;
+		}
+		if (slot == _areas.size() && !_areas[i]->_valid)
+		{
+			slot = i;
+		}
+	}
+	if (slot == _areas.size() && _areas.size() >= MaxAreas)
+	{
+		slot = std::min_element(_areas.begin(), _areas.end(), [](const auto& a, const auto& b) { return a->_stamp < b->_stamp; }) - _areas.begin();
+	}
+	return slot;
+}
+
+/**
+ * Puts area to slot, area that was there before is only released, so handles to it stay valid.
+ * @param slot Index of slot, can be equal to number of areas.
+ * @param area Area to store.
+ * @return Stored area.
+ */
+ReachableAreaPtr ReachabilityCache::put(size_t slot, std::shared_ptr<ReachableArea> area)
+{
+	area->_stamp = ++_stamp;
+	if (slot == _areas.size())
+	{
+		_areas.push_back(std::move(area));
+	}
+	else
+	{
+		_areas[slot] = std::move(area);
+	}
+	return _areas[slot];
+}
+
+/**
+ * Stores result of reachability search. Memory of dropped areas is reused when nobody else hold them.
+ * @param key Parameters of search.
+ * @param nodes Nodes found by `Pathfinding::findReachablePathFindingNodes`.
+ * @param timeUnits Time units of unit, nodes cost is subtracted from it.
+ * @param ranOutOfTUs Did search run out of TUs.
+ * @return Stored area.
+ */
+ReachableAreaPtr ReachabilityCache::store(const ReachabilityKey& key, const std::vector<PathfindingNode*>& nodes, int timeUnits, bool ranOutOfTUs)
+{
+	size_t slot = findSlot(key);
+	std::shared_ptr<ReachableArea> area;
+	if (slot < _areas.size() && _areas[slot].use_count() == 1)
+	{
+		area = std::move(_areas[slot]);
+	}
+	else
+	{
+		area = std::make_shared<ReachableArea>();
+	}
+	fill(*area, key, nodes, timeUnits, ranOutOfTUs);
+	return put(slot, std::move(area));
+}
+
+/**
+ * Fills area with result of reachability search. Only the area is changed, so different areas can be filled in parallel.
+ * @param area Area to fill, not stored in this cache yet.
+ * @param key Parameters of search.
+ * @param nodes Nodes found by `Pathfinding::findReachablePathFindingNodes`.
+ * @param timeUnits Time units of unit, nodes cost is subtracted from it.
+ * @param ranOutOfTUs Did search run out of TUs.
+ */
+void ReachabilityCache::fill(ReachableArea& area, const ReachabilityKey& key, const std::vector<PathfindingNode*>& nodes, int timeUnits, bool ranOutOfTUs) const
+{
+	area._key = key;
+	area._valid = true;
+	area._ranOutOfTUs = ranOutOfTUs;
+	area._tuLeft.assign((size_t)_mapSizeX * _mapSizeY * _mapSizeZ, ReachableArea::Unreachable);
+	area._list.clear();
+	area._boundMin = Position(_mapSizeX, _mapSizeY, _mapSizeZ);
+	area._boundMax = Position(-1, -1, -1);
+
+	for (const auto* node : nodes)
+	{
+		const Position pos = node->getPosition();
+		const int index = pos.z * _mapSizeY * _mapSizeX + pos.y * _mapSizeX + pos.x;
+		const int tuLeft = timeUnits - node->getTUCost(false).time;
+		area._list.push_back(std::make_pair(pos, tuLeft));
+		area._tuLeft[index] = (Sint16)tuLeft;
+
+		area._boundMin.x = std::min(area._boundMin.x, pos.x);
+		area._boundMin.y = std::min(area._boundMin.y, pos.y);
+		area._boundMin.z = std::min(area._boundMin.z, pos.z);
+		area._boundMax.x = std::max(area._boundMax.x, pos.x);
+		area._boundMax.y = std::max(area._boundMax.y, pos.y);
+		area._boundMax.z = std::max(area._boundMax.z, pos.z);
+	}
+	std::sort(area._list.begin(), area._list.end(), [](const auto& a, const auto& b) { return PositionComparator{}(a.first, b.first); });
+}
+
+/**
+ * Stores area filled by `fill`, it replace area with same key, some dropped one or the oldest one.
+ * @param area Filled area.
+ * @return Stored area.
+ */
+ReachableAreaPtr ReachabilityCache::insert(std::unique_ptr<ReachableArea> area)
+{
+	size_t slot = findSlot(area->_key);
+	return put(slot, std::move(area));
+}
+
+/**
+ * Drops areas that could change because unit stands at or left given position.
+ * @param pos Position of unit.
+ * @param size Size of unit.
+ */
+void ReachabilityCache::invalidate(Position pos, int size)
+{
+	for (auto& area : _areas)
+	{
+		if (!area->_valid)
+		{
+			continue;
+		}
+		for (int x = 0; x < size && area->_valid; ++x)
+		{
+			for (int y = 0; y < size && area->_valid; ++y)
+			{
+				if (nearArea(*area, pos + Position(x, y, 0)))
+				{
+					area->_valid = false;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Drops areas that could change because terrain changed in given part of map.
+ * @param changed Changed part of map, all levels.
+ */
+void ReachabilityCache::invalidate(MapSubset changed)
+{
+	if (!changed)
+	{
+		return;
+	}
+	for (auto& area : _areas)
+	{
+		if (area->_valid &&
+			area->_boundMax.x + 1 >= changed.beg_x && area->_boundMin.x - 1 < changed.end_x &&
+			area->_boundMax.y + 1 >= changed.beg_y && area->_boundMin.y - 1 < changed.end_y)
+		{
+			area->_valid = false;
+		}
+	}
+}
+
+/**
+ * Drops all areas, memory is kept for reuse.
+ */
+void ReachabilityCache::clear()
+{
+	for (auto& area : _areas)
+	{
+		area->_valid = false;
+	}
+}
+
+/**
+ * Gets number of valid areas.
+ * @return Number of areas.
+ */
+size_t ReachabilityCache::size() const
+{
+	return std::count_if(_areas.begin(), _areas.end(), [](const auto& a) { return a->_valid; });
+}
+
+}
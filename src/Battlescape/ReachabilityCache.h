@@ -0,0 +1,136 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <memory>
+#include <utility>
+#include <vector>
+#include <SDL_types.h>
+#include "Position.h"
+#include "VisibilityCache.h"
+
+namespace OpenXcom
+{
+
+class PathfindingNode;
+
+/**
+ * Parameters of reachability search, two searches with same key give same result while world does not change.
+ */
+struct ReachabilityKey
+{
+	int unitId = -1;
+	int startIndex = -1;
+	int tuMax = 0;
+	int energyMax = 0;
+	bool useMaxTUs = false;
+	bool ignoreFriends = false;
+
+	bool operator==(const ReachabilityKey&) const = default;
+};
+
+/**
+ * Tiles reachable by one unit from one start position, with time units left after reaching them.
+ * Can be iterated as list of (position, TUs left) ordered like `PositionComparator`,
+ * or queried by tile index in constant time.
+ */
+class ReachableArea
+{
+	/// Value in dense grid used for tiles out of reach.
+	static constexpr Sint16 Unreachable = -32768;
+
+	ReachabilityKey _key;
+	std::vector<std::pair<Position, int>> _list;
+	std::vector<Sint16> _tuLeft;
+	Position _boundMin, _boundMax;
+	Uint32 _stamp = 0;
+	bool _ranOutOfTUs = false;
+	bool _valid = false;
+
+	friend class ReachabilityCache;
+
+public:
+	using const_iterator = std::vector<std::pair<Position, int>>::const_iterator;
+
+	/// Gets first reachable position.
+	const_iterator begin() const { return _list.begin(); }
+	/// Gets end of reachable positions.
+	const_iterator end() const { return _list.end(); }
+	/// Number of reachable tiles.
+	size_t size() const { return _list.size(); }
+	/// Is there no reachable tile?
+	bool empty() const { return _list.empty(); }
+	/// Did search stop somewhere because of missing TUs or energy?
+	bool getRanOutOfTUs() const { return _ranOutOfTUs; }
+	/// Checks if tile with given index is reachable.
+	bool isReachable(int tileIndex) const { return tileIndex >= 0 && tileIndex < (int)_tuLeft.size() && _tuLeft[tileIndex] != Unreachable; }
+	/// Gets TUs left after reaching tile, only valid for reachable tiles.
+	int getTULeft(int tileIndex) const { return _tuLeft[tileIndex]; }
+};
+
+/// Shared handle to area, it stays valid even when cache drops or replaces it.
+using ReachableAreaPtr = std::shared_ptr<const ReachableArea>;
+
+/**
+ * Turn scoped store of unit reachability shared by all AI units.
+ * Entries are dropped when some unit moves or terrain changes near area they cover, and all of them at end of turn.
+ * Number of stored areas is limited, when full the oldest one is replaced.
+ */
+class ReachabilityCache
+{
+	/// Max number of areas, every one have grid of size of whole map.
+	static constexpr size_t MaxAreas = 64;
+
+	std::vector<std::shared_ptr<ReachableArea>> _areas;
+	int _mapSizeX, _mapSizeY, _mapSizeZ;
+	Uint32 _stamp;
+
+	/// Checks if position is inside bounds of area or next to it.
+	static bool nearArea(const ReachableArea& area, Position pos);
+	/// Finds slot for area with given key, can be equal to number of areas when new one is needed.
+	size_t findSlot(const ReachabilityKey& key) const;
+	/// Puts area to slot and marks it as newest.
+	ReachableAreaPtr put(size_t slot, std::shared_ptr<ReachableArea> area);
+
+public:
+	/// Creates empty cache.
+	ReachabilityCache();
+
+	/// Prepares cache for map of given size.
+	void init(int mapSizeX, int mapSizeY, int mapSizeZ);
+	/// Finds valid area stored for given key.
+	ReachableAreaPtr find(const ReachabilityKey& key) const;
+	/// Stores result of reachability search.
+	ReachableAreaPtr store(const ReachabilityKey& key, const std::vector<PathfindingNode*>& nodes, int timeUnits, bool ranOutOfTUs);
+	/// Fills area with result of reachability search, safe to call from worker threads.
+	void fill(ReachableArea& area, const ReachabilityKey& key, const std::vector<PathfindingNode*>& nodes, int timeUnits, bool ranOutOfTUs) const;
+	/// Stores area filled by `fill`.
+	ReachableAreaPtr insert(std::unique_ptr<ReachableArea> area);
+	/// Drops areas affected by unit standing at or leaving given position.
+	void invalidate(Position pos, int size);
+	/// Drops areas affected by change of terrain in given part of map.
+	void invalidate(MapSubset area);
+	/// Drops all areas.
+	void clear();
+	/// Number of valid areas.
+	size_t size() const;
+	/// Max number of areas stored at once.
+	static constexpr size_t capacity() { return MaxAreas; }
+};
+
+}
@@ -18,6 +18,7 @@
  */
 #include <assert.h>
 #include <set>
+#include <limits>
 #include "TileEngine.h"
 #include "AIModule.h"
 #include "Map.h"
@@ -39,6 +40,10 @@
 #include "../Mod/Armor.h"
 #include "../Mod/RuleSkill.h"
 #include "../Engine/Options.h"
+#include "../Engine/ThreadPool.h"
+#include "../Engine/Profiler.h"
+#include "ReachabilityCache.h"
+#include "InfluenceMap.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -875,6 +880,7 @@ TileEngine::TileEngine(SavedBattleGame *save, Mod *mod) :
 	_enhancedLighting(mod->getEnhancedLighting())
 {
 	_blockVisibility.resize(save->getMapSizeXYZ());
+	_visibilityCache.init(save->getMapSizeX(), save->getMapSizeY(), save->getMapSizeZ());
 	_cacheTilePos = invalid;
 
 	if (Options::oxceTogglePersonalLightType == 2)
@@ -906,34 +912,35 @@ TileEngine::~TileEngine()
   */
 void TileEngine::calculateSunShading(MapSubset gs)
 {
-	int power = 15 - _save->getGlobalShade();
+	const int power = 15 - _save->getGlobalShade();
+	// At night/dusk sun isn't dropping shades blocked by roofs
+	const bool roofShade = _save->getGlobalShade() <= 4;
+	Uint8* ambient = _save->getTileStore().getLightData(LL_AMBIENT);
 
-	iterateTiles(
-		_save,
-		gs,
-		[&](Tile* tile)
+	gs = MapSubset::intersection(gs, MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() });
+	for (int y = gs.beg_y; y < gs.end_y; ++y)
+	{
+		for (int x = gs.beg_x; x < gs.end_x; ++x)
 		{
-			auto currLight = power;
-
-			// At night/dusk sun isn't dropping shades blocked by roofs
-			if (_save->getGlobalShade() <= 4)
+			// walk column from top, so blockage of every level above is summed only once
+			int block = 0;
+			for (int z = _save->getMapSizeZ() - 1; z >= 0; --z)
 			{
-				int block = 0;
-				int x = tile->getPosition().x;
-				int y = tile->getPosition().y;
-				for (int z = _save->getMapSizeZ()-1; z > tile->getPosition().z ; z--)
+				Tile* tile = _save->getTile(Position(x, y, z));
+				const int currLight = (roofShade && block > 0) ? power - 2 : power;
+				Uint8& light = ambient[tile->getIndex()];
+				if (light < currLight)
 				{
-					block += blockage(_save->getTile(Position(x, y, z)), O_FLOOR, DT_NONE);
-					block += blockage(_save->getTile(Position(x, y, z)), O_OBJECT, DT_NONE, Pathfinding::DIR_DOWN);
+					light = currLight;
 				}
-				if (block>0)
+				if (roofShade)
 				{
-					currLight -= 2;
+					block += blockage(tile, O_FLOOR, DT_NONE);
+					block += blockage(tile, O_OBJECT, DT_NONE, Pathfinding::DIR_DOWN);
 				}
 			}
-			tile->addLight(currLight, LL_AMBIENT);
 		}
-	);
+	}
 }
 
 /// amount of light a fire generates from tile
@@ -1093,6 +1100,7 @@ void TileEngine::calculateUnitLighting(MapSubset gs)
 
 void TileEngine::calculateLighting(LightLayers layer, Position position, int eventRadius, bool terrianChanged)
 {
+	OXCE_PROFILE_ZONE("TileEngine::calculateLighting");
 	auto gsDynamic = MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() };
 	auto gsStatic = gsDynamic;
 
@@ -1104,6 +1112,43 @@ void TileEngine::calculateLighting(LightLayers layer, Position position, int eve
 
 	if (terrianChanged)
 	{
+		// any cached line of sight crossing changed tiles could be wrong now
+		if (position != invalid)
+		{
+			_visibilityCache.invalidate(mapArea(position, eventRadius + 1));
+		}
+		else
+		{
+			_visibilityCache.clear();
+		}
+		if (_save->getPathfinding())
+		{
+			_save->getPathfinding()->invalidateTUCostCache();
+		}
+		if (_save->getReachabilityCache())
+		{
+			if (position != invalid)
+			{
+				_save->getReachabilityCache()->invalidate(mapArea(position, eventRadius + 1));
+			}
+			else
+			{
+				_save->getReachabilityCache()->clear();
+			}
+		}
+		// cover and paths could change, smoke changed by explosion or fire is reported here too
+		if (_save->getInfluenceMap())
+		{
+			if (position != invalid)
+			{
+				_save->getInfluenceMap()->invalidate(mapArea(position, eventRadius + 1));
+			}
+			else
+			{
+				_save->getInfluenceMap()->clear();
+			}
+		}
+
 		iterateTiles(
 			_save,
 			mapArea(position, position != invalid ? eventRadius + 1 : 1000),
@@ -1152,24 +1197,10 @@ void TileEngine::calculateLighting(LightLayers layer, Position position, int eve
 
 	if (layer <= LL_FIRE)
 	{
-		iterateTiles(
-			_save,
-			gsStatic,
-			[&](Tile* tile)
-			{
-				tile->resetLightMulti(layer);
-			}
-		);
+		resetLight(gsStatic, layer);
 	}
 
-	iterateTiles(
-		_save,
-		gsDynamic,
-		[&](Tile* tile)
-		{
-			tile->resetLightMulti(std::max(layer, LL_ITEMS));
-		}
-	);
+	resetLight(gsDynamic, std::max(layer, LL_ITEMS));
 
 	if (layer <= LL_AMBIENT) calculateSunShading(gsStatic);
 	if (layer <= LL_FIRE) calculateTerrainBackground(gsStatic);
@@ -1177,6 +1208,48 @@ void TileEngine::calculateLighting(LightLayers layer, Position position, int eve
 	if (layer <= LL_UNITS) calculateUnitLighting(gsDynamic);
 }
 
+/**
+ * Gets light falloff of source with given power, stamps are created on first use.
+ * @param power Power of light source.
+ * @return Light stamp.
+ */
+const LightStamp& TileEngine::getLightStamp(int power)
+{
+	while ((int)_lightStamps.size() <= power)
+	{
+		_lightStamps.emplace_back((int)_lightStamps.size());
+	}
+	return _lightStamps[power];
+}
+
+/**
+ * Clears light of tiles in area, one map row at a time.
+ * @param gs Area of map, all levels.
+ * @param layer First layer to clear, all higher layers are cleared too.
+ */
+void TileEngine::resetLight(MapSubset gs, LightLayers layer)
+{
+	TileStore& store = _save->getTileStore();
+	Uint8* layers[LL_MAX];
+	for (int l = 0; l < LL_MAX; ++l)
+	{
+		layers[l] = store.getLightData((LightLayers)l);
+	}
+
+	gs = MapSubset::intersection(gs, MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() });
+	if (!gs)
+	{
+		return;
+	}
+	for (int z = 0; z < _save->getMapSizeZ(); ++z)
+	{
+		for (int y = gs.beg_y; y < gs.end_y; ++y)
+		{
+			LightStamp::resetRow(layers, layer, LL_MAX, _save->getTileIndex(Position(gs.beg_x, y, z)), gs.size_x());
+		}
+	}
+}
+
 /**
  * Adds circular light pattern starting from center and losing power with distance travelled.
  * @param center Center.
@@ -1203,6 +1276,34 @@ void TileEngine::addLight(MapSubset gs, Position center, int power, LightLayers
 	const auto topTargetVoxel = static_cast<Sint16>(_save->getMapSizeZ() * accuracy.z - 1);
 	const auto topCenterVoxel = static_cast<Sint16>((getBlockUp(_blockVisibility[_save->getTileIndex(center)]) ? (center.z + 1) : _save->getMapSizeZ()) * accuracy.z - 1);
 	const auto maxFirePower = std::min(15, getMaxStaticLightDistance() - 1);
+	const auto& stamp = getLightStamp(power);
+
+	if (clasicLighting)
+	{
+		// without light rays every tile get plain falloff, so whole rows of stamp are blended at once
+		const auto area = MapSubset::intersection(MapSubset::intersection(gs, mapArea(center, power - 1)), MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() });
+		if (!area)
+		{
+			return;
+		}
+		TileStore& store = _save->getTileStore();
+		Uint8* layers[LL_MAX];
+		for (int l = 0; l < LL_MAX; ++l)
+		{
+			layers[l] = store.getLightData((LightLayers)l);
+		}
+		const int begZ = std::max(0, center.z - stamp.getRadiusZ());
+		const int endZ = std::min(_save->getMapSizeZ() - 1, center.z + stamp.getRadiusZ());
+		for (int z = begZ; z <= endZ; ++z)
+		{
+			for (int y = area.beg_y; y < area.end_y; ++y)
+			{
+				const Uint8* row = stamp.getRow(y - center.y, z - center.z) + (area.beg_x - center.x + stamp.getRadius());
+				LightStamp::blendRow(layers, layer, _save->getTileIndex(Position(area.beg_x, y, z)), row, area.size_x());
+			}
+		}
+		return;
+	}
 
 	iterateTiles(
 		_save,
@@ -1211,19 +1312,13 @@ void TileEngine::addLight(MapSubset gs, Position center, int power, LightLayers
 		{
 			const auto target = tile->getPosition();
 			const auto diff = target - center;
-			const auto distance = (int)Round(Position::distance(target.toVoxel(), center.toVoxel()) / Position::TileXY);
 			const auto targetLight = tile->getLightMulti(layer);
-			auto currLight = power - distance;
+			auto currLight = stamp.get(diff);
 
 			if (currLight <= targetLight)
 			{
 				return;
 			}
-			if (clasicLighting)
-			{
-				tile->addLight(currLight, layer);
-				return;
-			}
 
 			Position startVoxel = (center * accuracy) + offsetCenter;
 			Position endVoxel = (target * accuracy) + offsetTarget + Position(0, 0, std::max(0, (_blockVisibility[_save->getTileIndex(target)].height - 1) / (2 * divide)));
@@ -1330,14 +1425,15 @@ void TileEngine::addLight(MapSubset gs, Position center, int power, LightLayers
  * @param observerPos Position of the observer of this event.
  * @param eventPos The centre of the event. Ie a moving unit's position, centre of explosion, a single destroyed tile, etc.
  * @param eventRadius Radius big enough to fully envelop the event. Ie for a single tile change, set radius to 1.
+ * @param sector Output sector.
  * @return true if area is unlimited.
  *
 */
-bool TileEngine::setupEventVisibilitySector(const Position &observerPos, const Position &eventPos, const int &eventRadius)
+bool TileEngine::setupEventVisibilitySector(const Position &observerPos, const Position &eventPos, const int &eventRadius, EventVisibilitySector &sector)
 {
 	if (eventRadius == 0 || eventPos == Position(-1, -1, -1) || Position::distance2dSq(observerPos, eventPos) <= eventRadius * eventRadius)
 	{
-		_eventVisibilityObserverPos = Position{ -1, -1, -1 };
+		sector.observerPos = Position{ -1, -1, -1 };
 		return true;
 	}
 	else
@@ -1351,11 +1447,11 @@ bool TileEngine::setupEventVisibilitySector(const Position &observerPos, const P
 		float t1 = b - a;
 		float t2 = b + a;
 		//Define the points where the lines tangent to the circle intersect it. Note: resulting positions are relative to observer, not in direct tile space.
-		_eventVisibilitySectorL.x = (Sint16)roundf(eventPos.x + eventRadius * sinf(t1)) - observerPos.x;
-		_eventVisibilitySectorL.y = (Sint16)roundf(eventPos.y - eventRadius * cosf(t1)) - observerPos.y;
-		_eventVisibilitySectorR.x = (Sint16)roundf(eventPos.x - eventRadius * sinf(t2)) - observerPos.x;
-		_eventVisibilitySectorR.y = (Sint16)roundf(eventPos.y + eventRadius * cosf(t2)) - observerPos.y;
-		_eventVisibilityObserverPos = observerPos;
+		sector.left.x = (Sint16)roundf(eventPos.x + eventRadius * sinf(t1)) - observerPos.x;
+		sector.left.y = (Sint16)roundf(eventPos.y - eventRadius * cosf(t1)) - observerPos.y;
+		sector.right.x = (Sint16)roundf(eventPos.x - eventRadius * sinf(t2)) - observerPos.x;
+		sector.right.y = (Sint16)roundf(eventPos.y + eventRadius * cosf(t2)) - observerPos.y;
+		sector.observerPos = observerPos;
 		return false;
 	}
 }
@@ -1363,17 +1459,18 @@ bool TileEngine::setupEventVisibilitySector(const Position &observerPos, const P
 /**
  * Checks whether toCheck is within a previously setup eventVisibilitySector. See setupEventVisibilitySector(...).
  * May be used to rapidly reduce the search space when updating unit and tile visibility.
+ * @param sector The sector to check against.
  * @param toCheck The position to check.
  * @return true if within the circle sector.
  */
-inline bool TileEngine::inEventVisibilitySector(const Position &toCheck) const
+inline bool TileEngine::inEventVisibilitySector(const EventVisibilitySector &sector, const Position &toCheck)
 {
-	if (_eventVisibilityObserverPos != Position{ -1, -1, -1 })
+	if (sector.observerPos != Position{ -1, -1, -1 })
 	{
-		Position posDiff = toCheck - _eventVisibilityObserverPos;
+		Position posDiff = toCheck - sector.observerPos;
 		//Is toCheck within the arc as defined by the two tangent points?
-		return (!(-_eventVisibilitySectorL.x * posDiff.y + _eventVisibilitySectorL.y * posDiff.x > 0) &&
-			(-_eventVisibilitySectorR.x * posDiff.y + _eventVisibilitySectorR.y * posDiff.x > 0));
+		return (!(-sector.left.x * posDiff.y + sector.left.y * posDiff.x > 0) &&
+			(-sector.right.x * posDiff.y + sector.right.y * posDiff.x > 0));
 	}
 	else
 	{
@@ -1400,7 +1497,8 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 		return false;
 
 	Position posSelf = unit->getPosition();
-	if (setupEventVisibilitySector(posSelf, eventPos, eventRadius))
+	EventVisibilitySector sector;
+	if (setupEventVisibilitySector(posSelf, eventPos, eventRadius, sector))
 	{
 		//Asked to do a full check. Or the event is overlapping our tile. Better check everything.
 		unit->clearVisibleUnits();
@@ -1425,7 +1523,7 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 					totalUnitTiles++;
 					Position posToCheck = posOther + Position(x, y, 0);
 					//If we can now find any unit within the arc defined by the event tangent points, its visibility may have been affected by the event.
-					if (inEventVisibilitySector(posToCheck))
+					if (inEventVisibilitySector(sector, posToCheck))
 					{
 						if (!unit->checkViewSector(posToCheck, useTurretDirection))
 						{
@@ -1499,10 +1597,69 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 * @param eventRadius The radius of a circle able to fully encompass the event, in tiles. Hence: 1 for a single tile event.
 */
 void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius)
+{
+	auto& scratch = getFovScratch(0);
+	FovResult result;
+	result.tiles.swap(scratch.tiles);
+	computeTilesInFOV(unit, eventPos, eventRadius, scratch, result);
+	applyTilesInFOV(unit, result);
+	result.tiles.swap(scratch.tiles);
+}
+
+/**
+ * Finds all tiles in view cone seen from given eyes, without changing any state.
+ * Both algorithms need to give same set of tiles, the same tile can be stored multiple times.
+ * @param engine Algorithm used, parity mode is same as legacy.
+ * @param posSelf Position of unit eyes.
+ * @param direction Direction of view.
+ * @param size Size of unit, large units have eyes on every tile they occupy.
+ * @param visibleTiles Output list of visible tiles.
+ */
+void TileEngine::getTilesInFOV(FovEngine engine, Position posSelf, int direction, int size, std::vector<Position> &visibleTiles) const
+{
+	visibleTiles.clear();
+	if (engine == FOV_ENGINE_PROPAGATION)
+	{
+		FovScratch scratch;
+		propagateTilesInFOV(size, posSelf, direction, false, scratch, visibleTiles);
+	}
+	else
+	{
+		traceTilesInFOV(size, posSelf, direction, 0, EventVisibilitySector{}, visibleTiles);
+	}
+}
+
+/**
+ * Gets scratch buffers of given worker, buffers are created on first use.
+ * Need be called on main thread before workers start, as it can resize list of buffers.
+ * @param worker Index of worker.
+ * @return Scratch buffers.
+ */
+TileEngine::FovScratch& TileEngine::getFovScratch(size_t worker)
+{
+	if (_fovScratch.size() <= worker)
+	{
+		_fovScratch.resize(worker + 1);
+	}
+	return _fovScratch[worker];
+}
+
+/**
+ * Finds tiles seen by unit. Only reads map and unit, so it can be called for many units in parallel.
+ * @param unit Unit to check line of sight of.
+ * @param eventPos The centre of the event which necessitated the FOV update.
+ * @param eventRadius The radius of a circle able to fully encompass the event, in tiles.
+ * @param scratch Buffers of current worker.
+ * @param result Output list of tiles and flags what need be done with them.
+ */
+void TileEngine::computeTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius, FovScratch &scratch, FovResult &result) const
 {
 	bool useTurretDirection = false;
 	bool skipNarrowArcTest = false;
 	int direction;
+	result.tiles.clear();
+	result.update = false;
+	result.clear = false;
 	if (Options::strafe && (unit->getTurretType() > -1))
 	{
 		direction = unit->getTurretDirection();
@@ -1519,28 +1676,22 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 	}
 	else if (unit->isOut())
 	{
-		unit->clearVisibleTiles();
+		result.clear = true;
 		return;
 	}
 	Position posSelf = unit->getPosition();
-	if (setupEventVisibilitySector(posSelf, eventPos, eventRadius))
+	EventVisibilitySector sector;
+	if (setupEventVisibilitySector(posSelf, eventPos, eventRadius, sector))
 	{
 		// Asked to do a full check. Or unit within event. Should update all.
-		unit->clearVisibleTiles();
+		result.clear = true;
 		skipNarrowArcTest = true;
 	}
+	result.update = true;
 
 	// Only recalculate bresenham lines to tiles that are at the event or further away.
 	const int distanceSqrMin = skipNarrowArcTest ? 0 : std::max(Position::distance2dSq(posSelf, eventPos) - eventRadius * eventRadius, 0);
 
-	// Variables for finding the tiles to test based on the view direction.
-	Position posTest;
-	std::vector<Position> _trajectory;
-	bool swap = (direction == 0 || direction == 4);
-	const int signX[8] = {+1, +1, +1, +1, -1, -1, -1, -1};
-	const int signY[8] = {-1, -1, -1, +1, +1, +1, -1, -1};
-	int y1, y2;
-
 	if ((unit->getHeight() + unit->getFloatHeight() + -_save->getTile(unit->getPosition())->getTerrainLevel()) >= 24 + 4)
 	{
 		Tile* tileAbove = _save->getTile(posSelf + Position(0, 0, 1));
@@ -1549,6 +1700,138 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 			++posSelf.z;
 		}
 	}
+
+	if (Options::oxceFovEngine == FOV_ENGINE_PROPAGATION && skipNarrowArcTest)
+	{
+		// update of narrow arc of interest only trace few lines, legacy tracer is good enough there
+		propagateTilesInFOV(unit->getArmor()->getSize(), posSelf, direction, false, scratch, result.tiles);
+	}
+	else
+	{
+		traceTilesInFOV(unit->getArmor()->getSize(), posSelf, direction, distanceSqrMin, sector, result.tiles);
+		if (Options::oxceFovEngine == FOV_ENGINE_PARITY && skipNarrowArcTest)
+		{
+			checkFOVParity(unit, posSelf, direction, scratch, result.tiles);
+		}
+	}
+}
+
+/**
+ * Marks tiles found by `computeTilesInFOV` as seen by unit, and for player units reveals them on map.
+ * @param unit Unit that see tiles.
+ * @param result Tiles found for this unit.
+ */
+void TileEngine::applyTilesInFOV(BattleUnit *unit, const FovResult &result)
+{
+	if (result.clear)
+	{
+		unit->clearVisibleTiles();
+	}
+	if (!result.update)
+	{
+		return;
+	}
+
+	for (const auto& posVisited : result.tiles)
+	{
+		// Add tiles to the visible list only once.
+		Tile* tile = _save->getTile(posVisited);
+		if (!unit->hasVisibleTile(tile))
+		{
+			unit->addToVisibleTiles(tile);
+			if (unit->getFaction() == FACTION_PLAYER)
+			{
+				tile->setVisible(+1);
+				tile->setDiscovered(true, O_FLOOR);
+
+				// walls to the east or south of a visible tile, we see that too
+				Tile* t = _save->getTile(Position(posVisited.x + 1, posVisited.y, posVisited.z));
+				if (t)
+					t->setDiscovered(true, O_WESTWALL);
+				t = _save->getTile(Position(posVisited.x, posVisited.y + 1, posVisited.z));
+				if (t)
+					t->setDiscovered(true, O_NORTHWALL);
+			}
+		}
+	}
+}
+
+/**
+ * Updates tiles and units seen by given units. Finding visible tiles is the heavy part and only reads map,
+ * so it is split over worker threads, then results are applied in original unit order on the current thread.
+ * Visibility of units stay serial, it shares voxel check cache and changes state of other units.
+ * @param units Units to update.
+ * @param eventPos The centre of the event which necessitated the FOV update.
+ * @param eventRadius The radius of a circle able to fully encompass the event, in tiles.
+ * @param updateTiles true to do an update of visible tiles.
+ * @param appendToTileVisibility true to append only new tiles and skip previously seen ones.
+ */
+void TileEngine::calculateFOVOfUnits(const std::vector<BattleUnit*> &units, const Position eventPos, const int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
+{
+	if (updateTiles)
+	{
+		if (_fovResults.size() < units.size())
+		{
+			_fovResults.resize(units.size());
+		}
+
+		auto& pool = ThreadPool::getGlobal();
+		// parity check logs differences, keep it on main thread
+		const size_t workers = Options::oxceFovEngine == FOV_ENGINE_PARITY ? 1 : pool.getWorkerCount();
+		getFovScratch(workers - 1);
+
+		auto job = [&](size_t i, size_t worker)
+		{
+			computeTilesInFOV(units[i], eventPos, eventRadius, _fovScratch[worker], _fovResults[i]);
+		};
+		if (workers > 1)
+		{
+			pool.parallelFor(units.size(), job);
+		}
+		else
+		{
+			for (size_t i = 0; i < units.size(); ++i)
+			{
+				job(i, 0);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		BattleUnit* bu = units[i];
+		if (updateTiles)
+		{
+			if (!appendToTileVisibility)
+			{
+				bu->clearVisibleTiles();
+			}
+			applyTilesInFOV(bu, _fovResults[i]);
+		}
+		calculateUnitsInFOV(bu, eventPos, eventRadius);
+	}
+}
+
+/**
+ * Traces a bresenham line to every tile in the view cone and stores all tiles visited before the line is blocked.
+ * The same tile can be stored multiple times.
+ * @param size Size of unit, large units have eyes on every tile they occupy.
+ * @param posSelf Position of unit eyes.
+ * @param direction Direction of view.
+ * @param distanceSqrMin Skip lines to tiles closer than this.
+ * @param sector Narrow arc of interest, only tiles inside it are checked.
+ * @param visibleTiles Output list of visible tiles.
+ */
+void TileEngine::traceTilesInFOV(int size, Position posSelf, int direction, int distanceSqrMin, const EventVisibilitySector &sector, std::vector<Position> &visibleTiles) const
+{
+	// Variables for finding the tiles to test based on the view direction.
+	Position posTest;
+	std::vector<Position> _trajectory;
+	bool swap = (direction == 0 || direction == 4);
+	const int signX[8] = {+1, +1, +1, +1, -1, -1, -1, -1};
+	const int signY[8] = {-1, -1, -1, +1, +1, +1, -1, -1};
+	int y1, y2;
+
 	// Test all tiles within view cone for visibility.
 	for (int x = 0; x <= getMaxViewDistance(); ++x) // TODO: Possible improvement: find the intercept points of the arc at max view distance and choose a more intelligent sweep of values when an event arc is defined.
 	{
@@ -1570,7 +1853,7 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 				posTest.x = posSelf.x + signX[direction] * (swap ? y : x);
 				posTest.y = posSelf.y + signY[direction] * (swap ? x : y);
 				// Only continue if the column of tiles at (x,y) is within the narrow arc of interest (if enabled)
-				if (inEventVisibilitySector(posTest))
+				if (inEventVisibilitySector(sector, posTest))
 				{
 					for (int z = 0; z < _save->getMapSizeZ(); z++)
 					{
@@ -1580,7 +1863,6 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 						{
 							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
 							// large units have "4 pair of eyes"
-							int size = unit->getArmor()->getSize();
 							for (int xo = 0; xo < size; xo++)
 							{
 								for (int yo = 0; yo < size; yo++)
@@ -1594,28 +1876,9 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 										_trajectory.pop_back();
 									}
 									// Reveal all tiles along line of vision. Note: needed due to width of bresenham stroke.
-									for (const auto& posVisited : _trajectory)
-									{
-										// Add tiles to the visible list only once. BUT we still need to calculate the whole trajectory as
-										//  this bresenham line's period might be different from the one that originally revealed the tile.
-										if (!unit->hasVisibleTile(_save->getTile(posVisited)))
-										{
-											unit->addToVisibleTiles(_save->getTile(posVisited));
-											if (unit->getFaction() == FACTION_PLAYER)
-											{
-												_save->getTile(posVisited)->setVisible(+1);
-												_save->getTile(posVisited)->setDiscovered(true, O_FLOOR);
-
-												// walls to the east or south of a visible tile, we see that too
-												Tile* t = _save->getTile(Position(posVisited.x + 1, posVisited.y, posVisited.z));
-												if (t)
-													t->setDiscovered(true, O_WESTWALL);
-												t = _save->getTile(Position(posVisited.x, posVisited.y + 1, posVisited.z));
-												if (t)
-													t->setDiscovered(true, O_NORTHWALL);
-											}
-										}
-									}
+									// We still need to calculate the whole trajectory as this bresenham line's period
+									//  might be different from the one that originally revealed the tile.
+									visibleTiles.insert(visibleTiles.end(), _trajectory.begin(), _trajectory.end());
 								}
 							}
 						}
@@ -1626,6 +1889,269 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 	}
 }
 
+/**
+ * Gets tree of all lines traced by legacy FOV from one eye, created on first use.
+ * Lines go to every tile in view cone on every level of map, same as in `traceTilesInFOV`.
+ * Bresenham lines do not depend on start position, so tree is shared by all units looking in same direction from same level.
+ * @param direction Direction of view.
+ * @param wideCone Use wider cone of `visibleTilesFrom`, that for even directions reach up to max distance to side.
+ * @param eyeX Offset of eye from unit position, large units have more eyes.
+ * @param eyeY Offset of eye from unit position.
+ * @param eyeZ Level of eyes.
+ * @return Tree of lines.
+ */
+const TileEngine::FovRayTree& TileEngine::getFovRayTree(int direction, bool wideCone, int eyeX, int eyeY, int eyeZ) const
+{
+	const int sizeZ = _save->getMapSizeZ();
+	const size_t key = (((size_t)(wideCone && !(direction & 1)) * 8 + direction) * 4 + eyeX * 2 + eyeY) * sizeZ + eyeZ;
+
+	std::lock_guard<std::mutex> lock(_fovRayTreesMutex);
+	if (_fovRayTrees.size() <= key)
+	{
+		_fovRayTrees.resize(2 * 8 * 4 * sizeZ);
+	}
+	auto& tree = _fovRayTrees[key];
+	if (tree)
+	{
+		return *tree;
+	}
+
+	// trie of all lines, children are stored in order of creation
+	struct BuildNode
+	{
+		Position offset;
+		bool target = false;
+		std::vector<Uint32> children;
+	};
+	std::vector<BuildNode> build(1);
+
+	const bool swap = (direction == 0 || direction == 4);
+	const int signX[8] = {+1, +1, +1, +1, -1, -1, -1, -1};
+	const int signY[8] = {-1, -1, -1, +1, +1, +1, -1, -1};
+	const Position eye = Position(eyeX, eyeY, eyeZ);
+	for (int x = 0; x <= getMaxViewDistance(); ++x)
+	{
+		const int y1 = (direction & 1) ? 0 : -x;
+		const int y2 = (direction & 1) || wideCone ? getMaxViewDistance() : x;
+		for (int y = y1; y <= y2; ++y)
+		{
+			if (x * x + y * y > getMaxViewDistanceSq())
+			{
+				continue;
+			}
+			for (int z = 0; z < sizeZ; ++z)
+			{
+				const Position target = Position(signX[direction] * (swap ? y : x), signY[direction] * (swap ? x : y), z) - eye;
+				Uint32 curr = 0;
+				calculateLineHelper(Position(0, 0, 0), target,
+					[&](Position point)
+					{
+						if (point == build[curr].offset)
+						{
+							return false;
+						}
+						for (auto child : build[curr].children)
+						{
+							if (build[child].offset == point)
+							{
+								curr = child;
+								return false;
+							}
+						}
+						const auto next = (Uint32)build.size();
+						build[curr].children.push_back(next);
+						build.emplace_back();
+						build.back().offset = point;
+						curr = next;
+						return false;
+					},
+					[&](Position point)
+					{
+						return false;
+					}
+				);
+				build[curr].target = true;
+			}
+		}
+	}
+
+	// flatten to depth first order
+	tree = std::make_unique<FovRayTree>();
+	auto& nodes = tree->nodes;
+	nodes.reserve(build.size());
+	std::vector<std::pair<Uint32, Uint32>> stack = { { 0, 0 } };
+	while (!stack.empty())
+	{
+		const auto [buildIndex, parent] = stack.back();
+		stack.pop_back();
+
+		const auto& b = build[buildIndex];
+		const Position step = b.offset - (nodes.empty() ? b.offset : nodes[parent].offset);
+		FovRayTree::Node node = { };
+		node.offset = b.offset;
+		node.minX = node.minY = std::numeric_limits<Sint16>::max();
+		node.maxX = node.maxY = std::numeric_limits<Sint16>::min();
+		node.dir = Pathfinding::vectorToDirection(step);
+		node.dz = step.z;
+		node.target = b.target;
+		node.parent = parent;
+		const auto index = (Uint32)nodes.size();
+		nodes.push_back(node);
+		for (auto it = b.children.rbegin(); it != b.children.rend(); ++it)
+		{
+			stack.push_back({ *it, index });
+		}
+	}
+	// children are after parent, so going backward every subtree is finished before its parent
+	for (size_t i = nodes.size(); i-- > 0; )
+	{
+		auto& node = nodes[i];
+		if (node.end == 0)
+		{
+			node.end = (Uint32)(i + 1);
+		}
+		if (node.target)
+		{
+			node.minX = std::min(node.minX, node.offset.x);
+			node.maxX = std::max(node.maxX, node.offset.x);
+			node.minY = std::min(node.minY, node.offset.y);
+			node.maxY = std::max(node.maxY, node.offset.y);
+		}
+		if (i > 0)
+		{
+			auto& parent = nodes[node.parent];
+			parent.end = std::max(parent.end, node.end);
+			parent.minX = std::min(parent.minX, node.minX);
+			parent.maxX = std::max(parent.maxX, node.maxX);
+			parent.minY = std::min(parent.minY, node.minY);
+			parent.maxY = std::max(parent.maxY, node.maxY);
+		}
+	}
+	return *tree;
+}
+
+/**
+ * Finds same tiles as legacy tracer, by walking tree of all its lines merged by common prefix.
+ * A step shared by many lines is tested only once, and when it is blocked whole subtree is skipped.
+ * Same as in legacy, a tile is only seen when at least one line going through it ends inside map,
+ * and a big wall blocking the line is only seen when the line ends on it.
+ * @param size Size of unit, large units have eyes on every tile they occupy.
+ * @param posSelf Position of unit eyes.
+ * @param direction Direction of view.
+ * @param wideCone Use wider cone of `visibleTilesFrom`.
+ * @param scratch Buffers of current worker.
+ * @param visibleTiles Output list of visible tiles, large units can store same tile multiple times.
+ */
+void TileEngine::propagateTilesInFOV(int size, Position posSelf, int direction, bool wideCone, FovScratch &scratch, std::vector<Position> &visibleTiles) const
+{
+	const int sizeX = _save->getMapSizeX();
+	const int sizeY = _save->getMapSizeY();
+	auto inMapXY = [&](const Position& p)
+	{
+		return p.x >= 0 && p.x < sizeX && p.y >= 0 && p.y < sizeY;
+	};
+
+	for (int xo = 0; xo < size; xo++)
+	{
+		for (int yo = 0; yo < size; yo++)
+		{
+			const Position eye = posSelf + Position(xo, yo, 0);
+			if (!_save->getTile(eye))
+			{
+				continue;
+			}
+			const auto& nodes = getFovRayTree(direction, wideCone, xo, yo, eye.z).nodes;
+
+			// lines ending outside of map are not traced, find subtrees that have any other line
+			const auto& root = nodes.front();
+			const bool allInMap = eye.x + root.minX >= 0 && eye.x + root.maxX < sizeX && eye.y + root.minY >= 0 && eye.y + root.maxY < sizeY;
+			if (!allInMap)
+			{
+				scratch.mapTargets.assign(nodes.size(), 0);
+				for (size_t i = nodes.size(); i-- > 0; )
+				{
+					if (nodes[i].target && inMapXY(eye + nodes[i].offset))
+					{
+						scratch.mapTargets[i] = 1;
+					}
+					if (i > 0 && scratch.mapTargets[i])
+					{
+						scratch.mapTargets[nodes[i].parent] = 1;
+					}
+				}
+				if (!scratch.mapTargets[0])
+				{
+					continue;
+				}
+			}
+
+			visibleTiles.push_back(eye);
+			for (size_t i = 1; i < nodes.size(); )
+			{
+				const auto& node = nodes[i];
+				if (!allInMap && !scratch.mapTargets[i])
+				{
+					i = node.end;
+					continue;
+				}
+				const auto& cache = _blockVisibility[_save->getTileIndex(eye + nodes[node.parent].offset)];
+				if (getBlockDir(cache, node.dir, node.dz))
+				{
+					if (node.target && node.dz == 0 && getBigWallDir(cache, node.dir))
+					{
+						// line that end on big wall can see it
+						visibleTiles.push_back(eye + node.offset);
+					}
+					i = node.end;
+					continue;
+				}
+				visibleTiles.push_back(eye + node.offset);
+				++i;
+			}
+		}
+	}
+}
+
+/**
+ * Compares tiles found by legacy line tracer with result of propagation and logs differences.
+ * @param unit Unit to check line of sight of.
+ * @param posSelf Position of unit eyes.
+ * @param direction Direction of view.
+ * @param scratch Buffers of current worker.
+ * @param legacyTiles Tiles found by legacy tracer.
+ */
+void TileEngine::checkFOVParity(BattleUnit *unit, Position posSelf, int direction, FovScratch &scratch, const std::vector<Position> &legacyTiles) const
+{
+	std::vector<Position> propagationTiles;
+	propagateTilesInFOV(unit->getArmor()->getSize(), posSelf, direction, false, scratch, propagationTiles);
+
+	auto toIndexes = [&](const std::vector<Position>& tiles)
+	{
+		std::vector<int> indexes;
+		indexes.reserve(tiles.size());
+		for (const auto& p : tiles)
+		{
+			indexes.push_back(_save->getTileIndex(p));
+		}
+		std::sort(indexes.begin(), indexes.end());
+		indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+		return indexes;
+	};
+	const auto legacy = toIndexes(legacyTiles);
+	const auto propagation = toIndexes(propagationTiles);
+
+	std::vector<int> missing, extra;
+	std::set_difference(legacy.begin(), legacy.end(), propagation.begin(), propagation.end(), std::back_inserter(missing));
+	std::set_difference(propagation.begin(), propagation.end(), legacy.begin(), legacy.end(), std::back_inserter(extra));
+
+	if (!missing.empty() || !extra.empty())
+	{
+		Log(LOG_INFO) << "FOV parity: unit " << unit->getId() << " at " << posSelf << " direction " << direction
+			<< ": legacy " << legacy.size() << " tiles, propagation " << propagation.size()
+			<< ", missing " << missing.size() << ", extra " << extra.size();
+	}
+}
+
 /**
 * Recalculates line of sight of a soldier.
 * @param unit Unit to check line of sight of.
@@ -1635,6 +2161,7 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 */
 bool TileEngine::calculateFOV(BattleUnit *unit, bool doTileRecalc, bool doUnitRecalc)
 {
+	OXCE_PROFILE_ZONE("TileEngine::calculateFOV");
 	//Force a full FOV recheck for this unit.
 	if (doTileRecalc) calculateTilesInFOV(unit);
 	return doUnitRecalc ? calculateUnitsInFOV(unit) : false;
@@ -1927,7 +2454,10 @@ bool TileEngine::visible(BattleUnit *currentUnit, Tile *tile)
 		int visibilityQuality = visibleDistanceMaxVoxel - visibleDistanceVoxels - ((densityOfSmoke - densityOfSmokeNearUnit / 2) * smokeDensityFactor + (densityOfFire - densityOfFireeNearUnit / 2) * fireDensityFactor) * visibleDistanceUnitMaxTile/(3 * 20 * 100);
 		ModScript::VisibilityUnit::Output arg{ visibilityQuality, visibilityQuality, ScriptTag<BattleUnitVisibility>::getNullTag() };
 		ModScript::VisibilityUnit::Worker worker{ currentUnit, tile->getUnit(), tile, visibleDistanceVoxels, visibleDistanceMaxVoxel, visibleDistanceUnitMaxTile, densityOfSmoke, densityOfFire, densityOfSmokeNearUnit, densityOfFireeNearUnit };
-		worker.execute(currentUnit->getArmor()->getScript<ModScript::VisibilityUnit>(), arg);
+		{
+			OXCE_PROFILE_ZONE(ModScript::VisibilityUnit::scriptName);
+			worker.execute(currentUnit->getArmor()->getScript<ModScript::VisibilityUnit>(), arg);
+		}
 		unitSeen = 0 < arg.getFirst();
 	}
 	return unitSeen;
@@ -2105,7 +2635,10 @@ bool TileEngine::isTileInLOS(BattleAction *action, Tile *tile, bool drawing)
 		int visibilityQuality = visibleDistanceMaxVoxel - visibleDistanceVoxels - ((densityOfSmoke - densityOfSmokeNearUnit / 2) * smokeDensityFactor + (densityOfFire - densityOfFireeNearUnit / 2) * fireDensityFactor) * visibleDistanceUnitMaxTile/(3 * 20 * 100);
 		ModScript::VisibilityUnit::Output arg{ visibilityQuality, visibilityQuality, ScriptTag<BattleUnitVisibility>::getNullTag() };
 		ModScript::VisibilityUnit::Worker worker{ currentUnit, /*targetUnit*/ nullptr, tile, visibleDistanceVoxels, visibleDistanceMaxVoxel, visibleDistanceUnitMaxTile, densityOfSmoke, densityOfFire, densityOfSmokeNearUnit, densityOfFireeNearUnit };
-		worker.execute(currentUnit->getArmor()->getScript<ModScript::VisibilityUnit>(), arg);
+		{
+			OXCE_PROFILE_ZONE(ModScript::VisibilityUnit::scriptName);
+			worker.execute(currentUnit->getArmor()->getScript<ModScript::VisibilityUnit>(), arg);
+		}
 		seen = 0 < arg.getFirst();
 	}
 	return seen;
@@ -2726,6 +3259,7 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
  */
 void TileEngine::calculateFOV(Position position, int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
 {
+	OXCE_PROFILE_ZONE("TileEngine::calculateFOV(Position)");
 	int updateRadius;
 	if (eventRadius == -1)
 	{
@@ -2738,22 +3272,15 @@ void TileEngine::calculateFOV(Position position, int eventRadius, const bool upd
 		updateRadius = getMaxViewDistance() + (eventRadius > 0 ? eventRadius : 0);
 		updateRadius *= updateRadius;
 	}
+	_fovUnits.clear();
 	for (BattleUnit* bu : _save->getUnits())
 	{
 		if (Position::distance2dSq(position, bu->getPosition()) <= updateRadius) //could this unit have observed the event?
 		{
-			if (updateTiles)
-			{
-				if (!appendToTileVisibility)
-				{
-					bu->clearVisibleTiles();
-				}
-				calculateTilesInFOV(bu, position, eventRadius);
-			}
-
-			calculateUnitsInFOV(bu, position, eventRadius);
+			_fovUnits.push_back(bu);
 		}
 	}
+	calculateFOVOfUnits(_fovUnits, position, eventRadius, updateTiles, appendToTileVisibility);
 }
 
 /**
@@ -3134,12 +3661,19 @@ bool TileEngine::tryReaction(ReactionScore *reaction, BattleUnit *target, const
 			ModScript::ReactionCommon::Worker worker{ target, unit, action.weapon, action.type, reaction->count, originalAction.weapon, originalAction.skillRules, originalAction.type, origTarg, moveType, arc, _save };
 			if (originalAction.weapon)
 			{
+				OXCE_PROFILE_ZONE(ModScript::ReactionWeaponAction::scriptName);
 				worker.execute(originalAction.weapon->getRules()->getScript<ModScript::ReactionWeaponAction>(), arg);
 			}
 
-			worker.execute(target->getArmor()->getScript<ModScript::ReactionUnitAction>(), arg);
+			{
+				OXCE_PROFILE_ZONE(ModScript::ReactionUnitAction::scriptName);
+				worker.execute(target->getArmor()->getScript<ModScript::ReactionUnitAction>(), arg);
+			}
 
-			worker.execute(unit->getArmor()->getScript<ModScript::ReactionUnitReaction>(), arg);
+			{
+				OXCE_PROFILE_ZONE(ModScript::ReactionUnitReaction::scriptName);
+				worker.execute(unit->getArmor()->getScript<ModScript::ReactionUnitReaction>(), arg);
+			}
 
 			if (RNG::percent(arg.getFirst()))
 			{
@@ -3561,7 +4095,6 @@ void TileEngine::hit(BattleActionAttack attack, Position center, int power, cons
 	//Recalculate relevant item/unit locations and visibility depending on what happened during the hit
 	if (terrainChanged || effectGenerated)
 	{
-		resetVisibilityCache();
 		applyGravity(tile);
 		auto layer = LL_ITEMS;
 		if (part == V_FLOOR && _save->getTile(tilePos - Position(0, 0, 1)))
@@ -4480,7 +5013,6 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 				calculateLighting(LL_FIRE, doorCentre, doorsOpened, true);
 				// Update FOV through the doorway.
 				calculateFOV(doorCentre, doorsOpened, true, true);
-				resetVisibilityCache();
 			}
 			else return 4;
 		}
@@ -4573,7 +5105,7 @@ int TileEngine::closeUfoDoors()
  * @param trajectory A vector of positions in which the trajectory is stored.
  * @return 0 or some value greater than .
  */
-int TileEngine::calculateLineTile(Position origin, Position target, std::vector<Position> &trajectory)
+int TileEngine::calculateLineTile(Position origin, Position target, std::vector<Position> &trajectory) const
 {
 	Position lastPoint = origin;
 	int steps = 0;
@@ -6039,13 +6571,15 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
  */
 void TileEngine::recalculateFOV()
 {
+	_fovUnits.clear();
 	for (BattleUnit* bu : _save->getUnits())
 	{
 		if (bu->getTile() != 0)
 		{
-			calculateFOV(bu);
+			_fovUnits.push_back(bu);
 		}
 	}
+	calculateFOVOfUnits(_fovUnits, invalid, 0, true, false);
 }
 
 /**
@@ -6495,6 +7029,22 @@ std::set<Tile*> TileEngine::visibleTilesFrom(BattleUnit* unit, Position pos, int
 		if (scaleFactor < 1)
 			maxDist = (int)(maxDist * scaleFactor);
 	}
+	if (Options::oxceFovEngine == FOV_ENGINE_PROPAGATION && maxDist == getMaxViewDistance())
+	{
+		// shorter view distance of AI optimization use different set of lines, only legacy tracer handle it
+		auto& scratch = getFovScratch(0);
+		scratch.tiles.clear();
+		propagateTilesInFOV(unit->getArmor()->getSize(), pos, direction, true, scratch, scratch.tiles);
+		for (const auto& posVisited : scratch.tiles)
+		{
+			Tile* tile = _save->getTile(posVisited);
+			if (tile->getUnit())
+				continue;
+			if (!onlyNew || tile->getLastExplored(unit->getFaction()) < _save->getTurn())
+				visibleFrom.insert(tile);
+		}
+		return visibleFrom;
+	}
 	for (int x = 0; x <= maxDist; ++x) // TODO: Possible improvement: find the intercept points of the arc at max view distance and choose a more intelligent sweep of values when an event arc is defined.
 	{
 		if (direction & 1)
@@ -6558,26 +7108,56 @@ std::set<Tile*> TileEngine::visibleTilesFrom(BattleUnit* unit, Position pos, int
 	return visibleFrom;
 }
 
+/**
+ * Remembers visibility between two tiles, existing entry is not overridden.
+ * @param from Start tile.
+ * @param to End tile.
+ * @param visible Is end tile visible from start one.
+ */
 void TileEngine::setVisibilityCache(Position from, Position to, bool visible)
 {
-	std::pair<int, int> key = std::make_pair(_save->getTileIndex(from), _save->getTileIndex(to));
-	_visibilityCache.insert({key, visible});
+	_visibilityCache.set(_save->getTileIndex(from), _save->getTileIndex(to), visible);
 }
 
+/**
+ * Recalls visibility between two tiles.
+ * @param from Start tile.
+ * @param to End tile.
+ * @return Cached visibility, false if there is no entry.
+ */
 bool TileEngine::getVisibilityCache(Position from, Position to)
 {
-	std::pair<int, int> key = std::make_pair(_save->getTileIndex(from), _save->getTileIndex(to));
-	return _visibilityCache[key];
+	bool visible = false;
+	_visibilityCache.get(_save->getTileIndex(from), _save->getTileIndex(to), visible);
+	return visible;
 }
 
+/**
+ * Checks if there is cached visibility between two tiles.
+ * @param from Start tile.
+ * @param to End tile.
+ * @return True if there is entry.
+ */
 bool TileEngine::hasEntry(Position from, Position to)
 {
-	std::pair<int, int> key = std::make_pair(_save->getTileIndex(from), _save->getTileIndex(to));
-	if (_visibilityCache.find(key) != _visibilityCache.end())
-		return true;
-	return false;
+	return _visibilityCache.has(_save->getTileIndex(from), _save->getTileIndex(to));
 }
 
+/**
+ * Recalls visibility between two tiles using only one lookup.
+ * @param from Start tile.
+ * @param to End tile.
+ * @param visible Set to cached visibility when entry exists.
+ * @return True if there was entry.
+ */
+bool TileEngine::tryGetVisibilityCache(Position from, Position to, bool &visible)
+{
+	return _visibilityCache.get(_save->getTileIndex(from), _save->getTileIndex(to), visible);
+}
+
+/**
+ * Drops all cached visibility.
+ */
 void TileEngine::resetVisibilityCache()
 {
 	_visibilityCache.clear();
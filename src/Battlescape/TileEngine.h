@@ -17,9 +17,13 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "Position.h"
 #include "BattlescapeGame.h"
+#include "VisibilityCache.h"
+#include "LightStamp.h"
 #include "../Mod/RuleItem.h"
 #include "../Mod/MapData.h"
 
@@ -43,6 +47,19 @@ using MapSubset = AreaSubset<Position, Sint16>;
 enum BattleActionType : Uint8;
 enum LightLayers : Uint8;
 
+/**
+ * Algorithms available for calculating tiles in field of view, selected by `oxceFovEngine` option.
+ */
+enum FovEngine : int
+{
+	/// Separate bresenham line to every tile in view cone.
+	FOV_ENGINE_LEGACY = 0,
+	/// Same lines as legacy merged into tree by common prefix, every shared step is tested only once.
+	FOV_ENGINE_PROPAGATION = 1,
+	/// Use legacy result but compare it with propagation and log any differences.
+	FOV_ENGINE_PARITY = 2,
+};
+
 
 /**
  * A utility class that modifies tile properties on a battlescape map. This includes lighting, destruction, smoke, fire, fog of war.
@@ -118,18 +135,95 @@ private:
 	const int _maxStaticLightDistance;
 	const int _maxDynamicLightDistance;
 	const int _enhancedLighting;
-	Position _eventVisibilitySectorL, _eventVisibilitySectorR, _eventVisibilityObserverPos;
 	std::vector<BattleUnit*> _movingUnitPrev;
 	BattleUnit* _movingUnit = nullptr;
-	std::map<std::pair<int, int>, bool> _visibilityCache;
+	VisibilityCache _visibilityCache;
+
+	/**
+	 * Narrow circle sector around event as viewed from observer, see `setupEventVisibilitySector`.
+	 */
+	struct EventVisibilitySector
+	{
+		Position left, right;
+		Position observerPos = invalid;
+	};
+
+	/**
+	 * Buffers used by one worker thread when calculating tiles in FOV.
+	 */
+	struct FovScratch
+	{
+		std::vector<Position> tiles;
+		std::vector<Uint8> mapTargets;
+	};
+
+	/**
+	 * Lines traced by legacy FOV from one eye to every tile of view cone, merged by common prefix.
+	 * Nodes are stored in depth first order, subtree of node is range from its index to `end`.
+	 */
+	struct FovRayTree
+	{
+		struct Node
+		{
+			/// Offset from eye.
+			Position offset;
+			/// Bounds of line targets in subtree, offset from eye.
+			Sint16 minX, maxX, minY, maxY;
+			/// Step from parent, as used by blockage cache.
+			Sint8 dir, dz;
+			/// Some line ends in this node.
+			bool target;
+			Uint32 parent;
+			Uint32 end;
+		};
+		std::vector<Node> nodes;
+	};
 
+	/**
+	 * Tiles seen by one unit, calculated in parallel and applied later on main thread.
+	 */
+	struct FovResult
+	{
+		std::vector<Position> tiles;
+		bool update = false;
+		bool clear = false;
+	};
+
+	std::vector<FovScratch> _fovScratch;
+	mutable std::vector<std::unique_ptr<FovRayTree>> _fovRayTrees;
+	mutable std::mutex _fovRayTreesMutex;
+	std::vector<FovResult> _fovResults;
+	std::vector<BattleUnit*> _fovUnits;
+	std::vector<LightStamp> _lightStamps;
+
+	/// Gets precomputed light falloff for given power.
+	const LightStamp& getLightStamp(int power);
+	/// Clears light layers of tiles in area.
+	void resetLight(MapSubset gs, LightLayers layer);
 	/// Add light source.
 	void addLight(MapSubset gs, Position center, int power, LightLayers layer);
 	/// Calculate blockage amount.
 	int blockage(Tile *tile, const TilePart part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
 
-	bool setupEventVisibilitySector(const Position &observerPos, const Position &eventPos, const int &eventRadius);
-	inline bool inEventVisibilitySector(const Position &toCheck) const;
+	static bool setupEventVisibilitySector(const Position &observerPos, const Position &eventPos, const int &eventRadius, EventVisibilitySector &sector);
+	static inline bool inEventVisibilitySector(const EventVisibilitySector &sector, const Position &toCheck);
+
+	/// Gets scratch buffers of given worker.
+	FovScratch& getFovScratch(size_t worker);
+	/// Finds tiles seen by unit without changing any state, safe to call from worker threads.
+	void computeTilesInFOV(BattleUnit *unit, const Position eventPos, const int eventRadius, FovScratch &scratch, FovResult &result) const;
+	/// Marks tiles found by `computeTilesInFOV` as seen by unit.
+	void applyTilesInFOV(BattleUnit *unit, const FovResult &result);
+	/// Updates tiles and units seen by given units, tiles are calculated in parallel.
+	void calculateFOVOfUnits(const std::vector<BattleUnit*> &units, const Position eventPos, const int eventRadius, const bool updateTiles, const bool appendToTileVisibility);
+	/// Traces separate line to every tile in view cone and stores all tiles along them.
+	void traceTilesInFOV(int size, Position posSelf, int direction, int distanceSqrMin, const EventVisibilitySector &sector, std::vector<Position> &visibleTiles) const;
+	/// Gets tree of lines from eye to view cone, tree is created on first use.
+	const FovRayTree& getFovRayTree(int direction, bool wideCone, int eyeX, int eyeY, int eyeZ) const;
+	/// Walks tree of legacy lines from unit eyes, every step shared by many lines is tested once.
+	void propagateTilesInFOV(int size, Position posSelf, int direction, bool wideCone, FovScratch &scratch, std::vector<Position> &visibleTiles) const;
+	/// Compares result of legacy tracer with propagation and logs differences.
+	void checkFOVParity(BattleUnit *unit, Position posSelf, int direction, FovScratch &scratch, const std::vector<Position> &legacyTiles) const;
 
 	/// Calculates sun shading of the whole map.
 	void calculateSunShading(MapSubset gs);
@@ -171,6 +265,8 @@ public:
 
 	/// Calculates visible tiles within the field of view. Supply an eventPosition to do an update limited to a small slice of the view sector.
 	void calculateTilesInFOV(BattleUnit *unit, const Position eventPos = invalid, const int eventRadius = 0);
+	/// Finds all tiles in view cone seen from given eyes by selected algorithm, without changing any state.
+	void getTilesInFOV(FovEngine engine, Position posSelf, int direction, int size, std::vector<Position> &visibleTiles) const;
 	/// Calculates visible units within the field of view. Supply an eventPosition to do an update limited to a small slice of the view sector.
 	bool calculateUnitsInFOV(BattleUnit* unit, const Position eventPos = invalid, const int eventRadius = 0);
 	/// Calculates the field of view from a units view point.
@@ -198,7 +294,7 @@ public:
 	/// Closes ufo doors.
 	int closeUfoDoors();
 	/// Calculates a line trajectory in tile space.
-	int calculateLineTile(Position origin, Position target, std::vector<Position> &trajectory);
+	int calculateLineTile(Position origin, Position target, std::vector<Position> &trajectory) const;
 	/// Calculates a line trajectory in voxel space.
 	VoxelType calculateLineVoxel(Position origin, Position target, bool storeTrajectory, std::vector<Position> *trajectory, BattleUnit *excludeUnit, BattleUnit *excludeAllBut = 0, bool onlyVisible = false);
 	/// Calculates a parabola trajectory.
@@ -304,6 +400,8 @@ public:
 	bool getVisibilityCache(Position from, Position to);
 	/// checks whether there's an entry for a specific position-pair
 	bool hasEntry(Position from, Position to);
+	/// recall visibility from a specific position to another, returns false if there is no entry
+	bool tryGetVisibilityCache(Position from, Position to, bool &visible);
 	/// empties the visibility cache, call whenever a door is opened or destructive terrain is destroyed
 	void resetVisibilityCache();
 };
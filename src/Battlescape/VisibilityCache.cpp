@@ -0,0 +1,214 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "VisibilityCache.h"
+#include <algorithm>
+
+namespace OpenXcom
+{
+
+/**
+ * Creates empty cache, it need be initialized before usage.
+ */
+VisibilityCache::VisibilityCache() : _used(0), _generation(1), _mapSizeX(1), _mapSizeY(1)
+{
+
+}
+
+/**
+ * Prepares cache for a map of given size, table start with around one slot per tile.
+ * @param mapSizeX Size of map in X.
+ * @param mapSizeY Size of map in Y.
+ * @param mapSizeZ Size of map in Z.
+ */
+void VisibilityCache::init(int mapSizeX, int mapSizeY, int mapSizeZ)
+{
+	_mapSizeX = std::max(mapSizeX, 1);
+	_mapSizeY = std::max(mapSizeY, 1);
+
+	size_t capacity = MinCapacity;
+	const size_t tiles = size_t(_mapSizeX) * _mapSizeY * std::max(mapSizeZ, 1);
+	while (capacity < tiles)
+	{
+		capacity *= 2;
+	}
+	_entries.assign(capacity, Entry{ 0, 0, ES_STALE });
+	_used = 0;
+	_generation = 1;
+}
+
+/**
+ * Finds slot that is used by the key or first free slot where the key can be placed.
+ * @param key Key to find.
+ * @return Index of slot.
+ */
+size_t VisibilityCache::findSlot(Uint64 key) const
+{
+	const size_t mask = _entries.size() - 1;
+	size_t i = hashKey(key);
+	while (true)
+	{
+		const Entry& e = _entries[i];
+		if (e.generation != _generation || e.key == key)
+		{
+			return i;
+		}
+		i = (i + 1) & mask;
+	}
+}
+
+/**
+ * Doubles size of table, only valid entries are moved to new one.
+ */
+void VisibilityCache::grow()
+{
+	std::vector<Entry> old;
+	old.swap(_entries);
+	_entries.assign(old.size() * 2, Entry{ 0, 0, ES_STALE });
+	_used = 0;
+	for (const Entry& e : old)
+	{
+		if (e.generation == _generation && e.state != ES_STALE)
+		{
+			_entries[findSlot(e.key)] = e;
+			++_used;
+		}
+	}
+}
+
+/**
+ * Gets cached visibility between two tiles.
+ * @param from Index of start tile.
+ * @param to Index of end tile.
+ * @param visible Set to cached visibility when entry exists.
+ * @return True if there was valid entry.
+ */
+bool VisibilityCache::get(int from, int to, bool &visible) const
+{
+	if (_entries.empty())
+	{
+		return false;
+	}
+	const Entry& e = _entries[findSlot(makeKey(from, to))];
+	if (e.generation != _generation || e.state == ES_STALE)
+	{
+		return false;
+	}
+	visible = e.state == ES_VISIBLE;
+	return true;
+}
+
+/**
+ * Checks if there is a valid entry for this pair of tiles.
+ * @param from Index of start tile.
+ * @param to Index of end tile.
+ * @return True if there is entry.
+ */
+bool VisibilityCache::has(int from, int to) const
+{
+	bool dummy;
+	return get(from, to, dummy);
+}
+
+/**
+ * Stores visibility between two tiles. If there is already valid entry for these tiles it is left unchanged.
+ * @param from Index of start tile.
+ * @param to Index of end tile.
+ * @param visible Visibility to store.
+ */
+void VisibilityCache::set(int from, int to, bool visible)
+{
+	if (_entries.empty())
+	{
+		return;
+	}
+	if ((_used + 1) * 2 > _entries.size())
+	{
+		grow();
+	}
+
+	const Uint64 key = makeKey(from, to);
+	Entry& e = _entries[findSlot(key)];
+	if (e.generation != _generation)
+	{
+		e.key = key;
+		e.generation = _generation;
+		++_used;
+	}
+	else if (e.state != ES_STALE)
+	{
+		return;
+	}
+	e.state = visible ? ES_VISIBLE : ES_BLOCKED;
+}
+
+/**
+ * Drops entries which line could pass through the area, line never leaves bounding box of its two ends.
+ * Slots stay occupied (as stale) to not break probe chains of other keys.
+ * @param area Changed part of map, all levels.
+ */
+void VisibilityCache::invalidate(MapSubset area)
+{
+	if (!area)
+	{
+		return;
+	}
+	const int layer = _mapSizeX * _mapSizeY;
+	for (Entry& e : _entries)
+	{
+		if (e.generation != _generation || e.state == ES_STALE)
+		{
+			continue;
+		}
+		const int from = int(e.key >> 32) % layer;
+		const int to = int(e.key & 0xFFFFFFFFu) % layer;
+		const int fromX = from % _mapSizeX, fromY = from / _mapSizeX;
+		const int toX = to % _mapSizeX, toY = to / _mapSizeX;
+
+		if (std::max(fromX, toX) >= area.beg_x && std::min(fromX, toX) < area.end_x &&
+			std::max(fromY, toY) >= area.beg_y && std::min(fromY, toY) < area.end_y)
+		{
+			e.state = ES_STALE;
+		}
+	}
+}
+
+/**
+ * Drops all entries, only bump generation stamp, memory is touched only when stamp wraps around.
+ */
+void VisibilityCache::clear()
+{
+	++_generation;
+	if (_generation == 0)
+	{
+		std::fill(_entries.begin(), _entries.end(), Entry{ 0, 0, ES_STALE });
+		_generation = 1;
+	}
+	_used = 0;
+}
+
+/**
+ * Gets number of valid entries, this need scan whole table.
+ * @return Number of entries.
+ */
+size_t VisibilityCache::size() const
+{
+	return std::count_if(_entries.begin(), _entries.end(), [&](const Entry& e){ return e.generation == _generation && e.state != ES_STALE; });
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_types.h>
+#include "../Engine/GraphSubset.h"
+
+namespace OpenXcom
+{
+
+class Position;
+
+/**
+ * Define some part of map
+ */
+using MapSubset = AreaSubset<Position, Sint16>;
+
+/**
+ * Cache of tile to tile line of sight results used by the AI.
+ * Open addressed hash table keyed on pair of tile indexes, every entry is stamped
+ * with generation number, this allow dropping whole cache without touching memory.
+ * Terrain changes can invalidate only entries which line could cross changed area.
+ */
+class VisibilityCache
+{
+	/// State of single entry in table.
+	enum EntryState : Uint8
+	{
+		ES_STALE = 0,
+		ES_BLOCKED = 1,
+		ES_VISIBLE = 2,
+	};
+
+	/**
+	 * Single slot in hash table.
+	 */
+	struct Entry
+	{
+		Uint64 key;
+		Uint32 generation;
+		EntryState state;
+	};
+
+	/// Minimal number of slots in table.
+	static constexpr size_t MinCapacity = 1024;
+
+	std::vector<Entry> _entries;
+	size_t _used;
+	Uint32 _generation;
+	int _mapSizeX, _mapSizeY;
+
+	/// Create key from pair of tile indexes.
+	static Uint64 makeKey(int from, int to) { return (Uint64(Uint32(from)) << 32) | Uint32(to); }
+	/// Calculate start slot of key.
+	size_t hashKey(Uint64 key) const { return size_t((key * 0x9E3779B97F4A7C15ull) >> 32) & (_entries.size() - 1); }
+	/// Find slot used by key or first free slot.
+	size_t findSlot(Uint64 key) const;
+	/// Increase size of table.
+	void grow();
+
+public:
+	/// Creates empty cache.
+	VisibilityCache();
+
+	/// Prepare cache for map of given size.
+	void init(int mapSizeX, int mapSizeY, int mapSizeZ);
+	/// Gets cached visibility, return false if there is no entry for this pair of tiles.
+	bool get(int from, int to, bool &visible) const;
+	/// Checks if there is entry for this pair of tiles.
+	bool has(int from, int to) const;
+	/// Stores visibility, existing entries are not overridden.
+	void set(int from, int to, bool visible);
+	/// Drops all entries which line could pass through given area of map.
+	void invalidate(MapSubset area);
+	/// Drops all entries.
+	void clear();
+	/// Number of valid entries.
+	size_t size() const;
+};
+
+}
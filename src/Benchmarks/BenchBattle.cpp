@@ -0,0 +1,266 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+#include "BenchBattle.h"
+#include "../Battlescape/BattlescapeGame.h"
+#include "../Battlescape/Pathfinding.h"
+#include "../Battlescape/PathfindingNode.h"
+#include "../Battlescape/TileEngine.h"
+#include "../Engine/Logger.h"
+#include "../Mod/AlienRace.h"
+#include "../Mod/MapData.h"
+#include "../Mod/MapDataSet.h"
+#include "../Mod/Mod.h"
+#include "../Mod/RuleTerrain.h"
+#include "../Mod/Unit.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/**
+ * Generated battle map, floor on ground level with random walls and objects,
+ * few player units spread over map. Created once and shared by all battle benchmarks.
+ */
+struct BattleFixture
+{
+	static constexpr int MapSize = 60;
+	static constexpr int MapHeight = 4;
+
+	std::unique_ptr<SavedBattleGame> save;
+	std::vector<BattleUnit*> units;
+
+	bool build(Mod* mod, Language* lang);
+};
+
+BattleFixture battle;
+
+/**
+ * Builds map from first terrain of mod.
+ * @return False when mod do not have needed terrain or units.
+ */
+bool BattleFixture::build(Mod* mod, Language* lang)
+{
+	if (mod->getTerrainList().empty() || mod->getAlienRacesList().empty())
+	{
+		return false;
+	}
+	RuleTerrain* terrain = mod->getTerrain(mod->getTerrainList().front());
+	if (terrain->getMapDataSets()->empty())
+	{
+		return false;
+	}
+	MapDataSet* mds = terrain->getMapDataSets()->front();
+	mds->loadData(mod->getMCDPatch(mds->getName()));
+
+	MapData* parts[O_MAX] = { };
+	int ids[O_MAX] = { };
+	for (size_t i = 1; i < mds->getSize(); ++i)
+	{
+		MapData* dat = mds->getObject(i);
+		const TilePart part = dat->getObjectType();
+		if (parts[part] == nullptr && (part != O_FLOOR || !dat->isNoFloor()) && (part == O_FLOOR || dat->getBigWall() == 0))
+		{
+			parts[part] = dat;
+			ids[part] = (int)i;
+		}
+	}
+	if (parts[O_FLOOR] == nullptr)
+	{
+		return false;
+	}
+
+	save = std::make_unique<SavedBattleGame>(mod, lang);
+	save->initMap(MapSize, MapSize, MapHeight);
+	save->getMapDataSets().push_back(mds);
+
+	std::mt19937 rng(42);
+	for (int x = 0; x < MapSize; ++x)
+	{
+		for (int y = 0; y < MapSize; ++y)
+		{
+			Tile* tile = save->getTile(Position(x, y, 0));
+			tile->setMapData(parts[O_FLOOR], ids[O_FLOOR], 0, O_FLOOR);
+			// walls are on 1/6 of tiles, objects on 1/20, like in city maps
+			for (TilePart part : { O_WESTWALL, O_NORTHWALL })
+			{
+				if (parts[part] && rng() % 12 == 0)
+				{
+					tile->setMapData(parts[part], ids[part], 0, part);
+				}
+			}
+			if (parts[O_OBJECT] && rng() % 20 == 0)
+			{
+				tile->setMapData(parts[O_OBJECT], ids[O_OBJECT], 0, O_OBJECT);
+			}
+			for (int z = 0; z < MapHeight; ++z)
+			{
+				save->getTile(Position(x, y, z))->setDiscovered(true, O_FLOOR);
+			}
+		}
+	}
+	save->initUtilities(mod);
+
+	Unit* unitRule = mod->getUnit(mod->getAlienRace(mod->getAlienRacesList().front())->getMember(0));
+	if (unitRule == nullptr)
+	{
+		return false;
+	}
+	for (int i = 0; i < 8; ++i)
+	{
+		BattleUnit* unit = save->createTempUnit(unitRule, FACTION_PLAYER, i + 1);
+		save->getUnits().push_back(unit);
+		int tries = 100;
+		while (!save->setUnitPosition(unit, Position(rng() % MapSize, rng() % MapSize, 0)))
+		{
+			if (--tries == 0)
+			{
+				return false;
+			}
+		}
+		units.push_back(unit);
+	}
+	save->setSelectedUnit(units.front());
+	save->getTileEngine()->calculateLighting(LL_AMBIENT, TileEngine::invalid, 0, true);
+	return true;
+}
+
+/// Paths from unit to random places on map, arg is max TU cost.
+void BM_PathfindingAStar(benchmark::State& state)
+{
+	BattleUnit* unit = battle.units.front();
+	const Position start = unit->getPosition();
+	std::mt19937 rng(7);
+	std::vector<Position> targets(64);
+	for (auto& target : targets)
+	{
+		target = Position(rng() % BattleFixture::MapSize, rng() % BattleFixture::MapSize, 0);
+	}
+
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		battle.save->getPathfinding()->calculate(unit, start, targets[i++ % targets.size()], BAM_NORMAL, nullptr, state.range(0));
+		benchmark::DoNotOptimize(battle.save->getPathfinding()->getPath().size());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PathfindingReachable(benchmark::State& state)
+{
+	BattleUnit* unit = battle.units.front();
+	for (auto _ : state)
+	{
+		bool ranOut = false;
+		auto nodes = battle.save->getPathfinding()->findReachablePathFindingNodes(unit, BattleActionCost(unit), ranOut, state.range(0) != 0);
+		benchmark::DoNotOptimize(nodes.size());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+void BM_TileEngineFOV(benchmark::State& state)
+{
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(battle.save->getTileEngine()->calculateFOV(battle.units[i++ % battle.units.size()]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+/// Lines from eyes of each unit to every other unit, like reaction fire checks.
+void BM_TileEngineLineVoxel(benchmark::State& state)
+{
+	TileEngine* tileEngine = battle.save->getTileEngine();
+	int64_t lines = 0;
+	for (auto _ : state)
+	{
+		for (auto* from : battle.units)
+		{
+			for (auto* to : battle.units)
+			{
+				if (from == to)
+				{
+					continue;
+				}
+				const Position origin = from->getPosition().toVoxel() + Position(8, 8, from->getHeight());
+				const Position target = to->getPosition().toVoxel() + Position(8, 8, to->getHeight() / 2);
+				benchmark::DoNotOptimize(tileEngine->calculateLineVoxel(origin, target, false, nullptr, from));
+				++lines;
+			}
+		}
+	}
+	state.SetItemsProcessed(lines);
+}
+
+void BM_TileEngineVoxelCheck(benchmark::State& state)
+{
+	TileEngine* tileEngine = battle.save->getTileEngine();
+	std::mt19937 rng(11);
+	std::vector<Position> voxels(4096);
+	for (auto& voxel : voxels)
+	{
+		voxel = Position(rng() % (BattleFixture::MapSize * 16), rng() % (BattleFixture::MapSize * 16), rng() % 48);
+	}
+
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(tileEngine->voxelCheck(voxels[i++ % voxels.size()], nullptr));
+	}
+	tileEngine->voxelCheckFlush();
+	state.SetItemsProcessed(state.iterations());
+}
+
+/// Full recalculation of lighting layer, arg is `LightLayers` value.
+void BM_TileEngineLighting(benchmark::State& state)
+{
+	const LightLayers layer = (LightLayers)state.range(0);
+	for (auto _ : state)
+	{
+		battle.save->getTileEngine()->calculateLighting(layer, TileEngine::invalid, 0, layer == LL_AMBIENT);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+/**
+ * Builds battle map from loaded mod and registers benchmarks that use it.
+ * @param mod Loaded mod.
+ * @param lang Loaded language.
+ * @return False when map can't be build and benchmarks are skipped.
+ */
+bool registerBattleBenchmarks(Mod* mod, Language* lang)
+{
+	if (!battle.build(mod, lang))
+	{
+		Log(LOG_WARNING) << "Mod do not have terrain or units for battle benchmarks, skipping them.";
+		return false;
+	}
+	benchmark::RegisterBenchmark("BM_PathfindingAStar", BM_PathfindingAStar)->Arg(100)->Arg(1000);
+	benchmark::RegisterBenchmark("BM_PathfindingReachable", BM_PathfindingReachable)->Arg(0)->Arg(1);
+	benchmark::RegisterBenchmark("BM_TileEngineFOV", BM_TileEngineFOV);
+	benchmark::RegisterBenchmark("BM_TileEngineLineVoxel", BM_TileEngineLineVoxel);
+	benchmark::RegisterBenchmark("BM_TileEngineVoxelCheck", BM_TileEngineVoxelCheck);
+	benchmark::RegisterBenchmark("BM_TileEngineLighting", BM_TileEngineLighting)->Arg(LL_AMBIENT)->Arg(LL_UNITS);
+	return true;
+}
+
+/**
+ * Frees battle map, need to be done before mod is destroyed.
+ */
+void clearBattleBenchmarks()
+{
+	battle.units.clear();
+	battle.save.reset();
+}
+
+}
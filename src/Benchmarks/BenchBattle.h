@@ -0,0 +1,14 @@
+#pragma once
+
+namespace OpenXcom
+{
+
+class Mod;
+class Language;
+
+/// Registers benchmarks that need battle map build from loaded game data.
+bool registerBattleBenchmarks(Mod* mod, Language* lang);
+/// Frees battle map used by benchmarks.
+void clearBattleBenchmarks();
+
+}
@@ -0,0 +1,279 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <list>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include "../Engine/BlitKernels.h"
+#include "../Engine/Script.h"
+#include "../Engine/ShaderDraw.h"
+#include "../Engine/ShaderMove.h"
+#include "../Engine/SurfaceSpans.h"
+#include "../Mod/Polygon.h"
+#include "../Mod/PolygonIndex.h"
+#include "../Savegame/BinarySave.h"
+#include "../fmath.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/// Sprite similar to unit sprites, transparent border and some holes.
+std::vector<Uint8> makeSprite(int width, int height)
+{
+	std::mt19937 rng(1234);
+	std::vector<Uint8> pixels(width * height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const bool inside = x > width / 4 && x < width - width / 4 && (rng() % 8);
+			pixels[y * width + x] = inside ? (Uint8)(rng() % 256) : 0;
+		}
+	}
+	return pixels;
+}
+
+/// Fixture with screen sized destination and battlescape sized sprite.
+struct BlitFixture
+{
+	static constexpr int SpriteWidth = 32, SpriteHeight = 40;
+	static constexpr int DestWidth = 320, DestHeight = 200;
+
+	std::vector<Uint8> sprite = makeSprite(SpriteWidth, SpriteHeight);
+	std::vector<Uint8> dest = std::vector<Uint8>(DestWidth * DestHeight, 1);
+	SurfaceRaw<const Uint8> src{ sprite, SpriteWidth, SpriteHeight };
+	SurfaceSpans spans{ src };
+	GraphSubset area{ DestWidth, DestHeight };
+
+	SurfaceRaw<Uint8> getDest() { return SurfaceRaw<Uint8>(dest, DestWidth, DestHeight); }
+};
+
+/// Blits sprite over whole screen, arg is one of three drawing paths.
+void BM_BlitShade(benchmark::State& state)
+{
+	BlitFixture f;
+	const int path = state.range(0);
+	const int shade = 5;
+	auto rowFunc = [&](Uint8* d, const Uint8* s, int size){ BlitKernels::shadeRow(d, s, size, shade); };
+	int64_t blits = 0;
+	for (auto _ : state)
+	{
+		for (int y = -10; y < BlitFixture::DestHeight; y += BlitFixture::SpriteHeight / 2)
+		{
+			for (int x = -10; x < BlitFixture::DestWidth; x += BlitFixture::SpriteWidth / 2)
+			{
+				if (path == 0)
+				{
+					ShaderMove<Uint8> dest(f.getDest());
+					ShaderDraw<helper::StandardShade>(dest, ShaderMove<const Uint8>(f.src, x, y), ShaderScalar(shade));
+				}
+				else if (path == 1)
+				{
+					BlitKernels::drawRows(f.getDest(), f.src, x, y, f.area, rowFunc);
+				}
+				else
+				{
+					f.spans.drawRows(f.getDest(), f.src, x, y, f.area, rowFunc);
+				}
+				++blits;
+			}
+		}
+		benchmark::DoNotOptimize(f.dest.data());
+	}
+	state.SetItemsProcessed(blits);
+	state.SetLabel(path == 0 ? "ShaderDraw" : path == 1 ? "kernels" : "spans");
+}
+BENCHMARK(BM_BlitShade)->Arg(0)->Arg(1)->Arg(2);
+
+struct BenchScriptParser : ScriptParser<ScriptOutputArgs<int&>, int>
+{
+	BenchScriptParser(ScriptGlobal* shared) : ScriptParser(shared, "bench", "result", "input")
+	{
+	}
+};
+
+/// Runs script with arithmetic and branches similar to mod damage and recolor scripts.
+void BM_ScriptExecute(benchmark::State& state)
+{
+	ScriptGlobal global;
+	BenchScriptParser parser(&global);
+	BenchScriptParser::Container script;
+	script.load("bench",
+		"var int x; var int y 3;"
+		"set x input; mul x 7; add x y; mod x 13;"
+		"if lt x 5; add y x; else gt x 10; sub y x; else; mul y 2; end;"
+		"limit x 0 8; add x y; muldiv x 100 7;"
+		"if eq input 0; return 0; end;"
+		"return x;",
+		parser);
+
+	int input = 0;
+	for (auto _ : state)
+	{
+		BenchScriptParser::Output output{ 0 };
+		BenchScriptParser::Worker worker{ input++ & 0xFF };
+		worker.execute(script, output);
+		benchmark::DoNotOptimize(output.getFirst());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScriptExecute);
+
+/// Random land masses that cover part of globe, like polygons of real globe.
+struct GlobeFixture
+{
+	std::list<Polygon*> polygons;
+	PolygonIndex index;
+
+	GlobeFixture()
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<double> lonDist(0, 360), latDist(-80, 80), sizeDist(2, 10);
+		for (int i = 0; i < 1000; ++i)
+		{
+			const double lon = lonDist(rng), lat = latDist(rng), w = sizeDist(rng), h = sizeDist(rng);
+			auto* polygon = new Polygon(4);
+			const double points[] = { lon, lat, lon + w, lat, lon + w, lat + h, lon, lat + h };
+			for (int j = 0; j < 4; ++j)
+			{
+				polygon->setLongitude(j, Deg2Rad(points[j * 2]));
+				polygon->setLatitude(j, Deg2Rad(points[j * 2 + 1]));
+			}
+			polygon->setTexture(i % 13);
+			polygons.push_back(polygon);
+		}
+		index.build(polygons);
+	}
+
+	~GlobeFixture()
+	{
+		for (auto* polygon : polygons)
+		{
+			delete polygon;
+		}
+	}
+};
+
+/// Same lookup as `Globe::getPolygonFromLonLat`.
+void BM_GlobePolygonFromLonLat(benchmark::State& state)
+{
+	GlobeFixture f;
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<double> lonDist(0, 2 * M_PI), latDist(-M_PI_2, M_PI_2);
+	std::vector<std::pair<double, double>> points(4096);
+	for (auto& p : points)
+	{
+		p = std::make_pair(lonDist(rng), latDist(rng));
+	}
+
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		const auto& p = points[i++ % points.size()];
+		benchmark::DoNotOptimize(f.index.find(p.first, p.second));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GlobePolygonFromLonLat);
+
+/// Ruleset text with given number of items, shaped like items in `Ruleset/items_XCOM1.rul`.
+std::string makeRuleset(int items)
+{
+	std::ostringstream ss;
+	ss << "items:\n";
+	for (int i = 0; i < items; ++i)
+	{
+		ss << "  - type: STR_BENCH_ITEM_" << i << "\n"
+			<< "    size: 0.1\n"
+			<< "    costBuy: " << 1000 + i << "\n"
+			<< "    weight: " << i % 20 << "\n"
+			<< "    bigSprite: " << i % 60 << "\n"
+			<< "    floorSprite: " << i % 70 << "\n"
+			<< "    handSprite: " << (i % 30) * 8 << "\n"
+			<< "    power: " << 20 + i % 100 << "\n"
+			<< "    damageType: 1\n"
+			<< "    compatibleAmmo:\n      - STR_BENCH_AMMO_" << i << "\n"
+			<< "    accuracySnap: 60\n    accuracyAimed: 110\n    tuSnap: 25\n    tuAimed: 80\n"
+			<< "    battleType: 1\n    twoHanded: " << (i % 2 ? "true" : "false") << "\n"
+			<< "    invWidth: 1\n    invHeight: 3\n"
+			<< "    tags:\n      BENCH_TAG: " << i << "\n";
+	}
+	return ss.str();
+}
+
+/// Savegame document with given number of soldiers, shaped like real saves.
+YAML::Node makeSave(int soldiers)
+{
+	YAML::Node doc;
+	doc["difficulty"] = 2;
+	doc["funds"].push_back(1000000);
+	YAML::Node base;
+	base["name"] = "Bench Base";
+	base["lon"] = 1.5;
+	base["lat"] = -0.5;
+	for (int i = 0; i < soldiers; ++i)
+	{
+		YAML::Node soldier;
+		soldier["type"] = "STR_SOLDIER";
+		soldier["id"] = i;
+		soldier["name"] = "Soldier " + std::to_string(i);
+		soldier["rank"] = i % 6;
+		YAML::Node stats;
+		for (const char* stat : { "tu", "stamina", "health", "bravery", "reactions", "firing", "throwing", "strength", "psiStrength", "psiSkill", "melee", "mana" })
+		{
+			stats[stat] = 40 + (i * 7) % 30;
+		}
+		soldier["initialStats"] = stats;
+		soldier["currentStats"] = stats;
+		soldier["missions"] = i % 20;
+		soldier["kills"] = i % 50;
+		base["soldiers"].push_back(soldier);
+	}
+	doc["bases"].push_back(base);
+	return doc;
+}
+
+/// Parses ruleset text only, whole loading of rules by `Mod` is measured by BM_ModLoadAll.
+void BM_YamlRulesetParse(benchmark::State& state)
+{
+	const std::string text = makeRuleset(state.range(0));
+	for (auto _ : state)
+	{
+		YAML::Node doc = YAML::Load(text);
+		benchmark::DoNotOptimize(doc);
+	}
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_YamlRulesetParse)->Arg(100)->Arg(1000);
+
+/// Reads save file into node tree, arg select YAML (0) or binary (1) format. Building game from it is measured by BM_SavedGameLoad.
+void BM_SaveLoad(benchmark::State& state)
+{
+	const bool binary = state.range(0) != 0;
+	const std::string path = binary ? "bench_binary.sav" : "bench_yaml.sav";
+	const YAML::Node brief = YAML::Load("name: bench\nversion: \"8.0\"\nmods: [xcom1]\n");
+	if (binary)
+	{
+		BinarySave::save(path, brief, makeSave(500), false);
+	}
+	else
+	{
+		BinarySave::saveYaml(path, brief, makeSave(500));
+	}
+
+	for (auto _ : state)
+	{
+		YAML::Node loadedBrief, loadedDoc;
+		BinarySave::loadAny(path, loadedBrief, loadedDoc);
+		benchmark::DoNotOptimize(loadedDoc);
+	}
+	state.SetLabel(binary ? "binary" : "yaml");
+	std::remove(path.c_str());
+}
+BENCHMARK(BM_SaveLoad)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}
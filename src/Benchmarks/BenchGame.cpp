@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <yaml-cpp/yaml.h>
+#include "BenchGame.h"
+#include "../Engine/Options.h"
+#include "../Engine/Registry.h"
+#include "../Mod/Mod.h"
+#include "../Mod/ModFile.h"
+#include "../Savegame/BinarySave.h"
+#include "../Savegame/SavedGame.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+Mod* gameMod = nullptr;
+Language* gameLang = nullptr;
+
+/**
+ * Loads all rulesets of enabled mods same way as `Game::loadMods()`, vanilla resources included.
+ * Arg select if ruleset cache is used (1) or not (0), cache is created before first measured load.
+ */
+void BM_ModLoadAll(benchmark::State& state)
+{
+	const bool oldCache = Options::oxceRulesetCache;
+	Options::oxceRulesetCache = state.range(0) != 0;
+
+	ModFile modFiles;
+	modFiles.loadAll();
+	if (Options::oxceRulesetCache)
+	{
+		Mod mod(modFiles);
+		mod.loadAll();
+	}
+
+	for (auto _ : state)
+	{
+		Mod mod(modFiles);
+		mod.loadAll();
+		benchmark::DoNotOptimize(mod.getItemsList().size());
+	}
+	state.SetLabel(Options::oxceRulesetCache ? "cache" : "yaml");
+	Options::oxceRulesetCache = oldCache;
+}
+
+/**
+ * Loads new game of current mod by `SavedGame::load`, arg is value of `oxceBinarySaves` used to save it.
+ * Entities created by load are removed after every iteration, so every load start from empty registry.
+ */
+void BM_SavedGameLoad(benchmark::State& state)
+{
+	const int oldFormat = Options::oxceBinarySaves;
+	Options::oxceBinarySaves = (int)state.range(0);
+	const std::string filename = "bench_game.sav";
+	{
+		std::unique_ptr<SavedGame> save(gameMod->newSave(DIFF_BEGINNER));
+		save->save(filename, gameMod);
+	}
+	getRegistry().raw().clear();
+	Options::oxceBinarySaves = oldFormat;
+
+	for (auto _ : state)
+	{
+		auto loaded = std::make_unique<SavedGame>();
+		YAML::Node doc;
+		loaded->load(filename, gameMod, gameLang, doc);
+		benchmark::DoNotOptimize(loaded->getMonthsPassed());
+
+		state.PauseTiming();
+		loaded.reset();
+		getRegistry().raw().clear();
+		state.ResumeTiming();
+	}
+	state.SetLabel(state.range(0) == BinarySave::SF_YAML ? "yaml" : state.range(0) == BinarySave::SF_BINARY ? "binary" : "compressed");
+	std::remove((Options::getMasterUserFolder() + filename).c_str());
+}
+
+}
+
+/**
+ * Registers benchmarks that load rulesets and saves of current mod.
+ * @param mod Loaded mod.
+ * @param lang Loaded language.
+ */
+void registerGameBenchmarks(Mod* mod, Language* lang)
+{
+	gameMod = mod;
+	gameLang = lang;
+	benchmark::RegisterBenchmark("BM_ModLoadAll", BM_ModLoadAll)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("BM_SavedGameLoad", BM_SavedGameLoad)->Arg(BinarySave::SF_YAML)->Arg(BinarySave::SF_BINARY)->Arg(BinarySave::SF_BINARY_COMPRESSED)->Unit(benchmark::kMillisecond);
+}
+
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace OpenXcom
+{
+
+class Mod;
+class Language;
+
+/// Registers benchmarks of ruleset and savegame loading that need loaded game data.
+void registerGameBenchmarks(Mod* mod, Language* lang);
+
+}
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <exception>
+#include <sstream>
+#include <SDL.h>
+#include "BenchBattle.h"
+#include "BenchGame.h"
+#include "../version.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/FileMap.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+
+/**
+ * Microbenchmarks of engine hot paths.
+ *
+ * Usage: openxcom_bench [--benchmark_...]... [OPTION]...
+ * Benchmark options are same as for Google Benchmark, results can be saved to JSON with
+ * `--benchmark_out=FILE --benchmark_out_format=json`. Other options are same as for the game
+ * itself (-data, -user, -KEY VALUE) and select game data used by battle and loading benchmarks.
+ * When game data can't be loaded only benchmarks that do not need it are run.
+ */
+
+using namespace OpenXcom;
+
+int main(int argc, char *argv[])
+{
+	benchmark::Initialize(&argc, argv);
+	CrossPlatform::processArgs(argc, argv);
+
+	if (!Options::init())
+		return EXIT_SUCCESS;
+
+	// nothing is ever shown or played
+	SDL_putenv((char *)"SDL_VIDEODRIVER=dummy");
+	SDL_putenv((char *)"SDL_AUDIODRIVER=dummy");
+	Options::useOpenGL = false;
+	Options::fullscreen = false;
+
+	Game *game = 0;
+	try
+	{
+		std::ostringstream title;
+		title << "OpenXcom " << OPENXCOM_VERSION_SHORT << OPENXCOM_VERSION_GIT;
+		game = new Game(title.str());
+		Options::mute = true;
+
+		Options::updateMods();
+		game->loadMods();
+		game->loadLanguages();
+
+		registerGameBenchmarks(game->getMod(), game->getLanguage());
+		registerBattleBenchmarks(game->getMod(), game->getLanguage());
+	}
+	catch (const std::exception &e)
+	{
+		Log(LOG_WARNING) << "Game data not loaded, loading and battle benchmarks are skipped: " << e.what();
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+
+	clearBattleBenchmarks();
+	delete game;
+	FileMap::clear(true, false);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BlitKernels.h"
+#include <algorithm>
+#include "ShaderDraw.h"
+
+#if (_MSC_VER >= 1400) && (defined(_M_X64) || _M_IX86_FP >= 2)
+#ifndef __SSE2__
+#define __SSE2__ true
+#endif
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// AVX2 code is compiled for selected functions only and used when CPU report support for it
+#if defined(__SSE2__) && defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define OXCE_BLIT_AVX2
+#define OXCE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif (_MSC_VER >= 1700) && defined(_M_X64)
+#define OXCE_BLIT_AVX2
+#define OXCE_TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace OpenXcom
+{
+
+namespace BlitKernels
+{
+
+namespace
+{
+
+using ShadeFunc = void (*)(Uint8* dest, const Uint8* src, int size, int shade);
+using ReplaceFunc = void (*)(Uint8* dest, const Uint8* src, int size, int shade, int newColor);
+
+void shadeRowScalar(Uint8* dest, const Uint8* src, int size, int shade)
+{
+	for (int i = 0; i < size; ++i)
+	{
+		helper::StandardShade::func(dest[i], src[i], shade);
+	}
+}
+
+void replaceRowScalar(Uint8* dest, const Uint8* src, int size, int shade, int newColor)
+{
+	for (int i = 0; i < size; ++i)
+	{
+		helper::ColorReplace::func(dest[i], src[i], shade, newColor);
+	}
+}
+
+#ifdef __SSE2__
+
+/// Picks a where mask is set and b otherwise.
+inline __m128i select128(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+void shadeRowSSE2(Uint8* dest, const Uint8* src, int size, int shade)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i group = _mm_set1_epi8((char)helper::ColorGroup);
+	const __m128i black = _mm_set1_epi8((char)helper::ColorShade);
+	const __m128i add = _mm_set1_epi8((char)shade);
+	int i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		const __m128i n = _mm_add_epi8(s, add);
+		const __m128i sameGroup = _mm_cmpeq_epi8(_mm_and_si128(_mm_xor_si128(n, s), group), zero);
+		const __m128i transparent = _mm_cmpeq_epi8(s, zero);
+		_mm_storeu_si128((__m128i*)(dest + i), select128(transparent, d, select128(sameGroup, n, black)));
+	}
+	shadeRowScalar(dest + i, src + i, size - i, shade);
+}
+
+void replaceRowSSE2(Uint8* dest, const Uint8* src, int size, int shade, int newColor)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i group = _mm_set1_epi8((char)helper::ColorGroup);
+	const __m128i black = _mm_set1_epi8((char)helper::ColorShade);
+	const __m128i add = _mm_set1_epi8((char)shade);
+	const __m128i color = _mm_set1_epi8((char)newColor);
+	int i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		const __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+		const __m128i n = _mm_add_epi8(_mm_and_si128(s, black), add);
+		const __m128i sameGroup = _mm_cmpeq_epi8(_mm_and_si128(n, group), zero);
+		const __m128i transparent = _mm_cmpeq_epi8(s, zero);
+		_mm_storeu_si128((__m128i*)(dest + i), select128(transparent, d, select128(sameGroup, _mm_or_si128(n, color), black)));
+	}
+	replaceRowScalar(dest + i, src + i, size - i, shade, newColor);
+}
+
+#endif
+
+#ifdef OXCE_BLIT_AVX2
+
+OXCE_TARGET_AVX2 void shadeRowAVX2(Uint8* dest, const Uint8* src, int size, int shade)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i group = _mm256_set1_epi8((char)helper::ColorGroup);
+	const __m256i black = _mm256_set1_epi8((char)helper::ColorShade);
+	const __m256i add = _mm256_set1_epi8((char)shade);
+	int i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+		const __m256i n = _mm256_add_epi8(s, add);
+		const __m256i sameGroup = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_xor_si256(n, s), group), zero);
+		const __m256i transparent = _mm256_cmpeq_epi8(s, zero);
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_blendv_epi8(_mm256_blendv_epi8(black, n, sameGroup), d, transparent));
+	}
+	// upper halves of registers need to be cleared before SSE code, otherwise every SSE instruction is very slow
+	_mm256_zeroupper();
+	shadeRowSSE2(dest + i, src + i, size - i, shade);
+}
+
+OXCE_TARGET_AVX2 void replaceRowAVX2(Uint8* dest, const Uint8* src, int size, int shade, int newColor)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i group = _mm256_set1_epi8((char)helper::ColorGroup);
+	const __m256i black = _mm256_set1_epi8((char)helper::ColorShade);
+	const __m256i add = _mm256_set1_epi8((char)shade);
+	const __m256i color = _mm256_set1_epi8((char)newColor);
+	int i = 0;
+	for (; i + 32 <= size; i += 32)
+	{
+		const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+		const __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+		const __m256i n = _mm256_add_epi8(_mm256_and_si256(s, black), add);
+		const __m256i sameGroup = _mm256_cmpeq_epi8(_mm256_and_si256(n, group), zero);
+		const __m256i transparent = _mm256_cmpeq_epi8(s, zero);
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_blendv_epi8(_mm256_blendv_epi8(black, _mm256_or_si256(n, color), sameGroup), d, transparent));
+	}
+	_mm256_zeroupper();
+	replaceRowSSE2(dest + i, src + i, size - i, shade, newColor);
+}
+
+/**
+ * Checks if CPU and OS support AVX2 instructions.
+ */
+bool haveAVX2()
+{
+#ifdef __GNUC__
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	int CPUInfo[4];
+	__cpuid(CPUInfo, 0);
+	if (CPUInfo[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(CPUInfo, 1);
+	// OSXSAVE and AVX bits, then check that OS save YMM registers
+	if ((CPUInfo[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+	__cpuidex(CPUInfo, 7, 0);
+	return (CPUInfo[1] & 0x20) ? true : false;
+#endif
+}
+
+#endif
+
+/// Kernels selected for current level.
+struct Kernels
+{
+	Level level;
+	ShadeFunc shade;
+	ReplaceFunc replace;
+};
+
+Kernels makeKernels(Level level)
+{
+	switch (level)
+	{
+#ifdef OXCE_BLIT_AVX2
+	case BK_AVX2:
+		return { BK_AVX2, &shadeRowAVX2, &replaceRowAVX2 };
+#endif
+#ifdef __SSE2__
+	case BK_SSE2:
+		return { BK_SSE2, &shadeRowSSE2, &replaceRowSSE2 };
+#endif
+	default:
+		return { BK_SCALAR, &shadeRowScalar, &replaceRowScalar };
+	}
+}
+
+Kernels& current()
+{
+	static Kernels kernels = makeKernels(getBestLevel());
+	return kernels;
+}
+
+}
+
+/**
+ * Gets implementation used by kernels.
+ * @return Current level.
+ */
+Level getLevel()
+{
+	return current().level;
+}
+
+/**
+ * Checks CPU features once, SSE2 is always available when compiler is allowed to use it.
+ * @return Best level that can be used.
+ */
+Level getBestLevel()
+{
+#ifdef OXCE_BLIT_AVX2
+	static const bool avx2 = haveAVX2();
+	if (avx2)
+	{
+		return BK_AVX2;
+	}
+#endif
+#ifdef __SSE2__
+	return BK_SSE2;
+#else
+	return BK_SCALAR;
+#endif
+}
+
+/**
+ * Selects implementation of kernels, mainly for testing. Not thread safe, should not be called while drawing.
+ * @param level Wanted level.
+ * @return Level that was selected.
+ */
+Level setLevel(Level level)
+{
+	current() = makeKernels(std::min(level, getBestLevel()));
+	return current().level;
+}
+
+/**
+ * Shades row of pixels, transparent source pixels are skipped.
+ * @param dest Destination pixels.
+ * @param src Source pixels.
+ * @param size Number of pixels.
+ * @param shade Shade offset.
+ */
+void shadeRow(Uint8* dest, const Uint8* src, int size, int shade)
+{
+	current().shade(dest, src, size, shade);
+}
+
+/**
+ * Shades row of pixels and moves them to new color group, transparent source pixels are skipped.
+ * @param dest Destination pixels.
+ * @param src Source pixels.
+ * @param size Number of pixels.
+ * @param shade Shade offset.
+ * @param newColor New color group, already shifted by 4 bits.
+ */
+void replaceRow(Uint8* dest, const Uint8* src, int size, int shade, int newColor)
+{
+	current().replace(dest, src, size, shade, newColor);
+}
+
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL_types.h>
+#include "GraphSubset.h"
+#include "Surface.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Row kernels for most common 8-bit blits, same results as `helper::StandardShade`
+ * and `helper::ColorReplace` but processing 16 or 32 pixels at once.
+ * Transparent source pixels keep destination unchanged.
+ * Best implementation supported by CPU is selected on first use.
+ */
+namespace BlitKernels
+{
+
+/// Implementations of kernels.
+enum Level { BK_SCALAR, BK_SSE2, BK_AVX2 };
+
+/// Gets implementation currently in use.
+Level getLevel();
+/// Gets best implementation supported by CPU and this build.
+Level getBestLevel();
+/// Selects implementation, levels not supported are lowered to best one.
+Level setLevel(Level level);
+
+/// Shades row of pixels like `helper::StandardShade`.
+void shadeRow(Uint8* dest, const Uint8* src, int size, int shade);
+/// Shades row of pixels and replaces color group like `helper::ColorReplace`, `newColor` is already shifted to color group bits.
+void replaceRow(Uint8* dest, const Uint8* src, int size, int shade, int newColor);
+
+/**
+ * Calls rowFunc for every row of source that land inside of area of destination.
+ * @param dest Destination surface.
+ * @param src Source surface.
+ * @param x X position of source in destination.
+ * @param y Y position of source in destination.
+ * @param area Part of destination that can be changed.
+ * @param rowFunc Function called with destination row, source row and number of pixels.
+ */
+template<typename Func>
+void drawRows(SurfaceRaw<Uint8> dest, SurfaceRaw<const Uint8> src, int x, int y, GraphSubset area, Func&& rowFunc)
+{
+	area = GraphSubset::intersection(area, GraphSubset{ dest.getWidth(), dest.getHeight() }, GraphSubset{ src.getWidth(), src.getHeight() }.offset(x, y));
+	if (area.size_x() <= 0 || area.size_y() <= 0)
+	{
+		return;
+	}
+	for (int destY = area.beg_y; destY < area.end_y; ++destY)
+	{
+		const Uint8* srcRow = (const Uint8*)((const char*)src.getBuffer() + (destY - y) * src.getPitch());
+		Uint8* destRow = (Uint8*)((char*)dest.getBuffer() + destY * dest.getPitch());
+		rowFunc(destRow + area.beg_x, srcRow + (area.beg_x - x), area.size_x());
+	}
+}
+
+}
+
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "DirtyGrid.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates grid that cover nothing.
+ */
+DirtyGrid::DirtyGrid() : _width(0), _height(0), _cols(0), _rows(0), _dirtyCells(0), _all(true)
+{
+
+}
+
+/**
+ * Changes size of covered area, as old content is meaningless whole area is dirty.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ */
+void DirtyGrid::resize(int width, int height)
+{
+	_width = std::max(width, 0);
+	_height = std::max(height, 0);
+	_cols = (_width + CellSize - 1) / CellSize;
+	_rows = (_height + CellSize - 1) / CellSize;
+	_cells.assign(_cols * _rows, 0);
+	_dirtyCells = 0;
+	_all = true;
+}
+
+/**
+ * Marks whole area as dirty, cells are not touched as everything will be cleared anyway.
+ */
+void DirtyGrid::invalidateAll()
+{
+	_all = true;
+}
+
+/**
+ * Marks every cell that have any pixel in area as dirty.
+ * @param area Area in pixels, parts outside of grid are ignored.
+ */
+void DirtyGrid::invalidate(const GraphSubset& area)
+{
+	if (_all)
+	{
+		return;
+	}
+	const GraphSubset clip = GraphSubset::intersection(area, GraphSubset{ _width, _height });
+	if (clip.size_x() <= 0 || clip.size_y() <= 0)
+	{
+		return;
+	}
+	const int endCol = (clip.end_x + CellSize - 1) / CellSize;
+	const int endRow = (clip.end_y + CellSize - 1) / CellSize;
+	for (int row = clip.beg_y / CellSize; row < endRow; ++row)
+	{
+		for (int col = clip.beg_x / CellSize; col < endCol; ++col)
+		{
+			Uint8& cell = _cells[row * _cols + col];
+			if (!cell)
+			{
+				cell = 1;
+				++_dirtyCells;
+			}
+		}
+	}
+}
+
+/**
+ * Marks all cells as clean, called after frame is drawn.
+ */
+void DirtyGrid::clear()
+{
+	if (_dirtyCells || _all)
+	{
+		std::fill(_cells.begin(), _cells.end(), 0);
+	}
+	_dirtyCells = 0;
+	_all = false;
+}
+
+/**
+ * Gets how much of area need to be drawn again, used to decide if partial drawing is worth it.
+ * @return Ratio of dirty cells to all cells.
+ */
+float DirtyGrid::getDirtyRatio() const
+{
+	if (_all || _cells.empty())
+	{
+		return 1.0f;
+	}
+	return (float)_dirtyCells / _cells.size();
+}
+
+/**
+ * Checks if anything drawn in area could land on dirty cell.
+ * @param area Area in pixels.
+ * @return True if area touch dirty cell.
+ */
+bool DirtyGrid::intersects(const GraphSubset& area) const
+{
+	const GraphSubset clip = GraphSubset::intersection(area, GraphSubset{ _width, _height });
+	if (clip.size_x() <= 0 || clip.size_y() <= 0)
+	{
+		return false;
+	}
+	if (_all)
+	{
+		return true;
+	}
+	const int endCol = (clip.end_x + CellSize - 1) / CellSize;
+	const int endRow = (clip.end_y + CellSize - 1) / CellSize;
+	for (int row = clip.beg_y / CellSize; row < endRow; ++row)
+	{
+		for (int col = clip.beg_x / CellSize; col < endCol; ++col)
+		{
+			if (_cells[row * _cols + col])
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_types.h>
+#include "GraphSubset.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Screen split into square cells that remember which parts need to be drawn again.
+ * Used by surfaces that keep last frame and only recomposite parts that changed.
+ */
+class DirtyGrid
+{
+public:
+	/// Size of one cell in pixels.
+	static constexpr int CellSize = 16;
+
+private:
+	int _width, _height, _cols, _rows;
+	std::vector<Uint8> _cells;
+	size_t _dirtyCells;
+	bool _all;
+
+public:
+	/// Creates empty grid.
+	DirtyGrid();
+
+	/// Changes covered area, everything become dirty.
+	void resize(int width, int height);
+	/// Width of covered area.
+	int getWidth() const { return _width; }
+	/// Height of covered area.
+	int getHeight() const { return _height; }
+
+	/// Marks whole area as dirty.
+	void invalidateAll();
+	/// Marks cells that touch area as dirty.
+	void invalidate(const GraphSubset& area);
+	/// Marks everything as clean.
+	void clear();
+
+	/// Is whole area dirty?
+	bool isAllDirty() const { return _all; }
+	/// Is nothing dirty?
+	bool isClean() const { return !_all && _dirtyCells == 0; }
+	/// Part of cells that are dirty, from 0 to 1.
+	float getDirtyRatio() const;
+	/// Does area touch any dirty cell?
+	bool intersects(const GraphSubset& area) const;
+
+	/**
+	 * Calls func for every horizontal run of cells with given state, clipped to covered area.
+	 * @param dirty Visit dirty or clean runs.
+	 * @param func Function called with area of run.
+	 */
+	template<typename Func>
+	void forEachRun(bool dirty, Func&& func) const
+	{
+		for (int row = 0; row < _rows; ++row)
+		{
+			const Uint8* cells = &_cells[row * _cols];
+			int col = 0;
+			while (col < _cols)
+			{
+				if ((_all || cells[col]) != dirty)
+				{
+					++col;
+					continue;
+				}
+				const int begin = col;
+				while (col < _cols && (_all || cells[col]) == dirty)
+				{
+					++col;
+				}
+				func(GraphSubset(
+					std::make_pair(begin * CellSize, std::min(col * CellSize, _width)),
+					std::make_pair(row * CellSize, std::min((row + 1) * CellSize, _height))
+				));
+			}
+		}
+	}
+};
+
+}
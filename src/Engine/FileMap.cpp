@@ -39,6 +39,8 @@
 #include <string>
 #include <sstream>
 #include <istream>
+#include <mutex>
+#include <filesystem>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -265,6 +267,9 @@ SDL_RWops *FileRecord::getRWopsReadAll() const
 std::unique_ptr<std::istream> FileRecord::getIStream() const
 {
 	if (zip != NULL) {
+		// zip context is shared by all files of archive, rulesets can be read from many threads at once
+		static std::mutex zipMutex;
+		std::lock_guard<std::mutex> lock(zipMutex);
 		size_t size;
 		void* data = mz_zip_reader_extract_to_heap((mz_zip_archive*)zip, (mz_uint)findex, &size, 0);
 		if (data == NULL) {
@@ -292,6 +297,24 @@ YAML::Node FileRecord::getYAML() const
 	}
 }
 
+void FileRecord::getStat(Uint64 &size, Uint64 &stamp) const
+{
+	size = 0;
+	stamp = 0;
+	if (zip != NULL) {
+		mz_zip_archive_file_stat stat;
+		if (mz_zip_reader_file_stat((mz_zip_archive*)zip, (mz_uint)findex, &stat)) {
+			size = stat.m_uncomp_size;
+			stamp = stat.m_crc32;
+		}
+	} else {
+		std::error_code ec;
+		auto fileSize = std::filesystem::file_size(fullpath, ec);
+		size = ec ? 0 : (Uint64)fileSize;
+		stamp = (Uint64)CrossPlatform::getDateModified(fullpath);
+	}
+}
+
 std::vector<YAML::Node> FileRecord::getAllYAML() const
 {
 	try
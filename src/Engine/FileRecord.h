@@ -46,6 +46,8 @@ struct FileRecord
 	std::unique_ptr<std::istream> getIStream() const;
 	YAML::Node getYAML() const;
 	std::vector<YAML::Node> getAllYAML() const;
+	/// Gets size of file and stamp that change when file change (modification time or CRC-32 for zipped files).
+	void getStat(Uint64 &size, Uint64 &stamp) const;
 };
 
 } // namespace FileMap
@@ -29,6 +29,7 @@
 #include "Logger.h"
 #include "Music.h"
 #include "Options.h"
+#include "Profiler.h"
 #include "Screen.h"
 #include "Sound.h"
 #include "State.h"
@@ -43,6 +44,7 @@
 #include "../Geoscape/GeoscapeState.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/FpsCounter.h"
+#include "../Interface/ProfilerOverlay.h"
 #include "../Lua/LuaMod.h"
 #include "../Menu/NotesState.h"
 #include "../Menu/TestState.h"
@@ -140,6 +142,9 @@ Game::Game(const std::string &title)
 	// Create fps counter
 	_fpsCounter = new FpsCounter(15, 5, 0, 0);
 
+	// Create profiler overlay, below fps counter
+	_profilerOverlay = new ProfilerOverlay(240, 100, 0, 8);
+
 	// Create blank language
 	_lang = new Language();
 
@@ -176,6 +181,7 @@ Game::~Game()
 	_mod.reset();
 	delete _screen;
 	delete _fpsCounter;
+	delete _profilerOverlay;
 
 	Mix_CloseAudio();
 
@@ -201,11 +207,7 @@ void Game::run()
 	while (!_quit)
 	{
 		// Clean up states
-		while (!_deleted.empty())
-		{
-			delete _deleted.back();
-			_deleted.pop_back();
-		}
+		deletePoppedStates();
 
 		// Initialize active state
 		if (!_init)
@@ -329,6 +331,7 @@ void Game::run()
 					_screen->handle(&action);
 					_cursor->handle(&action);
 					_fpsCounter->handle(&action);
+					_profilerOverlay->handle(&action);
 					if (action.getDetails()->type == SDL_KEYDOWN)
 					{
 						// "ctrl-g" grab input
@@ -384,12 +387,19 @@ void Game::run()
 		if (runningState != PAUSED)
 		{
 			// Process state logic
-			_states.back()->update();
+			{
+				OXCE_PROFILE_ZONE("State::update");
+				_states.back()->update();
+			}
 
 			// Process entity logic
-			_ecs.update();
+			{
+				OXCE_PROFILE_ZONE("ECS::update");
+				_ecs.update();
+			}
 
 			_fpsCounter->think();
+			_profilerOverlay->think();
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
 				// Update our FPS delay time based on the time of the last draw.
@@ -415,13 +425,20 @@ void Game::run()
 				}
 				while (i != _states.begin() && !(*i)->isScreen());
 
-				for (; i != _states.end(); ++i)
 				{
-					(*i)->blit();
+					OXCE_PROFILE_ZONE("State::blit");
+					for (; i != _states.end(); ++i)
+					{
+						(*i)->blit();
+					}
 				}
 				_fpsCounter->blit(_screen->getSurface());
+				_profilerOverlay->blit(_screen->getSurface());
 				_cursor->blit(_screen->getSurface());
-				_screen->flip();
+				{
+					OXCE_PROFILE_ZONE("Screen::flip");
+					_screen->flip();
+				}
 			}
 		}
 
@@ -434,6 +451,8 @@ void Game::run()
 			case SLOWED: case PAUSED:
 				SDL_Delay(100); break; //More slowing down.
 		}
+
+		OXCE_PROFILE_FRAME();
 	}
 
 	Options::save();
@@ -542,6 +561,19 @@ void Game::popState()
 	_init = false;
 }
 
+/**
+ * Deletes all states popped from the stack. Normally done
+ * at the start of every cycle, when no popped state can run anymore.
+ */
+void Game::deletePoppedStates()
+{
+	while (!_deleted.empty())
+	{
+		delete _deleted.back();
+		_deleted.pop_back();
+	}
+}
+
 State* Game::getState()
 {
 	return _states.back();
@@ -568,6 +600,7 @@ void Game::setSavedGame(SavedGame *save)
 void Game::loadMods()
 {
 	Mod::resetGlobalStatics();
+	_profilerOverlay->dropText();
 
 	Log(LOG_INFO) << "Loading begins...";
 
@@ -702,6 +735,7 @@ void Game::loadLanguages()
 	}
 	Options::language = currentLang;
 
+	_profilerOverlay->dropText();
 	delete _lang;
 	_lang = new Language();
 
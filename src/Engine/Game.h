@@ -39,6 +39,7 @@ class SavedGame;
 class Mod;
 class ModInfo;
 class FpsCounter;
+class ProfilerOverlay;
 class Action;
 class GeoscapeState;
 class ModFile;
@@ -83,6 +84,7 @@ private:
 
 	bool _quit, _init, _update;
 	FpsCounter *_fpsCounter;
+	ProfilerOverlay *_profilerOverlay;
 	bool _mouseActive;
 	unsigned int _timeOfLastFrame;
 	int _timeUntilNextFrame;
@@ -108,6 +110,8 @@ public:
 	Cursor *getCursor() const { return _cursor; }
 	/// Gets the FpsCounter.
 	FpsCounter *getFpsCounter() const { return _fpsCounter; }
+	/// Gets the ProfilerOverlay.
+	ProfilerOverlay *getProfilerOverlay() const { return _profilerOverlay; }
 
 	/// Resets the state stack to a new state.
 	void setState(State *state);
@@ -115,6 +119,8 @@ public:
 	void pushState(State *state);
 	/// Pops the last state from the state stack.
 	void popState();
+	/// Deletes states popped from the state stack.
+	void deletePoppedStates();
 	/// Gets the last state from the state stack
 	State* getState();
 	/// Gets the state stack
@@ -211,6 +217,8 @@ public:
 
 /// Global function that retrieve a thread local Game object.
 Game* getGame();
+/// Sets Game object returned by `getGame()` on current thread.
+void setThreadLocalGame(Game* gameInstance);
 
 
 }
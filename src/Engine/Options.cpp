@@ -403,6 +403,18 @@ void createOptionsOXCE()
 
 	// TODO: needs restart (or code change) to work properly
 	_info.push_back(OptionInfo(OPTION_OXCE, "oxceMaxEquipmentLayoutTemplates", &oxceMaxEquipmentLayoutTemplates, 20, "", "HIDDEN"));
+
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceFovEngine", &oxceFovEngine, 0, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceWorkerThreads", &oxceWorkerThreads, 0, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceAISpeculativeSearch", &oxceAISpeculativeSearch, true, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceRulesetCache", &oxceRulesetCache, false, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceScriptOptimizer", &oxceScriptOptimizer, true, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceGeoScheduler", &oxceGeoScheduler, 1, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceParallelSystems", &oxceParallelSystems, true, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceBinarySaves", &oxceBinarySaves, 0, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceMapDirtyRects", &oxceMapDirtyRects, true, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceProfilerCaptureFrames", &oxceProfilerCaptureFrames, 600, "", "HIDDEN"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceProfileAlienTurn", &oxceProfileAlienTurn, false, "", "HIDDEN"));
 }
 
 void createAdvancedOptionsOXCE()
@@ -459,6 +471,7 @@ void createControlsOXCE()
 {
 	// OXCE controls general
 	_info.push_back(OptionInfo(OPTION_OXCE, "keyToggleQuickSearch", &keyToggleQuickSearch, SDLK_q, "STR_TOGGLE_QUICK_SEARCH", "STR_GENERAL"));
+	_info.push_back(OptionInfo(OPTION_OXCE, "keyProfiler", &keyProfiler, SDLK_F8, "STR_PROFILER_OVERLAY", "STR_GENERAL"));
 
 	// OXCE controls geoscape
 	_info.push_back(OptionInfo(OPTION_OXCE, "keyGeoUfoTracker", &keyGeoUfoTracker, SDLK_t, "STR_UFO_TRACKER", "STR_GEOSCAPE"));
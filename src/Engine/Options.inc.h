@@ -155,6 +155,31 @@ OPT int oxceHiddenMovementBackgroundChangeFrequency;
 
 OPT int oxceMaxEquipmentLayoutTemplates;
 
+// 0 = legacy line tracer; 1 = ray propagation; 2 = legacy with parity check against propagation
+OPT int oxceFovEngine;
+// total number of threads used by heavy calculations; 0 = one per hardware thread, 1 = only main thread
+OPT int oxceWorkerThreads;
+// brutal AI calculates reachability of all known units on worker threads before thinking
+OPT bool oxceAISpeculativeSearch;
+// keep parsed rulesets in binary file in user folder, errors in rulesets loaded from it are reported without line numbers
+OPT bool oxceRulesetCache;
+// simplify bytecode of scripts after parsing (jump threading, constant folding, fused operations)
+OPT bool oxceScriptOptimizer;
+// 0 = geoscape runs every 5 second step; 1 = quiet steps of idle geoscape (nothing flying) are skipped; 2 = quiet steps run normally and are checked against skipping
+OPT int oxceGeoScheduler;
+// ECS systems that declare used components and do not conflict run at same time on worker threads
+OPT bool oxceParallelSystems;
+// 0 = games are saved as YAML text; 1 = binary saves; 2 = compressed binary saves. Saves in any format can be loaded
+OPT int oxceBinarySaves;
+// battlescape map recomposites only parts of screen that changed since last frame
+OPT bool oxceMapDirtyRects;
+// key that shows profiler overlay, with Ctrl it starts and stops capture of profiler trace
+OPT SDLKey keyProfiler;
+// number of frames captured to profiler trace before it is saved; 0 = until stopped by key
+OPT int oxceProfilerCaptureFrames;
+// every alien turn is captured to profiler trace
+OPT bool oxceProfileAlienTurn;
+
 // Flags and other stuff that don't need OptionInfo's.
 OPT bool mute, reload, newOpenGL, newScaleFilter, newHQXFilter, newXBRZFilter, newRootWindowedMode, newFullscreen, newAllowResize, newBorderless;
 OPT int newDisplayWidth, newDisplayHeight, newBattlescapeScale, newGeoscapeScale, newWindowedModePositionX, newWindowedModePositionY;
@@ -0,0 +1,431 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include "CrossPlatform.h"
+#include "Logger.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+namespace Profiler
+{
+
+std::atomic<bool> active{ false };
+
+namespace
+{
+
+/// Number of zones in buffer of one thread, frame longer than this lose oldest zones.
+constexpr Uint64 BufferSize = 1 << 15;
+/// Limit of captured zones, around 64MB.
+constexpr size_t MaxCaptured = 1 << 21;
+/// Time in nanoseconds over which overlay statistics are averaged.
+constexpr Uint64 StatsPeriod = 1000000000;
+
+struct ZoneEvent
+{
+	const char* name;
+	Uint64 begin;
+	Uint64 end;
+};
+
+struct CapturedEvent
+{
+	ZoneEvent event;
+	int thread;
+};
+
+/// Ring buffer written only by its own thread and read by main thread.
+struct ThreadBuffer
+{
+	std::unique_ptr<ZoneEvent[]> events;
+	std::atomic<Uint64> written{ 0 };
+	Uint64 read = 0;
+	int id = 0;
+};
+
+struct ZoneTotal
+{
+	Uint64 total = 0;
+	Uint64 max = 0;
+	Uint64 calls = 0;
+};
+
+struct ProfilerData
+{
+	std::mutex mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+	bool overlay = false;
+	std::unordered_map<const char*, ZoneTotal> totals;
+	std::vector<ZoneStats> stats;
+	Uint64 frameBegin = 0;
+	Uint64 periodBegin = 0;
+	int periodFrames = 0;
+	int mainThread = 0;
+
+	bool capturing = false;
+	int captureFrames = 0;
+	int capturedFrames = 0;
+	Uint64 captureBegin = 0;
+	Uint64 lost = 0;
+	std::vector<CapturedEvent> captured;
+};
+
+ProfilerData& data()
+{
+	static ProfilerData d;
+	return d;
+}
+
+thread_local ThreadBuffer* localBuffer = nullptr;
+
+/**
+ * Gets buffer of current thread, created on first zone of thread.
+ */
+ThreadBuffer* getLocalBuffer()
+{
+	if (!localBuffer)
+	{
+		auto buffer = std::make_unique<ThreadBuffer>();
+		buffer->events.reset(new ZoneEvent[BufferSize]);
+
+		ProfilerData& d = data();
+		std::lock_guard<std::mutex> lock(d.mutex);
+		buffer->id = (int)d.buffers.size() + 1;
+		localBuffer = buffer.get();
+		d.buffers.push_back(std::move(buffer));
+	}
+	return localBuffer;
+}
+
+/**
+ * Moves finished zones from buffers of all threads to statistics and capture.
+ */
+void collect()
+{
+	ProfilerData& d = data();
+	std::lock_guard<std::mutex> lock(d.mutex);
+	for (auto& buffer : d.buffers)
+	{
+		const Uint64 written = buffer->written.load(std::memory_order_acquire);
+		if (written - buffer->read > BufferSize)
+		{
+			d.lost += written - buffer->read - BufferSize;
+			buffer->read = written - BufferSize;
+		}
+		for (; buffer->read < written; ++buffer->read)
+		{
+			const ZoneEvent& e = buffer->events[buffer->read & (BufferSize - 1)];
+			if (d.overlay)
+			{
+				ZoneTotal& total = d.totals[e.name];
+				total.total += e.end - e.begin;
+				total.max = std::max(total.max, e.end - e.begin);
+				++total.calls;
+			}
+			if (d.capturing && e.begin >= d.captureBegin)
+			{
+				if (d.captured.size() < MaxCaptured)
+				{
+					d.captured.push_back({ e, buffer->id });
+				}
+				else
+				{
+					++d.lost;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Replaces overlay statistics with averages of current period.
+ */
+void publish(Uint64 time)
+{
+	ProfilerData& d = data();
+	d.stats.clear();
+	const double frames = std::max(d.periodFrames, 1);
+	for (const auto& total : d.totals)
+	{
+		d.stats.push_back({ total.first, total.second.total / 1000000.0 / frames, total.second.max / 1000000.0, total.second.calls / frames });
+	}
+	std::sort(d.stats.begin(), d.stats.end(), [](const ZoneStats& a, const ZoneStats& b){ return a.msPerFrame > b.msPerFrame; });
+	d.totals.clear();
+	d.periodFrames = 0;
+	d.periodBegin = time;
+}
+
+/**
+ * Turns collecting on when overlay or capture need it, old zones left in buffers are dropped.
+ */
+void updateActive()
+{
+	ProfilerData& d = data();
+	const bool wanted = d.overlay || d.capturing;
+	if (wanted && !active.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock(d.mutex);
+		for (auto& buffer : d.buffers)
+		{
+			buffer->read = buffer->written.load(std::memory_order_acquire);
+		}
+		d.totals.clear();
+		d.frameBegin = 0;
+		d.periodBegin = now();
+		d.periodFrames = 0;
+	}
+	active.store(wanted, std::memory_order_relaxed);
+}
+
+/**
+ * Writes zone name as JSON string.
+ */
+void writeName(std::ostream& out, const char* name)
+{
+	out << '"';
+	for (const char* c = name; *c; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			out << '\\';
+		}
+		if ((unsigned char)*c >= 0x20)
+		{
+			out << *c;
+		}
+	}
+	out << '"';
+}
+
+}
+
+/**
+ * Gets time from monotonic clock.
+ * @return Time in nanoseconds.
+ */
+Uint64 now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Records zone in buffer of current thread, it does not allocate except for first zone of thread.
+ * @param name Name of zone.
+ * @param begin Start time of zone.
+ */
+void addZone(const char* name, Uint64 begin)
+{
+	const Uint64 end = now();
+	ThreadBuffer* buffer = getLocalBuffer();
+	const Uint64 written = buffer->written.load(std::memory_order_relaxed);
+	buffer->events[written & (BufferSize - 1)] = { name, begin, end };
+	buffer->written.store(written + 1, std::memory_order_release);
+}
+
+/**
+ * Turns collecting of statistics for overlay on or off.
+ * @param enabled New state.
+ */
+void setOverlay(bool enabled)
+{
+	ProfilerData& d = data();
+	d.overlay = enabled;
+	if (!enabled)
+	{
+		d.stats.clear();
+	}
+	updateActive();
+}
+
+/**
+ * Is overlay collecting statistics?
+ */
+bool isOverlay()
+{
+	return data().overlay;
+}
+
+/**
+ * Gets statistics for overlay, updated once per second. Main thread only.
+ * @return Zones sorted by time per frame.
+ */
+const std::vector<ZoneStats>& getStats()
+{
+	return data().stats;
+}
+
+/**
+ * Starts capturing zones of all threads, does nothing if capture is already running.
+ * @param frames Capture stops and is saved after this number of frames, zero to capture until stopped.
+ */
+void startCapture(int frames)
+{
+	ProfilerData& d = data();
+	if (d.capturing)
+	{
+		return;
+	}
+	d.captured.clear();
+	d.captureFrames = frames;
+	d.capturedFrames = 0;
+	d.captureBegin = now();
+	d.lost = 0;
+	d.capturing = true;
+	updateActive();
+}
+
+/**
+ * Is capture running?
+ */
+bool isCapturing()
+{
+	return data().capturing;
+}
+
+/**
+ * Stops capture, zones that finished so far are still included.
+ */
+void stopCapture()
+{
+	ProfilerData& d = data();
+	if (!d.capturing)
+	{
+		return;
+	}
+	collect();
+	d.capturing = false;
+	updateActive();
+}
+
+/**
+ * Writes captured zones as Chrome trace JSON, can be opened in `chrome://tracing` or Perfetto.
+ * @param out Output stream.
+ */
+void writeTrace(std::ostream& out)
+{
+	ProfilerData& d = data();
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	{
+		std::lock_guard<std::mutex> lock(d.mutex);
+		for (auto& buffer : d.buffers)
+		{
+			out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+			if (buffer->id == d.mainThread)
+			{
+				out << "Main";
+			}
+			else
+			{
+				out << "Thread " << buffer->id;
+			}
+			out << "\"}},\n";
+		}
+	}
+	out << std::fixed << std::setprecision(3);
+	for (const auto& c : d.captured)
+	{
+		out << "{\"name\":";
+		writeName(out, c.event.name);
+		out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << c.thread
+			<< ",\"ts\":" << (c.event.begin - d.captureBegin) / 1000.0
+			<< ",\"dur\":" << (c.event.end - c.event.begin) / 1000.0 << "},\n";
+	}
+	// metadata entry at end, so every zone entry can end with comma
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"OpenXcom\"}}\n]}\n";
+}
+
+/**
+ * Stops capture and saves it to next free file in user folder.
+ * @param prefix Start of file name.
+ * @return Name of saved file.
+ */
+std::string saveTrace(const std::string& prefix)
+{
+	stopCapture();
+
+	ProfilerData& d = data();
+	std::ostringstream name;
+	int i = 0;
+	do
+	{
+		name.str("");
+		name << Options::getMasterUserFolder() << prefix << std::setfill('0') << std::setw(3) << i << ".json";
+		i++;
+	}
+	while (CrossPlatform::fileExists(name.str()));
+
+	std::ostringstream out;
+	writeTrace(out);
+	if (!CrossPlatform::writeFile(name.str(), out.str()))
+	{
+		Log(LOG_ERROR) << "Failed to save profiler trace to " << name.str();
+		return std::string();
+	}
+	if (d.lost)
+	{
+		Log(LOG_WARNING) << "Profiler trace lost " << d.lost << " zones, buffers were full.";
+	}
+	Log(LOG_INFO) << "Profiler trace with " << d.captured.size() << " zones saved to " << name.str();
+	return name.str();
+}
+
+/**
+ * Ends frame, collects zones of all threads and records frame itself as zone.
+ * Captures with frame limit are saved when limit is reached. Main thread only.
+ */
+void frameMark()
+{
+	if (!active.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	ProfilerData& d = data();
+	const Uint64 time = now();
+	if (d.frameBegin)
+	{
+		addZone("Frame", d.frameBegin);
+	}
+	d.frameBegin = time;
+	d.mainThread = getLocalBuffer()->id;
+
+	collect();
+	++d.periodFrames;
+	if (d.overlay && time - d.periodBegin >= StatsPeriod)
+	{
+		publish(time);
+	}
+	if (d.capturing && ++d.capturedFrames >= d.captureFrames && d.captureFrames > 0)
+	{
+		saveTrace("profile");
+	}
+}
+
+}
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Low overhead profiler of named code zones, used to find what cause stutters.
+ * Every thread write finished zones to its own ring buffer, main thread collects
+ * them once per frame for overlay statistics and captured traces.
+ * Zones are only measured when overlay or capture is active.
+ */
+namespace Profiler
+{
+
+/// Time spent in one zone, averaged over last measured period.
+struct ZoneStats
+{
+	const char* name;
+	double msPerFrame;
+	double maxMs;
+	double callsPerFrame;
+};
+
+/// Is anything collecting zones?
+extern std::atomic<bool> active;
+
+/// Current time in nanoseconds.
+Uint64 now();
+/// Records zone that just finished on current thread.
+void addZone(const char* name, Uint64 begin);
+
+/// Turns collecting of statistics for overlay on or off.
+void setOverlay(bool enabled);
+/// Is overlay collecting statistics?
+bool isOverlay();
+/// Gets zones from last measured period, slowest first.
+const std::vector<ZoneStats>& getStats();
+
+/// Starts capturing zones for trace, zero frames capture until stopped.
+void startCapture(int frames);
+/// Is capture running?
+bool isCapturing();
+/// Stops capture, captured zones are kept until next capture.
+void stopCapture();
+/// Writes captured zones in Chrome trace format.
+void writeTrace(std::ostream& out);
+/// Stops capture and saves trace to user folder.
+std::string saveTrace(const std::string& prefix);
+
+/// Ends frame on main thread, collects zones from all threads.
+void frameMark();
+
+/**
+ * Measures time from creation to end of scope.
+ */
+class Zone
+{
+	const char* _name;
+	Uint64 _begin;
+
+public:
+	/// Starts measuring, name need to live as long as program.
+	Zone(const char* name) : _name(name), _begin(active.load(std::memory_order_relaxed) ? now() : 0)
+	{
+	}
+	/// Records zone.
+	~Zone()
+	{
+		if (_begin)
+		{
+			addZone(_name, _begin);
+		}
+	}
+
+	Zone(const Zone&) = delete;
+	Zone& operator=(const Zone&) = delete;
+};
+
+}
+
+}
+
+#ifdef OXCE_PROFILER
+#define OXCE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define OXCE_PROFILE_CONCAT(a, b) OXCE_PROFILE_CONCAT_IMPL(a, b)
+/// Measures time to end of current scope, name must be string literal or other static string.
+#define OXCE_PROFILE_ZONE(name) ::OpenXcom::Profiler::Zone OXCE_PROFILE_CONCAT(profileZone, __LINE__)(name)
+/// Marks end of frame.
+#define OXCE_PROFILE_FRAME() ::OpenXcom::Profiler::frameMark()
+#else
+#define OXCE_PROFILE_ZONE(name) ((void)0)
+#define OXCE_PROFILE_FRAME() ((void)0)
+#endif
@@ -499,3 +499,81 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+/**
+ * Apply the Scale effect on a slice of rows of a bitmap.
+ * Only rows of the destination bitmap that correspond to the source rows [y_first, y_last)
+ * are written, so disjoint slices of the same bitmap can be processed concurrently.
+ * Rows around the slice are only read.
+ * \param scale Scale factor. 2, 3 or 4.
+ * \param void_dst Pointer at the first pixel of the destination bitmap.
+ * \param dst_slice Size in bytes of a destination bitmap row.
+ * \param void_src Pointer at the first pixel of the source bitmap.
+ * \param src_slice Size in bytes of a source bitmap row.
+ * \param pixel Bytes per pixel of the source and destination bitmap.
+ * \param width Horizontal size in pixels of the source bitmap.
+ * \param height Vertical size in pixels of the source bitmap.
+ * \param y_first First source row of the slice.
+ * \param y_last One after the last source row of the slice.
+ */
+void scale_slice(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned y_first, unsigned y_last)
+{
+	unsigned char* dst = (unsigned char*)void_dst;
+	const unsigned char* src = (const unsigned char*)void_src;
+	unsigned y;
+
+#define SCROW(y) (src + (y) * src_slice)
+#define SCPREV(y) SCROW((y) > 0 ? (y) - 1 : 0)
+#define SCNEXT(y) SCROW((y) + 1 < height ? (y) + 1 : height - 1)
+
+	switch (scale) {
+	case 202 :
+	case 2 :
+		for (y = y_first; y < y_last; ++y) {
+			stage_scale2x(SCDST(2 * y), SCDST(2 * y + 1), SCPREV(y), SCROW(y), SCNEXT(y), pixel, width);
+		}
+		break;
+	case 303 :
+	case 3 :
+		for (y = y_first; y < y_last; ++y) {
+			stage_scale3x(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), SCPREV(y), SCROW(y), SCNEXT(y), pixel, width);
+		}
+		break;
+	case 404 :
+	case 4 : {
+		/* intermediate 2x rows of source rows [mid_first, mid_last] */
+		unsigned mid_first = y_first > 0 ? y_first - 1 : 0;
+		unsigned mid_last = y_last < height ? y_last : height - 1;
+		unsigned mid_slice = 2 * pixel * width;
+		unsigned mid_height = 2 * height;
+		unsigned char* mid = (unsigned char*)malloc((size_t)(mid_last - mid_first + 1) * 2 * mid_slice);
+
+		if (!mid)
+			return;
+
+#define SCMIDROW(m) (mid + ((m) - 2 * mid_first) * mid_slice)
+#define SCMIDCLAMP(m) SCMIDROW((m) < 0 ? 0 : (unsigned)(m) >= mid_height ? mid_height - 1 : (unsigned)(m))
+
+		for (y = mid_first; y <= mid_last; ++y) {
+			stage_scale2x(SCMIDROW(2 * y), SCMIDROW(2 * y + 1), SCPREV(y), SCROW(y), SCNEXT(y), pixel, width);
+		}
+		for (y = y_first; y < y_last; ++y) {
+			int m = 2 * (int)y;
+			stage_scale4x(SCDST(4 * y), SCDST(4 * y + 1), SCDST(4 * y + 2), SCDST(4 * y + 3), SCMIDCLAMP(m - 1), SCMIDCLAMP(m), SCMIDCLAMP(m + 1), SCMIDCLAMP(m + 2), pixel, width);
+		}
+
+#undef SCMIDCLAMP
+#undef SCMIDROW
+
+		free(mid);
+		break;
+	}
+	}
+
+#undef SCNEXT
+#undef SCPREV
+#undef SCROW
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	scale2x_mmx_emms();
+#endif
+}
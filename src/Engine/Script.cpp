@@ -34,6 +34,8 @@
 #include "Surface.h"
 #include "ShaderDraw.h"
 #include "ShaderMove.h"
+#include "SurfaceSpans.h"
+#include "BlitKernels.h"
 #include "Exception.h"
 #include "../fallthrough.h"
 #include "Collections.h"
@@ -257,6 +259,10 @@ static RetEnum bit_popcount_h(int& reg)
 	IMPL(offset,	MACRO_QUOTE({ Reg0 = Reg0 * Data1 + Data2;						return RetContinue; }),		(int& Reg0, int Data1, int Data2),			"arg1 = (arg1 * arg2) + arg3") \
 	IMPL(offsetmod,	MACRO_QUOTE({ return mulAddMod_h(Reg0, Mul1, Add2, Mod3);							}),		(int& Reg0, int Mul1, int Add2, int Mod3),	"arg1 = ((arg1 * arg2) + arg3) % arg4") \
 	\
+	IMPL(set_add,	MACRO_QUOTE({ Reg0 = Data1 + Data2;								return RetContinue; }),		(int& Reg0, int Data1, int Data2),			"arg1 = arg2 + arg3") \
+	IMPL(set_sub,	MACRO_QUOTE({ Reg0 = Data1 - Data2;								return RetContinue; }),		(int& Reg0, int Data1, int Data2),			"arg1 = arg2 - arg3") \
+	IMPL(set_mul,	MACRO_QUOTE({ Reg0 = Data1 * Data2;								return RetContinue; }),		(int& Reg0, int Data1, int Data2),			"arg1 = arg2 * arg3") \
+	\
 	IMPL(div,		MACRO_QUOTE({ if (!Data1) return RetError; Reg0 /= Data1;		return RetContinue; }),		(int& Reg0, int Data1),		"arg1 = arg1 / arg2") \
 	IMPL(mod,		MACRO_QUOTE({ if (!Data1) return RetError; Reg0 %= Data1;		return RetContinue; }),		(int& Reg0, int Data1),		"arg1 = arg1 % arg2") \
 	IMPL(muldiv,	MACRO_QUOTE({ return mulDiv_h(Reg0, Data1, Data2);									}),		(int& Reg0, int Data1, int Data2),	"arg1 = (arg1 * arg2) / arg3") \
@@ -510,16 +516,207 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 }
 
 
+////////////////////////////////////////////////////////////
+//					optimizer helpers
+////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/**
+ * Kind of operation argument that optimizer can understand.
+ */
+enum ProcArgKind : Uint8
+{
+	PAK_None,
+	PAK_Reg,
+	PAK_Value,
+	PAK_Label,
+};
+
+template<typename T> struct ProcArgKindOf { static constexpr ProcArgKind value = PAK_None; };
+template<typename T> struct ProcArgKindOf<helper::ArgRegDef<T>> { static constexpr ProcArgKind value = PAK_Reg; };
+template<typename T> struct ProcArgKindOf<helper::ArgValueDef<T>> { static constexpr ProcArgKind value = PAK_Value; };
+template<> struct ProcArgKindOf<helper::ArgLabelDef> { static constexpr ProcArgKind value = PAK_Label; };
+
+/**
+ * Layout of one version of operation in proc vector.
+ * Only registers, values and labels are listed in `args`, other arguments are skipped.
+ */
+struct ProcLayout
+{
+	static constexpr int ArgMax = 8;
+
+	struct Arg
+	{
+		ProcArgKind kind;
+		Uint8 offset;
+	};
+
+	/// Size of operation including its id, zero for invalid operation.
+	Uint8 size = 0;
+	Uint8 argCount = 0;
+	Arg args[ArgMax] = { };
+
+	void add(ProcArgKind kind, int offset)
+	{
+		if (kind != PAK_None)
+		{
+			args[argCount++] = Arg{ kind, static_cast<Uint8>(offset) };
+		}
+	}
+};
+
+/**
+ * Layout of invalid operation id.
+ */
+template<typename T>
+struct ProcLayoutOf
+{
+	static ProcLayout get()
+	{
+		return ProcLayout{ };
+	}
+};
+
+/**
+ * Layout of valid operation id.
+ */
+template<typename Func, int Ver, int... Pos>
+struct ProcLayoutOf<helper::FuncVer<Func, Ver, helper::ListTag<Pos...>>>
+{
+	using FuncVer = helper::FuncVer<Func, Ver, helper::ListTag<Pos...>>;
+
+	static ProcLayout get()
+	{
+		static_assert(sizeof...(Pos) <= ProcLayout::ArgMax, "Too many arguments");
+
+		ProcLayout layout;
+		layout.size = static_cast<Uint8>(1 + FuncVer::offset);
+		(layout.add(ProcArgKindOf<typename FuncVer::template GetTypeAt<Pos>>::value, 1 + FuncVer::Args::offset(Ver, Pos)), ...);
+		return layout;
+	}
+};
+
+/**
+ * Gets layout of operation with given id.
+ */
+const ProcLayout& getProcLayout(Uint8 procId)
+{
+	#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+	#define MACRO_PROC_LAYOUT(POS) ProcLayoutOf<helper::GetType<func, POS>>::get(),
+
+	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+
+	static const ProcLayout layouts[256] =
+	{
+		MACRO_COPY_256(MACRO_PROC_LAYOUT, 0)
+	};
+
+	#undef MACRO_PROC_LAYOUT
+	#undef MACRO_FUNC_ARRAY
+
+	return layouts[procId];
+}
+
+/**
+ * Find version of operation that have given kinds of arguments.
+ * @return Operation id or `Proc_EnumMax` if there is no matching version.
+ */
+Uint8 findProcVersion(Uint8 first, Uint8 last, std::initializer_list<ProcArgKind> kinds)
+{
+	for (int procId = first; procId <= last; ++procId)
+	{
+		const auto& layout = getProcLayout(procId);
+		if (layout.argCount == kinds.size() && std::equal(kinds.begin(), kinds.end(), layout.args, [](ProcArgKind k, const ProcLayout::Arg& a){ return k == a.kind; }))
+		{
+			return procId;
+		}
+	}
+	return Proc_EnumMax;
+}
+
+/**
+ * Check if operation id is one of versions of given operation.
+ */
+bool isProc(Uint8 procId, Uint8 first, Uint8 last)
+{
+	return first <= procId && procId <= last;
+}
+
+} //namespace
+
+
 ////////////////////////////////////////////////////////////
 //						Script class
 ////////////////////////////////////////////////////////////
 
+namespace
+{
+
+/**
+ * Results of blit script for every pair of source and destination pixel.
+ * Entry is valid only when its stamp is equal to current generation, this way
+ * table is cleared for new blit by only bumping generation.
+ */
+struct BlitResultCache
+{
+	static constexpr size_t Size = 256 * 256;
+
+	std::vector<Uint16> stamps;
+	std::vector<Uint8> results;
+	Uint16 generation = 0;
+
+	/// Invalidate all results.
+	void next()
+	{
+		if (stamps.empty())
+		{
+			stamps.assign(Size, 0);
+			results.assign(Size, 0);
+		}
+		if (++generation == 0)
+		{
+			std::fill(stamps.begin(), stamps.end(), 0);
+			generation = 1;
+		}
+	}
+};
+
+} //namespace
+
+/**
+ * Test if all global events are pure.
+ * @param events Two lists of events terminated by empty script, can be null.
+ */
+bool ScriptWorkerBlit::isPureEvents(const ScriptContainerBase* events)
+{
+	if (events)
+	{
+		for (int list = 0; list < 2; ++list)
+		{
+			while (*events)
+			{
+				if (!events->isPure())
+				{
+					return false;
+				}
+				++events;
+			}
+			++events;
+		}
+	}
+	return true;
+}
+
 void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int y, int shade)
 {
 	executeBlit(src, dest, x, y, shade, GraphSubset{ dest->getWidth(), dest->getHeight() } );
 }
 /**
  * Blitting one surface to another using script.
+ * When script is pure, it is run only once for each distinct pair of source and destination pixel,
+ * and rest of pixels reuse this result.
  * @param src source surface.
  * @param dest destination surface.
  * @param x x offset of source surface.
@@ -532,67 +729,100 @@ void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int
 
 	destShader.setDomain(mask);
 
+	// transparent source pixels never change destination, sprites with spans skip them completely
+	const SurfaceSpans* spans = src ? src->getSpans() : nullptr;
+	auto draw = [&](auto&& func)
+	{
+		if (spans)
+		{
+			spans->draw(dest, src, x, y, mask, func);
+		}
+		else
+		{
+			ShaderDrawFunc(func, destShader, srcShader);
+		}
+	};
+
 	if (_proc)
 	{
-		if (_events)
+		auto run = [&](Uint8 srcStuff, Uint8 destStuff) -> Uint8
+		{
+			ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
+			set(arg);
+			auto ptr = _events;
+			if (ptr)
+			{
+				while (*ptr)
+				{
+					reset(arg);
+					scriptExe(*this, ptr->data());
+					++ptr;
+				}
+				++ptr;
+			}
+
+			reset(arg);
+			scriptExe(*this, _proc);
+
+			if (ptr)
+			{
+				while (*ptr)
+				{
+					reset(arg);
+					scriptExe(*this, ptr->data());
+					++ptr;
+				}
+			}
+
+			get(arg);
+			return arg.getFirst() ? arg.getFirst() : destStuff;
+		};
+
+		if (_pure)
 		{
-			ShaderDrawFunc(
+			static thread_local BlitResultCache cache;
+			cache.next();
+
+			draw(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						auto ptr = _events;
-						while (*ptr)
-						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
-						}
-						++ptr;
-
-						reset(arg);
-						scriptExe(*this, _proc);
-
-						while (*ptr)
+						const size_t index = (srcStuff << 8) | destStuff;
+						if (cache.stamps[index] != cache.generation)
 						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
+							cache.stamps[index] = cache.generation;
+							cache.results[index] = run(srcStuff, destStuff);
 						}
-						++ptr;
-
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						destStuff = cache.results[index];
 					}
-				},
-				destShader,
-				srcShader
+				}
 			);
 		}
 		else
 		{
-			ShaderDrawFunc(
+			draw(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						scriptExe(*this, _proc);
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						destStuff = run(srcStuff, destStuff);
 					}
-				},
-				destShader,
-				srcShader
+				}
 			);
 		}
 	}
 	else
 	{
-		ShaderDraw<helper::StandardShade>(destShader, srcShader, ShaderScalar(shade));
+		auto rowFunc = [&](Uint8* destRow, const Uint8* srcRow, int size){ BlitKernels::shadeRow(destRow, srcRow, size, shade); };
+		if (spans)
+		{
+			spans->drawRows(dest, src, x, y, mask, rowFunc);
+		}
+		else
+		{
+			BlitKernels::drawRows(dest, src, x, y, mask, rowFunc);
+		}
 	}
 }
 
@@ -2790,6 +3020,7 @@ ParserWriter::ParserWriter(
 void ParserWriter::relese()
 {
 	pushProc(Proc_exit);
+	std::vector<ProgPos> labelRefs;
 	refLabels.forEachPosition(
 		[&](auto pos, ProgPos value)
 		{
@@ -2798,8 +3029,13 @@ void ParserWriter::relese()
 				throw Exception("Incorrect label position reference");
 			}
 			updateReserved<ProgPos>(pos, value);
+			labelRefs.push_back(pos.getPos());
 		}
 	);
+	if (Options::oxceScriptOptimizer)
+	{
+		optimize(labelRefs);
+	}
 
 	auto textTotalSize = 0u;
 	refTexts.forEachPosition(
@@ -2861,6 +3097,434 @@ void ParserWriter::relese()
 	);
 }
 
+/**
+ * Simplify finished script code. Jumps to other jumps are threaded, conditions and
+ * arithmetic on constants are folded, operations without effect and unreachable code are
+ * removed, and common pairs of operations are fused into one operation.
+ * Operations that are not understood are left untouched. All labels need already have final values.
+ * @param labelRefs Positions of all label arguments in proc vector.
+ */
+void ParserWriter::optimize(const std::vector<ProgPos>& labelRefs)
+{
+	auto& proc = container._proc;
+
+	struct Op
+	{
+		size_t start;
+		size_t size;
+		bool removed;
+		bool target;
+	};
+	struct LabelRef
+	{
+		size_t op;
+		size_t offset;
+	};
+	struct Arg
+	{
+		ProcArgKind kind;
+		int value;
+	};
+
+	std::vector<Op> ops;
+	std::vector<int> opAt(proc.size(), -1);
+	for (size_t pos = 0; pos < proc.size(); )
+	{
+		const auto& layout = getProcLayout(proc[pos]);
+		if (layout.size == 0 || pos + layout.size > proc.size())
+		{
+			return;
+		}
+		opAt[pos] = static_cast<int>(ops.size());
+		ops.push_back(Op{ pos, layout.size, false, false });
+		pos += layout.size;
+	}
+	if (ops.empty() || proc[ops.back().start] != Proc_exit)
+	{
+		return;
+	}
+
+	auto ownerOf = [&](size_t pos)
+	{
+		while (opAt[pos] < 0)
+		{
+			--pos;
+		}
+		return static_cast<size_t>(opAt[pos]);
+	};
+	auto readLabel = [&](const LabelRef& l)
+	{
+		ProgPos value;
+		memcpy(&value, &proc[ops[l.op].start + l.offset], sizeof(value));
+		return value;
+	};
+	auto writeLabel = [&](const LabelRef& l, ProgPos value)
+	{
+		memcpy(&proc[ops[l.op].start + l.offset], &value, sizeof(value));
+	};
+	auto opOfLabel = [&](ProgPos value)
+	{
+		return static_cast<size_t>(opAt[static_cast<size_t>(value)]);
+	};
+	auto nextKept = [&](size_t i)
+	{
+		while (i < ops.size() && ops[i].removed)
+		{
+			++i;
+		}
+		return i;
+	};
+	auto procId = [&](size_t i)
+	{
+		return proc[ops[i].start];
+	};
+	auto readArg = [&](size_t i, int arg)
+	{
+		const auto& a = getProcLayout(procId(i)).args[arg];
+		const Uint8* data = &proc[ops[i].start + a.offset];
+		Arg result = { a.kind, 0 };
+		if (a.kind == PAK_Reg)
+		{
+			RegEnum reg;
+			memcpy(&reg, data, sizeof(reg));
+			result.value = reg;
+		}
+		else if (a.kind == PAK_Value)
+		{
+			memcpy(&result.value, data, sizeof(result.value));
+		}
+		return result;
+	};
+	auto writeArg = [&](size_t i, int arg, Arg value)
+	{
+		const auto& a = getProcLayout(procId(i)).args[arg];
+		Uint8* data = &proc[ops[i].start + a.offset];
+		if (a.kind == PAK_Reg)
+		{
+			RegEnum reg = static_cast<RegEnum>(value.value);
+			memcpy(data, &reg, sizeof(reg));
+		}
+		else
+		{
+			memcpy(data, &value.value, sizeof(value.value));
+		}
+	};
+	auto isConst = [](Arg a, int value)
+	{
+		return a.kind == PAK_Value && a.value == value;
+	};
+	auto sameReg = [](Arg a, Arg b)
+	{
+		return a.kind == PAK_Reg && b.kind == PAK_Reg && a.value == b.value;
+	};
+
+	std::vector<LabelRef> labels;
+	for (auto pos : labelRefs)
+	{
+		const size_t p = static_cast<size_t>(pos);
+		if (p + sizeof(ProgPos) > proc.size())
+		{
+			return;
+		}
+		const size_t owner = ownerOf(p);
+		if (p + sizeof(ProgPos) > ops[owner].start + ops[owner].size)
+		{
+			return;
+		}
+		labels.push_back(LabelRef{ owner, p - ops[owner].start });
+		const size_t value = static_cast<size_t>(readLabel(labels.back()));
+		if (value >= proc.size() || opAt[value] < 0)
+		{
+			return;
+		}
+	}
+
+	// replace operation `i` by `goto` to given label.
+	auto replaceByGoto = [&](size_t i, ProgPos label)
+	{
+		const auto& layout = getProcLayout(Proc_goto);
+		proc[ops[i].start] = Proc_goto;
+		ops[i].size = layout.size;
+		labels.erase(std::remove_if(labels.begin(), labels.end(), [&](const LabelRef& l){ return l.op == i; }), labels.end());
+		labels.push_back(LabelRef{ i, layout.args[0].offset });
+		writeLabel(labels.back(), label);
+	};
+	// replace operation `i` and all following up to `j` by new one.
+	auto replaceByProc = [&](size_t i, size_t j, Uint8 newProcId, std::initializer_list<Arg> args)
+	{
+		const auto& layout = getProcLayout(newProcId);
+		proc[ops[i].start] = newProcId;
+		ops[i].size = layout.size;
+		int arg = 0;
+		for (auto a : args)
+		{
+			writeArg(i, arg++, a);
+		}
+		for (size_t k = i + 1; k <= j; ++k)
+		{
+			ops[k].removed = true;
+		}
+	};
+
+	bool changed = true;
+	for (int pass = 0; changed && pass < 16; ++pass)
+	{
+		changed = false;
+
+		for (auto& op : ops)
+		{
+			op.target = false;
+		}
+		ops[0].target = true;
+		for (auto& l : labels)
+		{
+			if (!ops[l.op].removed)
+			{
+				ops[opOfLabel(readLabel(l))].target = true;
+			}
+		}
+
+		// jump threading
+		for (auto& l : labels)
+		{
+			if (ops[l.op].removed)
+			{
+				continue;
+			}
+			const ProgPos old = readLabel(l);
+			ProgPos value = old;
+			for (size_t step = 0; step < ops.size(); ++step)
+			{
+				const size_t t = nextKept(opOfLabel(value));
+				if (procId(t) != Proc_goto)
+				{
+					break;
+				}
+				const ProgPos next = readLabel(LabelRef{ t, getProcLayout(Proc_goto).args[0].offset });
+				if (next == value)
+				{
+					break;
+				}
+				value = next;
+			}
+			if (value != old)
+			{
+				writeLabel(l, value);
+				changed = true;
+			}
+		}
+
+		for (size_t i = nextKept(0); i < ops.size(); i = nextKept(i + 1))
+		{
+			const Uint8 id = procId(i);
+
+			if (id == Proc_goto)
+			{
+				const ProgPos label = readLabel(LabelRef{ i, getProcLayout(Proc_goto).args[0].offset });
+				const size_t t = nextKept(opOfLabel(label));
+				if (procId(t) == Proc_exit)
+				{
+					proc[ops[i].start] = Proc_exit;
+					ops[i].size = getProcLayout(Proc_exit).size;
+					labels.erase(std::remove_if(labels.begin(), labels.end(), [&](const LabelRef& l){ return l.op == i; }), labels.end());
+					changed = true;
+				}
+				else if (t == nextKept(i + 1))
+				{
+					ops[i].removed = true;
+					changed = true;
+				}
+				continue;
+			}
+
+			if (isProc(id, Proc_test_le, Proc_test_le_end) || isProc(id, Proc_test_eq, Proc_test_eq_end))
+			{
+				const Arg a = readArg(i, 0);
+				const Arg b = readArg(i, 1);
+				const ProgPos labelTrue = readLabel(LabelRef{ i, getProcLayout(id).args[2].offset });
+				const ProgPos labelFalse = readLabel(LabelRef{ i, getProcLayout(id).args[3].offset });
+				if (labelTrue == labelFalse || sameReg(a, b))
+				{
+					replaceByGoto(i, labelTrue);
+					changed = true;
+				}
+				else if (a.kind == PAK_Value && b.kind == PAK_Value)
+				{
+					const bool result = isProc(id, Proc_test_le, Proc_test_le_end) ? a.value <= b.value : a.value == b.value;
+					replaceByGoto(i, result ? labelTrue : labelFalse);
+					changed = true;
+				}
+				continue;
+			}
+
+			if (isProc(id, Proc_add, Proc_add_end) || isProc(id, Proc_sub, Proc_sub_end)
+				|| isProc(id, Proc_shl, Proc_shl_end) || isProc(id, Proc_shr, Proc_shr_end)
+				|| isProc(id, Proc_bit_or, Proc_bit_or_end) || isProc(id, Proc_bit_xor, Proc_bit_xor_end))
+			{
+				if (isConst(readArg(i, 1), 0))
+				{
+					ops[i].removed = true;
+					changed = true;
+					continue;
+				}
+			}
+			else if (isProc(id, Proc_mul, Proc_mul_end) || isProc(id, Proc_div, Proc_div_end))
+			{
+				if (isConst(readArg(i, 1), 1))
+				{
+					ops[i].removed = true;
+					changed = true;
+					continue;
+				}
+			}
+			else if (isProc(id, Proc_set, Proc_set_end))
+			{
+				if (sameReg(readArg(i, 0), readArg(i, 1)))
+				{
+					ops[i].removed = true;
+					changed = true;
+					continue;
+				}
+			}
+
+			// fusing pairs of operations on same register
+			const size_t j = nextKept(i + 1);
+			if (j >= ops.size())
+			{
+				continue;
+			}
+			bool entered = false;
+			for (size_t k = i + 1; k <= j; ++k)
+			{
+				entered |= ops[k].target;
+			}
+			if (entered)
+			{
+				continue;
+			}
+			const Uint8 nextId = procId(j);
+			const bool nextAdd = isProc(nextId, Proc_add, Proc_add_end);
+			const bool nextSub = isProc(nextId, Proc_sub, Proc_sub_end);
+			const bool nextMul = isProc(nextId, Proc_mul, Proc_mul_end);
+			if (!nextAdd && !nextSub && !nextMul)
+			{
+				continue;
+			}
+			const Arg reg = readArg(i, 0);
+			const Arg data = readArg(i, 1);
+			const Arg nextReg = readArg(j, 0);
+			const Arg nextData = readArg(j, 1);
+			if (!sameReg(reg, nextReg) || sameReg(reg, nextData))
+			{
+				continue;
+			}
+			const size_t space = ops[j].start + ops[j].size - ops[i].start;
+
+			if (isProc(id, Proc_set, Proc_set_end))
+			{
+				if (data.kind == PAK_Value && nextData.kind == PAK_Value)
+				{
+					const unsigned x = data.value;
+					const unsigned y = nextData.value;
+					const Arg folded = { PAK_Value, static_cast<int>(nextAdd ? x + y : nextSub ? x - y : x * y) };
+					writeArg(i, 1, folded);
+					ops[j].removed = true;
+					changed = true;
+				}
+				else
+				{
+					const Uint8 newId = nextAdd ? findProcVersion(Proc_set_add, Proc_set_add_end, { PAK_Reg, data.kind, nextData.kind })
+						: nextSub ? findProcVersion(Proc_set_sub, Proc_set_sub_end, { PAK_Reg, data.kind, nextData.kind })
+						: findProcVersion(Proc_set_mul, Proc_set_mul_end, { PAK_Reg, data.kind, nextData.kind });
+					if (newId != Proc_EnumMax && getProcLayout(newId).size <= space)
+					{
+						replaceByProc(i, j, newId, { reg, data, nextData });
+						changed = true;
+					}
+				}
+			}
+			else if (isProc(id, Proc_mul, Proc_mul_end) && nextAdd)
+			{
+				const Uint8 newId = findProcVersion(Proc_offset, Proc_offset_end, { PAK_Reg, data.kind, nextData.kind });
+				if (newId != Proc_EnumMax && getProcLayout(newId).size <= space)
+				{
+					replaceByProc(i, j, newId, { reg, data, nextData });
+					changed = true;
+				}
+			}
+		}
+
+		// unreachable code, last `exit` is always kept as every label need point to some operation
+		bool reachable = true;
+		for (size_t i = 0; i + 1 < ops.size(); ++i)
+		{
+			reachable |= ops[i].target;
+			if (ops[i].removed)
+			{
+				continue;
+			}
+			if (!reachable)
+			{
+				ops[i].removed = true;
+				changed = true;
+				continue;
+			}
+			const Uint8 id = procId(i);
+			if (id == Proc_goto || id == Proc_exit || isProc(id, Proc_test_le, Proc_test_le_end) || isProc(id, Proc_test_eq, Proc_test_eq_end))
+			{
+				reachable = false;
+			}
+		}
+	}
+
+	// build new code, label to removed operation point to first kept operation after it.
+	std::vector<size_t> newStart(ops.size());
+	size_t newSize = 0;
+	for (size_t i = 0; i < ops.size(); ++i)
+	{
+		newStart[i] = newSize;
+		if (!ops[i].removed)
+		{
+			newSize += ops[i].size;
+		}
+	}
+	if (newSize == proc.size())
+	{
+		return;
+	}
+
+	std::vector<Uint8> code;
+	code.reserve(newSize);
+	for (auto& op : ops)
+	{
+		if (!op.removed)
+		{
+			code.insert(code.end(), proc.begin() + op.start, proc.begin() + op.start + op.size);
+		}
+	}
+	for (auto& l : labels)
+	{
+		if (!ops[l.op].removed)
+		{
+			const ProgPos value = static_cast<ProgPos>(newStart[opOfLabel(readLabel(l))]);
+			memcpy(&code[newStart[l.op] + l.offset], &value, sizeof(value));
+		}
+	}
+	refTexts.updatePositions(
+		[&](ProgPos pos)
+		{
+			const size_t p = static_cast<size_t>(pos);
+			const size_t owner = ownerOf(p);
+			if (ops[owner].removed || p >= ops[owner].start + ops[owner].size)
+			{
+				return ProgPos::Unknown;
+			}
+			return static_cast<ProgPos>(newStart[owner] + (p - ops[owner].start));
+		}
+	);
+	proc = std::move(code);
+}
+
 /**
  * Returns reference based on name.
  * @param s name of reference.
@@ -3196,9 +3860,9 @@ ScriptParserBase::ScriptParserBase(ScriptGlobal* shared, const std::string& name
 	buildin("begin", &parseBegin);
 
 	addParser<helper::FuncGroup<Func_test_eq_null>>("test_eq", "");
-	addParser<helper::FuncGroup<Func_debug_impl_int>>("debug_impl", "");
-	addParser<helper::FuncGroup<Func_debug_impl_text>>("debug_impl", "");
-	addParser<helper::FuncGroup<Func_debug_flush>>("debug_flush", "");
+	addParser<helper::ImpureFuncGroup<Func_debug_impl_int>>("debug_impl", "");
+	addParser<helper::ImpureFuncGroup<Func_debug_impl_text>>("debug_impl", "");
+	addParser<helper::ImpureFuncGroup<Func_debug_flush>>("debug_flush", "");
 
 	addParser<helper::FuncGroup<Func_set_text>>("set", "");
 	addParser<helper::FuncGroup<Func_clear_text>>("clear", "");
@@ -415,6 +415,7 @@ class ScriptContainerBase
 {
 	friend struct ParserWriter;
 	std::vector<Uint8> _proc;
+	bool _pure = true;
 
 public:
 	/// Constructor.
@@ -443,6 +444,12 @@ public:
 	{
 		return *this ? _proc.data() : nullptr;
 	}
+
+	/// Test if script result depend only on its inputs, without any side effects.
+	bool isPure() const
+	{
+		return _pure;
+	}
 };
 
 /**
@@ -490,6 +497,33 @@ public:
 	{
 		return _events;
 	}
+	/// Test if script result depend only on its inputs, without any side effects.
+	bool isPure() const
+	{
+		return _current.isPure();
+	}
+	/// Test if there is nothing to run, neither own script nor any event.
+	bool empty() const
+	{
+		if (_current)
+		{
+			return false;
+		}
+		if (_events)
+		{
+			// two lists of events, before and after own script, each one end with empty script
+			auto ptr = _events;
+			for (int list = 0; list < 2; ++list)
+			{
+				if (*ptr)
+				{
+					return false;
+				}
+				++ptr;
+			}
+		}
+		return true;
+	}
 };
 
 /**
@@ -845,13 +879,15 @@ class ScriptWorkerBlit : public ScriptWorkerBase
 	/// Current script set in worker.
 	const Uint8* _proc;
 	const ScriptContainerBase* _events;
+	/// Results of current script can be reused for same pair of pixels.
+	bool _pure;
 
 public:
 	/// Type of output value from script.
 	using Output = ScriptOutputArgs<int&, int>;
 
 	/// Default constructor.
-	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr)
+	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr), _pure(false)
 	{
 
 	}
@@ -866,6 +902,7 @@ public:
 		{
 			_proc = c.data();
 			_events = nullptr;
+			_pure = c.isPure();
 			updateBase<Output>(args...);
 		}
 	}
@@ -880,10 +917,14 @@ public:
 		{
 			_proc = c.data();
 			_events = c.dataEvents();
+			_pure = c.isPure() && isPureEvents(_events);
 			updateBase<Output>(args...);
 		}
 	}
 
+	/// Test if all global events are pure.
+	static bool isPureEvents(const ScriptContainerBase* events);
+
 	/// Programmable blitting using script.
 	void executeBlit(const Surface* src, Surface* dest, int x, int y, int shade);
 	/// Programmable blitting using script.
@@ -894,6 +935,7 @@ public:
 	{
 		_proc = nullptr;
 		_events = nullptr;
+		_pure = false;
 	}
 };
 
@@ -1916,6 +1958,9 @@ class ScriptGroupNamedParser : public Parser
 
 public:
 	using BaseType = Parser;
+	/// Name of script, null terminated.
+	static constexpr char scriptName[] = { NameChars... };
+
 	struct ContainerWarper : Parser::Container
 	{
 
@@ -142,6 +142,22 @@ struct ParserWriter
 				f(pos.first, values[static_cast<std::size_t>(pos.second)]);
 			}
 		}
+
+		/// Move places of usage, `f` return new position or `ProgPos::Unknown` when place was removed.
+		template<typename Func>
+		void updatePositions(Func&& f)
+		{
+			std::vector<std::pair<ReservedPos<T>, Ref>> temp;
+			for (auto& pos : positions)
+			{
+				auto newPos = f(pos.first.getPos());
+				if (newPos != ProgPos::Unknown)
+				{
+					temp.push_back(std::make_pair(ReservedPos<T>{ newPos }, pos.second));
+				}
+			}
+			positions = std::move(temp);
+		}
 	};
 
 	/// member pointer accessing script operations.
@@ -171,6 +187,14 @@ struct ParserWriter
 
 	/// Final fixes of data.
 	void relese();
+	/// Simplify finished code.
+	void optimize(const std::vector<ProgPos>& labelRefs);
+
+	/// Mark script as having side effects, its results can't be reused.
+	void setImpure()
+	{
+		container._pure = false;
+	}
 
 	/// Get reference based on name.
 	ScriptRefData getReferece(const ScriptRef& s) const;
@@ -975,6 +999,19 @@ struct FuncGroup<Func, ListTag<Ver...>> : GetArgs<Func>
 	static constexpr ScriptFunc getDynamic(int i) { return FuncList::getDynamic(i); }
 };
 
+/**
+ * Group of functions with side effects, script that use any of them is marked as impure.
+ */
+template<typename Func>
+struct ImpureFuncGroup : FuncGroup<Func>
+{
+	static int parse(ParserWriter& ph, const ScriptRefData* begin, const ScriptRefData* end)
+	{
+		ph.setImpure();
+		return FuncGroup<Func>::parse(ph, begin, end);
+	}
+};
+
 ////////////////////////////////////////////////////////////
 //					Bind helper classes
 ////////////////////////////////////////////////////////////
@@ -1648,7 +1685,7 @@ struct Bind : BindBase
 	template<std::string (*X)(const T*)>
 	void addDebugDisplay()
 	{
-		addCustomFunc<helper::BindDebugDisplay<T, X>>("debug_impl", BindBase::functionInvisible);
+		parser->addParser<helper::ImpureFuncGroup<helper::BindDebugDisplay<T, X>>>("debug_impl", BindBase::functionInvisible);
 	}
 
 	template<auto X>
@@ -1773,7 +1810,7 @@ struct BindValue : BindBase
 	template<std::string (*X)(const T*)>
 	void addDebugValueDisplay()
 	{
-		addCustomFunc<helper::BindValueDebugDisplay<T, X>>("debug_impl", BindBase::functionInvisible);
+		parser->addParser<helper::ImpureFuncGroup<helper::BindValueDebugDisplay<T, X>>>("debug_impl", BindBase::functionInvisible);
 	}
 
 	template<auto X>
@@ -36,6 +36,7 @@
 #include "../Interface/ComboBox.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/FpsCounter.h"
+#include "../Interface/ProfilerOverlay.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Mod/RuleInterface.h"
 
@@ -320,6 +321,8 @@ void State::init()
 	getGame()->getFpsCounter()->setPalette(_palette);
 	getGame()->getFpsCounter()->setColor(_cursorColor);
 	getGame()->getFpsCounter()->draw();
+	getGame()->getProfilerOverlay()->setPalette(_palette);
+	getGame()->getProfilerOverlay()->setColor(_cursorColor);
 
 	// Highest priority: custom sound set explicitly in the code
 	// Medium priority: sound defined by the interface ruleset
@@ -19,6 +19,8 @@
 #include "Surface.h"
 #include "ShaderDraw.h"
 #include "ShaderMove.h"
+#include "SurfaceSpans.h"
+#include "BlitKernels.h"
 #include <vector>
 #include <algorithm>
 #include <SDL_gfxPrimitives.h>
@@ -270,6 +272,7 @@ Surface::Surface(const Surface& other) : Surface{ }
 	//cant call `setPalette` because its virtual function and it doesn't work correctly in constructor
 	SDL_SetColors(_surface.get(), other.getPalette(), 0, 255);
 	RawCopySurf(_surface, other._surface);
+	_spans = other._spans;
 
 	_x = other._x;
 	_y = other._y;
@@ -361,6 +364,7 @@ void Surface::loadImage(const std::string &filename)
 	// Destroy current surface (will be replaced)
 	_alignedBuffer = nullptr;
 	_surface = nullptr;
+	_spans = nullptr;
 
 	Log(LOG_VERBOSE) << "Loading image: " << filename;
 	auto rw = FileMap::getRWops(filename);
@@ -537,6 +541,7 @@ void Surface::loadBdy(const std::string &filename)
 void Surface::clear()
 {
 	CleanSdlSurface(_surface.get());
+	_spans = nullptr;
 }
 
 /**
@@ -915,12 +920,13 @@ void Surface::setHidden(bool hidden)
 /**
  * Locks the surface from outside access
  * for pixel-level access. Must be unlocked
- * afterwards.
+ * afterwards. Pixels can change, so runs of opaque pixels are dropped.
  * @sa unlock()
  */
 void Surface::lock()
 {
 	SDL_LockSurface(_surface.get());
+	_spans = nullptr;
 }
 
 /**
@@ -935,25 +941,36 @@ void Surface::unlock()
 
 /**
  * Specific blit function to blit battlescape terrain data in different shades in a fast way.
+ * Pixels are processed by row kernels, when source has runs of opaque pixels only part of row covered by them is visited.
  */
 void Surface::blitRaw(SurfaceRaw<Uint8> destSurf, SurfaceRaw<const Uint8> srcSurf, int x, int y, int shade, bool half, int newBaseColor)
 {
-	ShaderMove<const Uint8> src(srcSurf, x, y);
+	GraphSubset area{ destSurf.getWidth(), destSurf.getHeight() };
 	if (half)
 	{
-		GraphSubset g = src.getDomain();
-		g.beg_x = g.end_x/2;
-		src.setDomain(g);
+		area.beg_x = std::max(area.beg_x, x + srcSurf.getWidth() / 2);
 	}
+
+	auto draw = [&](auto&& rowFunc)
+	{
+		if (const SurfaceSpans* spans = srcSurf.getSpans())
+		{
+			spans->drawRows(destSurf, srcSurf, x, y, area, rowFunc);
+		}
+		else
+		{
+			BlitKernels::drawRows(destSurf, srcSurf, x, y, area, rowFunc);
+		}
+	};
+
 	if (newBaseColor)
 	{
-		--newBaseColor;
-		newBaseColor <<= 4;
-		ShaderDraw<helper::ColorReplace>(ShaderSurface(destSurf), src, ShaderScalar(shade), ShaderScalar(newBaseColor));
+		const int newColor = (newBaseColor - 1) << 4;
+		draw([&](Uint8* dest, const Uint8* src, int size){ BlitKernels::replaceRow(dest, src, size, shade, newColor); });
 	}
 	else
 	{
-		ShaderDraw<helper::StandardShade>(ShaderSurface(destSurf), src, ShaderScalar(shade));
+		draw([&](Uint8* dest, const Uint8* src, int size){ BlitKernels::shadeRow(dest, src, size, shade); });
 	}
 }
 
@@ -983,12 +1000,15 @@ void Surface::blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, boo
  */
 void Surface::blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, GraphSubset range) const
 {
-	ShaderMove<const Uint8> src(this, x, y);
-	ShaderMove<Uint8> dest(surface);
-
-	dest.setDomain(range);
-
-	ShaderDraw<helper::StandardShade>(dest, src, ShaderScalar(shade));
+	auto rowFunc = [&](Uint8* dest, const Uint8* src, int size){ BlitKernels::shadeRow(dest, src, size, shade); };
+	if (_spans)
+	{
+		_spans->drawRows(surface, this, x, y, range, rowFunc);
+	}
+	else
+	{
+		BlitKernels::drawRows(surface, this, x, y, range, rowFunc);
+	}
 }
 
 /**
@@ -1000,6 +1020,19 @@ void Surface::invalidate(bool valid)
 	_redraw = valid;
 }
 
+/**
+ * Builds runs of opaque pixels of surface, blits from it will skip transparent pixels.
+ * Should be called only for surfaces that do not change later, like sprites of battlescape.
+ * Runs are dropped when surface is locked, cleared or loaded again.
+ */
+void Surface::buildSpans()
+{
+	if (_surface && _surface->format->BitsPerPixel == 8)
+	{
+		_spans = std::make_shared<const SurfaceSpans>(SurfaceRaw<const Uint8>(this));
+	}
+}
+
 /**
  * Recreates the surface with a new size.
  * Old contents will not be altered, and may be
@@ -1023,6 +1056,7 @@ void Surface::resize(int width, int height)
 	// Delete old surface
 	_surface = std::move(surface);
 	_alignedBuffer = std::move(alignedBuffer);
+	_spans = nullptr;
 	_width = _surface->w;
 	_height = _surface->h;
 	_pitch = _surface->pitch;
@@ -36,6 +36,7 @@ class Font;
 class Language;
 class ScriptWorkerBase;
 class SurfaceCrop;
+class SurfaceSpans;
 template<typename Pixel> class SurfaceRaw;
 
 /**
@@ -88,6 +89,7 @@ public:
 protected:
 	UniqueBufferPtr _alignedBuffer;
 	UniqueSurfacePtr _surface;
+	std::shared_ptr<const SurfaceSpans> _spans;
 	Sint16 _x, _y;
 	Uint16 _width, _height, _pitch;
 	Uint8 _visible: 1;
@@ -334,6 +336,12 @@ public:
 	void blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, GraphSubset range) const;
 	/// Invalidate the surface: force it to be redrawn
 	void invalidate(bool valid = true);
+	/// Builds runs of opaque pixels used to skip transparent pixels when blitting.
+	void buildSpans();
+	/// Drops runs of opaque pixels, need be called after changing pixels of surface directly.
+	void clearSpans() { _spans.reset(); }
+	/// Gets runs of opaque pixels, null when they are not built.
+	const SurfaceSpans* getSpans() const { return _spans.get(); }
 
 	/// Sets the color of the surface.
 	virtual void setColor(Uint8 /*color*/) { /* empty by design */ };
@@ -354,12 +362,14 @@ template<typename Pixel>
 class SurfaceRaw
 {
 	Pixel* _buffer;
+	const SurfaceSpans* _spans;
 	Uint16 _width, _height, _pitch;
 
 public:
 	/// Default constructor
 	SurfaceRaw() :
 		_buffer{ nullptr },
+		_spans{ nullptr },
 		_width{ 0 },
 		_height{ 0 },
 		_pitch{ 0 }
@@ -376,6 +386,7 @@ public:
 	/// Constructor
 	SurfaceRaw(Pixel* buffer, int width, int height, int pitch) :
 		_buffer{ buffer },
+		_spans{ nullptr },
 		_width{ static_cast<Uint16>(width) },
 		_height{ static_cast<Uint16>(height) },
 		_pitch{ static_cast<Uint16>(pitch) }
@@ -390,6 +401,7 @@ public:
 		if (surf)
 		{
 			*this = SurfaceRaw{ surf->getBuffer(), surf->getWidth(), surf->getHeight(), surf->getPitch() };
+			_spans = surf->getSpans();
 		}
 	}
 
@@ -400,6 +412,7 @@ public:
 		if (surf)
 		{
 			*this = SurfaceRaw{ surf->getBuffer(), surf->getWidth(), surf->getHeight(), surf->getPitch() };
+			_spans = surf->getSpans();
 		}
 	}
 
@@ -483,6 +496,12 @@ public:
 	{
 		return _buffer;
 	}
+
+	/// Get runs of opaque pixels of source surface, null if not available.
+	const SurfaceSpans* getSpans() const
+	{
+		return _spans;
+	}
 };
 
 /**
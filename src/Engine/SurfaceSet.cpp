@@ -127,6 +127,9 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 		// Unlock the surface
 		_frames[frame].unlock();
 	}
+
+	// PCK frames are sprites drawn over map, most of their pixels are transparent
+	buildSpans();
 }
 
 /**
@@ -301,4 +304,19 @@ void SurfaceSet::setPalette(const SDL_Color *colors, int firstcolor, int ncolors
 	}
 }
 
+/**
+ * Builds runs of opaque pixels for every frame that do not have them,
+ * frames changed after previous call get them again.
+ */
+void SurfaceSet::buildSpans()
+{
+	for (auto& frame : _frames)
+	{
+		if (frame && !frame.getSpans())
+		{
+			frame.buildSpans();
+		}
+	}
+}
+
 }
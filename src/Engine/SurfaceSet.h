@@ -78,6 +78,8 @@ public:
 	size_t getTotalFrames() const;
 	/// Sets the surface set's palette.
 	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256);
+	/// Builds runs of opaque pixels for frames that do not have them.
+	void buildSpans();
 };
 
 }
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SurfaceSpans.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Scans surface and stores every run of non zero pixels.
+ * @param src Surface to scan.
+ */
+SurfaceSpans::SurfaceSpans(SurfaceRaw<const Uint8> src) : _opaquePixels(0)
+{
+	const int width = src.getWidth();
+	const int height = src.getHeight();
+	_rows.reserve(height + 1);
+	for (int y = 0; y < height; ++y)
+	{
+		_rows.push_back((Uint32)_spans.size());
+		const Uint8* row = (const Uint8*)((const char*)src.getBuffer() + y * src.getPitch());
+		int x = 0;
+		while (x < width)
+		{
+			while (x < width && row[x] == 0)
+			{
+				++x;
+			}
+			const int begin = x;
+			while (x < width && row[x] != 0)
+			{
+				++x;
+			}
+			if (x > begin)
+			{
+				_spans.push_back(Span{ (Uint16)begin, (Uint16)(x - begin) });
+				_opaquePixels += x - begin;
+			}
+		}
+	}
+	_rows.push_back((Uint32)_spans.size());
+	_spans.shrink_to_fit();
+}
+
+}
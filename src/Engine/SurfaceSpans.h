@@ -0,0 +1,139 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <vector>
+#include <SDL_types.h>
+#include "GraphSubset.h"
+#include "Surface.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Opaque pixels of 8-bit surface stored as runs in every row.
+ * Most battlescape sprites are mostly transparent, blitting only runs skip
+ * all work on transparent pixels. Spans only describe surface, pixels are
+ * still read from it, so they need be rebuilt after surface is changed.
+ */
+class SurfaceSpans
+{
+public:
+	/// Run of opaque pixels in one row.
+	struct Span
+	{
+		Uint16 x;
+		Uint16 length;
+	};
+
+private:
+	std::vector<Uint32> _rows;
+	std::vector<Span> _spans;
+	size_t _opaquePixels;
+
+public:
+	/// Finds runs of opaque pixels in surface.
+	explicit SurfaceSpans(SurfaceRaw<const Uint8> src);
+
+	/// Number of rows.
+	int getHeight() const { return (int)_rows.size() - 1; }
+	/// First span of row.
+	const Span* rowBegin(int y) const { return _spans.data() + _rows[y]; }
+	/// End of spans of row.
+	const Span* rowEnd(int y) const { return _spans.data() + _rows[y + 1]; }
+	/// Number of opaque pixels in surface.
+	size_t getOpaquePixels() const { return _opaquePixels; }
+
+	/**
+	 * Calls func for every opaque pixel of source that land inside of area of destination.
+	 * Gives same result as `ShaderDraw` with function that skip zero source pixels.
+	 * @param dest Destination surface.
+	 * @param src Source surface, spans need be built from it.
+	 * @param x X position of source in destination.
+	 * @param y Y position of source in destination.
+	 * @param area Part of destination that can be changed.
+	 * @param func Function called with destination and source pixel.
+	 */
+	template<typename Func>
+	void draw(SurfaceRaw<Uint8> dest, SurfaceRaw<const Uint8> src, int x, int y, GraphSubset area, Func&& func) const
+	{
+		area = GraphSubset::intersection(area, GraphSubset{ dest.getWidth(), dest.getHeight() }, GraphSubset{ src.getWidth(), src.getHeight() }.offset(x, y));
+		if (area.size_x() <= 0 || area.size_y() <= 0)
+		{
+			return;
+		}
+		const int minX = area.beg_x - x;
+		const int maxX = area.end_x - x;
+		for (int srcY = area.beg_y - y; srcY < area.end_y - y; ++srcY)
+		{
+			const Uint8* srcRow = (const Uint8*)((const char*)src.getBuffer() + srcY * src.getPitch());
+			Uint8* destRow = (Uint8*)((char*)dest.getBuffer() + (srcY + y) * dest.getPitch()) + x;
+			for (const Span* span = rowBegin(srcY), *end = rowEnd(srcY); span != end; ++span)
+			{
+				const int begin = std::max<int>(span->x, minX);
+				const int last = std::min<int>(span->x + span->length, maxX);
+				for (int i = begin; i < last; ++i)
+				{
+					func(destRow[i], srcRow[i]);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Calls rowFunc for part of every row between its first and last opaque pixel that land inside of area of destination.
+	 * Used with row kernels that skip transparent pixels by themselves, gaps between spans are cheaper to process than to split.
+	 * @param dest Destination surface.
+	 * @param src Source surface, spans need be built from it.
+	 * @param x X position of source in destination.
+	 * @param y Y position of source in destination.
+	 * @param area Part of destination that can be changed.
+	 * @param rowFunc Function called with destination row, source row and number of pixels.
+	 */
+	template<typename Func>
+	void drawRows(SurfaceRaw<Uint8> dest, SurfaceRaw<const Uint8> src, int x, int y, GraphSubset area, Func&& rowFunc) const
+	{
+		area = GraphSubset::intersection(area, GraphSubset{ dest.getWidth(), dest.getHeight() }, GraphSubset{ src.getWidth(), src.getHeight() }.offset(x, y));
+		if (area.size_x() <= 0 || area.size_y() <= 0)
+		{
+			return;
+		}
+		const int minX = area.beg_x - x;
+		const int maxX = area.end_x - x;
+		for (int srcY = area.beg_y - y; srcY < area.end_y - y; ++srcY)
+		{
+			const Span* first = rowBegin(srcY);
+			const Span* end = rowEnd(srcY);
+			if (first == end)
+			{
+				continue;
+			}
+			const int begin = std::max<int>(first->x, minX);
+			const int last = std::min<int>((end - 1)->x + (end - 1)->length, maxX);
+			if (begin < last)
+			{
+				const Uint8* srcRow = (const Uint8*)((const char*)src.getBuffer() + srcY * src.getPitch());
+				Uint8* destRow = (Uint8*)((char*)dest.getBuffer() + (srcY + y) * dest.getPitch()) + x;
+				rowFunc(destRow + begin, srcRow + begin, last - begin);
+			}
+		}
+	}
+};
+
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThreadPool.h"
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Set when current thread is executing some job, used to detect nested calls.
+thread_local bool insideJob = false;
+
+}
+
+/**
+ * Creates pool and starts its threads.
+ * @param threads Number of threads in addition to calling thread.
+ */
+ThreadPool::ThreadPool(size_t threads) : _job(nullptr), _jobSize(0), _jobId(0), _pending(0), _next(0), _stop(false)
+{
+	_threads.reserve(threads);
+	for (size_t i = 0; i < threads; ++i)
+	{
+		_threads.emplace_back(&ThreadPool::workerLoop, this, i + 1);
+	}
+}
+
+/**
+ * Stops and joins all threads.
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wakeUp.notify_all();
+	for (auto& t : _threads)
+	{
+		t.join();
+	}
+}
+
+/**
+ * Waits for new jobs and helps with them until pool is stopped.
+ * @param worker Index of this worker.
+ */
+void ThreadPool::workerLoop(size_t worker)
+{
+	size_t lastJob = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeUp.wait(lock, [&]{ return _stop || _jobId != lastJob; });
+			if (_stop)
+			{
+				return;
+			}
+			lastJob = _jobId;
+		}
+
+		runJob(worker);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_pending;
+		}
+		_done.notify_one();
+	}
+}
+
+/**
+ * Takes items of current job one by one. First exception is stored and rest of items is skipped.
+ * @param worker Index of this worker.
+ */
+void ThreadPool::runJob(size_t worker)
+{
+	insideJob = true;
+	size_t i;
+	while ((i = _next.fetch_add(1)) < _jobSize)
+	{
+		try
+		{
+			(*_job)(i, worker);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_error)
+			{
+				_error = std::current_exception();
+			}
+			_next = _jobSize;
+		}
+	}
+	insideJob = false;
+}
+
+/**
+ * Calls func for each index, calls are spread over all workers in any order.
+ * When called from inside of other job or when pool is busy with other caller, everything is done on current thread.
+ * Exception thrown by any call is rethrown here after all workers finish.
+ * @param size Number of items.
+ * @param func Function to call for every item.
+ */
+void ThreadPool::parallelFor(size_t size, const JobFunc& func)
+{
+	std::unique_lock<std::mutex> call(_callMutex, std::defer_lock);
+	if (size <= 1 || _threads.empty() || insideJob || !call.try_lock())
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			func(i, 0);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_job = &func;
+		_jobSize = size;
+		_next = 0;
+		_error = nullptr;
+		_pending = _threads.size();
+		++_jobId;
+	}
+	_wakeUp.notify_all();
+
+	runJob(0);
+
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [&]{ return _pending == 0; });
+		_job = nullptr;
+		_jobSize = 0;
+		error = _error;
+		_error = nullptr;
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+/**
+ * Gets pool shared by the whole game. Created on first use.
+ * Option `oxceWorkerThreads` set total number of threads, 0 means one per hardware thread and 1 disable workers.
+ * @return Global pool.
+ */
+ThreadPool& ThreadPool::getGlobal()
+{
+	static ThreadPool pool([]
+	{
+		size_t total = Options::oxceWorkerThreads > 0 ? Options::oxceWorkerThreads : std::thread::hardware_concurrency();
+		return total > 1 ? total - 1 : 0;
+	}());
+	return pool;
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Persistent set of worker threads used to split heavy calculations.
+ * Calling thread always take part in work, so pool with zero threads run everything serially.
+ * Jobs can't start other jobs, nested calls run serially on the current thread.
+ */
+class ThreadPool
+{
+public:
+	/// Job function, take index of item and index of worker (0 is calling thread) that can be used to select scratch buffers.
+	using JobFunc = std::function<void(size_t index, size_t worker)>;
+
+private:
+	std::vector<std::thread> _threads;
+	std::mutex _callMutex;
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	std::condition_variable _done;
+	const JobFunc* _job;
+	size_t _jobSize;
+	size_t _jobId;
+	size_t _pending;
+	std::atomic<size_t> _next;
+	std::exception_ptr _error;
+	bool _stop;
+
+	/// Main loop of worker thread.
+	void workerLoop(size_t worker);
+	/// Process items of current job until there is nothing left.
+	void runJob(size_t worker);
+
+public:
+	/// Creates pool with given number of additional threads.
+	explicit ThreadPool(size_t threads);
+	/// Stops all threads.
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// Number of workers including calling thread.
+	size_t getWorkerCount() const { return _threads.size() + 1; }
+	/// Calls func for every index in [0, size), return when all calls are finished.
+	void parallelFor(size_t size, const JobFunc& func);
+
+	/// Gets pool shared by whole game, size is controlled by `oxceWorkerThreads` option.
+	static ThreadPool& getGlobal();
+};
+
+}
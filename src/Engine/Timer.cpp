@@ -243,12 +243,6 @@ void ProgressTimerSystem::callComplete(entt::entity entity, ProgressTimerCompone
 	}
 }
 
-/**
- * Updates the time system.
- */
-void IntervalTimerSystem::update()
-{
-}
 
 
 }
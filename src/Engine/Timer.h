@@ -21,10 +21,13 @@
 #include <chrono>
 #include "State.h"
 #include "Surface.h"
+#include "../Entity/Engine/SystemScheduler.h"
 
 namespace OpenXcom
 {
 
+struct WindowComponent;
+
 using StateHandler = std::function<void()>;
 using SurfaceHandler = std::function<void()>;
 
@@ -82,6 +85,9 @@ private:
 	uint64_t _frameTime;
 
 public:
+	/// Only own clock is changed, systems that use it declare that they read TimeSystem.
+	using Writes = SystemAccess<>;
+
 	TimeSystem();
 	~TimeSystem() = default;
 
@@ -167,6 +173,10 @@ protected:
 	void callComplete(entt::entity entity, ProgressTimerComponent& component);
 
 public:
+	/// Callbacks only update popup step of windows, new callback need add what it change there.
+	using Reads = SystemAccess<TimeSystem>;
+	using Writes = SystemAccess<ProgressTimerComponent, WindowComponent>;
+
 	ProgressTimerSystem(entt::registry& registry, const TimeSystem& timeSystem);
 	~ProgressTimerSystem() = default;
 
@@ -197,8 +207,6 @@ class IntervalTimerSystem
 public:
 	IntervalTimerSystem() = default;
 	~IntervalTimerSystem() = default;
-
-	void update();
 };
 
 
@@ -0,0 +1,278 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "YamlBinary.h"
+
+namespace OpenXcom
+{
+
+namespace YamlBinary
+{
+
+/**
+ * Appends variable length unsigned number, 7 bits per byte, lowest first.
+ * @param data Output data.
+ * @param value Number to store.
+ */
+void writeVarint(std::vector<char> &data, Uint64 value)
+{
+	while (value >= 0x80)
+	{
+		data.push_back((char)((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	data.push_back((char)value);
+}
+
+/**
+ * Reads variable length unsigned number.
+ * @param data Input data.
+ * @param offset Position of number, moved after it.
+ * @param value Read number.
+ * @return False if data end before number or number is too long.
+ */
+bool readVarint(const std::vector<char> &data, size_t &offset, Uint64 &value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (offset >= data.size())
+		{
+			return false;
+		}
+		const Uint8 byte = (Uint8)data[offset++];
+		value |= Uint64(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Appends string prefixed by its size.
+ * @param data Output data.
+ * @param s String to store.
+ */
+void writeString(std::vector<char> &data, const std::string &s)
+{
+	writeVarint(data, s.size());
+	data.insert(data.end(), s.begin(), s.end());
+}
+
+/**
+ * Skips string without reading it.
+ * @param data Input data.
+ * @param offset Position of string, moved after it.
+ * @return False if data end before string.
+ */
+bool skipString(const std::vector<char> &data, size_t &offset)
+{
+	Uint64 size;
+	if (!readVarint(data, offset, size) || size > data.size() - offset)
+	{
+		return false;
+	}
+	offset += (size_t)size;
+	return true;
+}
+
+/**
+ * Reads string, data need be validated first.
+ * @param data Input data.
+ * @param offset Position of string, moved after it.
+ * @return Read string.
+ */
+std::string readString(const std::vector<char> &data, size_t &offset)
+{
+	Uint64 size;
+	readVarint(data, offset, size);
+	std::string s(data.data() + offset, (size_t)size);
+	offset += (size_t)size;
+	return s;
+}
+
+/**
+ * Appends little endian number.
+ * @param data Output data.
+ * @param value Number to store.
+ * @param bytes Number of bytes to use.
+ */
+void writeFixed(std::vector<char> &data, Uint64 value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		data.push_back((char)(value >> (i * 8)));
+	}
+}
+
+/**
+ * Reads little endian number, caller need check size of data.
+ * @param data Input data.
+ * @param offset Position of number.
+ * @param bytes Number of bytes to read.
+ * @return Read number.
+ */
+Uint64 readFixed(const std::vector<char> &data, size_t offset, int bytes)
+{
+	Uint64 value = 0;
+	for (int i = 0; i < bytes; ++i)
+	{
+		value |= Uint64((Uint8)data[offset + i]) << (i * 8);
+	}
+	return value;
+}
+
+/**
+ * Appends node tree to data.
+ * @param data Output data.
+ * @param node Node to store.
+ */
+void writeNode(std::vector<char> &data, const YAML::Node &node)
+{
+	switch (node.Type())
+	{
+	case YAML::NodeType::Scalar:
+		data.push_back(NK_SCALAR);
+		writeString(data, node.Tag());
+		writeString(data, node.Scalar());
+		break;
+	case YAML::NodeType::Sequence:
+		data.push_back(NK_SEQUENCE);
+		writeString(data, node.Tag());
+		writeVarint(data, node.size());
+		for (const YAML::Node &child : node)
+		{
+			writeNode(data, child);
+		}
+		break;
+	case YAML::NodeType::Map:
+		data.push_back(NK_MAP);
+		writeString(data, node.Tag());
+		writeVarint(data, node.size());
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			writeNode(data, i->first);
+			writeNode(data, i->second);
+		}
+		break;
+	default:
+		data.push_back(NK_NULL);
+		writeString(data, node.IsDefined() ? node.Tag() : std::string());
+		break;
+	}
+}
+
+/**
+ * Creates node tree from data, data need be validated first.
+ * @param data Input data.
+ * @param offset Position of node in data, moved after it.
+ * @return Created node.
+ */
+YAML::Node readNode(const std::vector<char> &data, size_t &offset)
+{
+	const NodeKind kind = (NodeKind)data[offset++];
+	const std::string tag = readString(data, offset);
+	YAML::Node node;
+	Uint64 count;
+	switch (kind)
+	{
+	case NK_SCALAR:
+		node = YAML::Node(readString(data, offset));
+		break;
+	case NK_SEQUENCE:
+		node = YAML::Node(YAML::NodeType::Sequence);
+		readVarint(data, offset, count);
+		for (Uint64 i = 0; i < count; ++i)
+		{
+			node.push_back(readNode(data, offset));
+		}
+		break;
+	case NK_MAP:
+		node = YAML::Node(YAML::NodeType::Map);
+		readVarint(data, offset, count);
+		for (Uint64 i = 0; i < count; ++i)
+		{
+			YAML::Node key = readNode(data, offset);
+			YAML::Node value = readNode(data, offset);
+			node.force_insert(key, value);
+		}
+		break;
+	default:
+		node = YAML::Node(YAML::NodeType::Null);
+		break;
+	}
+	if (!tag.empty())
+	{
+		node.SetTag(tag);
+	}
+	return node;
+}
+
+/**
+ * Checks that node tree in data is complete and well formed, without creating any node.
+ * @param data Input data.
+ * @param offset Position of node in data, moved after it.
+ * @param depth Nesting level of node.
+ * @return True if node is valid.
+ */
+bool validateNode(const std::vector<char> &data, size_t &offset, int depth)
+{
+	if (depth > MaxDepth || offset >= data.size())
+	{
+		return false;
+	}
+	const NodeKind kind = (NodeKind)data[offset++];
+	if (!skipString(data, offset))
+	{
+		return false;
+	}
+	Uint64 count;
+	switch (kind)
+	{
+	case NK_NULL:
+		return true;
+	case NK_SCALAR:
+		return skipString(data, offset);
+	case NK_SEQUENCE:
+	case NK_MAP:
+		if (!readVarint(data, offset, count))
+		{
+			return false;
+		}
+		if (kind == NK_MAP)
+		{
+			count *= 2;
+		}
+		for (Uint64 i = 0; i < count; ++i)
+		{
+			if (!validateNode(data, offset, depth + 1))
+			{
+				return false;
+			}
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace YamlBinary
+
+}
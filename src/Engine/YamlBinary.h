@@ -0,0 +1,72 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Compact binary encoding of YAML node trees, used by files that are never edited by hand.
+ * Every node is stored as kind, tag and value, strings and counts are prefixed by varint size.
+ * Encoding is lossless, node tree read back is same as one written (including tags and order of keys).
+ */
+namespace YamlBinary
+{
+
+/// Node types in binary format.
+enum NodeKind : Uint8
+{
+	NK_NULL = 0,
+	NK_SCALAR = 1,
+	NK_SEQUENCE = 2,
+	NK_MAP = 3,
+};
+
+/// Deepest nesting of nodes accepted by validation.
+constexpr int MaxDepth = 256;
+
+/// Appends variable length unsigned number.
+void writeVarint(std::vector<char> &data, Uint64 value);
+/// Reads variable length unsigned number, return false if data end first.
+bool readVarint(const std::vector<char> &data, size_t &offset, Uint64 &value);
+/// Appends string with its size.
+void writeString(std::vector<char> &data, const std::string &s);
+/// Skips string, return false if data end first.
+bool skipString(const std::vector<char> &data, size_t &offset);
+/// Reads string, data need be validated first.
+std::string readString(const std::vector<char> &data, size_t &offset);
+/// Appends little endian number with given number of bytes.
+void writeFixed(std::vector<char> &data, Uint64 value, int bytes);
+/// Reads little endian number with given number of bytes.
+Uint64 readFixed(const std::vector<char> &data, size_t offset, int bytes);
+
+/// Appends node tree to data.
+void writeNode(std::vector<char> &data, const YAML::Node &node);
+/// Creates node tree from data, data need be validated first.
+YAML::Node readNode(const std::vector<char> &data, size_t &offset);
+/// Checks that node tree in data is complete and well formed.
+bool validateNode(const std::vector<char> &data, size_t &offset, int depth = 0);
+
+}
+
+}
@@ -23,6 +23,7 @@
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "ThreadPool.h"
 
 #include "OpenGL.h"
 
@@ -61,6 +62,32 @@
 namespace OpenXcom
 {
 
+/**
+ * Smallest number of source rows scaled by one job, xBRZ and hqx read some rows around
+ * each slice so too thin slices waste work.
+ */
+static const int MinBandHeight = 16;
+
+/**
+ * Splits source image into bands of rows and scales them on all worker threads.
+ * Scaler need write only destination rows of its own band.
+ * @param height Number of source rows.
+ * @param func Function scaling source rows [yFirst, yLast).
+ */
+static void scaleInBands(int height, const std::function<void(int yFirst, int yLast)>& func)
+{
+	ThreadPool& pool = ThreadPool::getGlobal();
+	const int bands = std::min(height / MinBandHeight, (int)pool.getWorkerCount() * 2);
+	if (bands <= 1)
+	{
+		func(0, height);
+		return;
+	}
+	pool.parallelFor(bands, [&](size_t index, size_t worker)
+	{
+		func(height * (int)index / bands, height * ((int)index + 1) / bands);
+	});
+}
 
 /**
  * Optimized 8-bit zoomer for resizing by a factor of 2. Doesn't flip.
@@ -738,7 +765,10 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			{
 				if (dst->w == src->w * (int)factor && dst->h == src->h * (int)factor)
 				{
-					xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB);
+					scaleInBands(src->h, [&](int yFirst, int yLast)
+					{
+						xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB, xbrz::ScalerCfg(), yFirst, yLast);
+					});
 					return 0;
 				}
 			}
@@ -758,19 +788,28 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 
 			if (dst->w == src->w * 2 && dst->h == src->h * 2)
 			{
-				hq2x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq2x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 
 			if (dst->w == src->w * 3 && dst->h == src->h * 3)
 			{
-				hq3x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq3x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 
 			if (dst->w == src->w * 4 && dst->h == src->h * 4)
 			{
-				hq4x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq4x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 		}
@@ -783,7 +822,10 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 		{
 			if (dst->w == src->w * (int)factor && dst->h == src->h * factor && !scale_precondition(factor, src->format->BytesPerPixel, src->w, src->h))
 			{
-				scale(factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+				scaleInBands(src->h, [&](int yFirst, int yLast)
+				{
+					scale_slice(factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 		}
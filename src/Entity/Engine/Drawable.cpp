@@ -99,8 +99,4 @@ void DrawableSystem::draw(entt::handle& entity)
 	}
 }
 
-void DrawableSystem::update()
-{
-}
-
 } // namespace OpenXcom
@@ -47,8 +47,6 @@ public:
 	~DrawableSystem();
 
 	void draw(entt::handle& entity);
-
-	void update();
 };
 
 } // namespace OpenXcom
@@ -42,7 +42,8 @@ ECS::ECS()
 	// ---
 	// Systems
 	// 
-	// Systems are updated in the order that they are registered.
+	// Systems are updated in the order that they are registered, systems that declare
+	// what components they use (see SystemAccess) can run at same time as others.
 	{
 		// KN NOTE: I don't think we need these anymore
 		registerSystem<TickableSystem>();
@@ -85,15 +86,8 @@ void ECS::setMod(Mod* mod)
 
 void ECS::update()
 {
-	// Update all systems
-	for (std::pair<const std::type_index, TypeErasedUpdatePtr>& pair : _systemRegistry)
-	{
-		TypeErasedUpdatePtr& system = pair.second;
-		if (system.hasUpdate())
-		{
-			system.update();
-		}
-	}
+	// Update all systems, in registration order or in parallel when they do not conflict
+	_systemScheduler.update();
 }
 
 } // namespace OpenXcom
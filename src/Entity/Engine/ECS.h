@@ -19,6 +19,7 @@
  */
 #include "../../Engine/Registry.h"
 #include "../../Engine/TypeErasedPtr.h"
+#include "SystemScheduler.h"
 
 #include <unordered_map>
 #include <typeindex>
@@ -36,6 +37,7 @@ protected:
 
 	using SystemRegistryContainer = std::unordered_map<std::type_index, TypeErasedUpdatePtr>;
 	SystemRegistryContainer _systemRegistry;
+	SystemScheduler _systemScheduler;
 
 	template <typename SystemType, typename... Args>
 	inline SystemType& registerSystem(Args&&... args);
@@ -74,6 +76,10 @@ inline SystemType& ECS::registerSystem(Args&&... args)
 {
 	TypeErasedUpdatePtr ptr(new SystemType(std::forward<Args>(args)...));
 	auto [it, inserted] = _systemRegistry.emplace(std::type_index(typeid(SystemType)), std::move(ptr));
+	if (inserted)
+	{
+		_systemScheduler.add<SystemType>(it->second);
+	}
 	return it->second.get<SystemType>();
 }
 
@@ -17,7 +17,11 @@
  * You should have received a copy of the GNU General Public License
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <mutex>
+#include <vector>
 #include <entt/entt.hpp>
+#include "SystemScheduler.h"
 #include "../Common/GeoPosition.h"
 #include "../../Mod/RuleCountry.h"
 #include "../../Mod/RuleRegion.h"
@@ -30,6 +34,26 @@ class GeoSystem
 {
 	entt::registry& _registry;
 
+	/**
+	 * @brief finds the first area entity that contains location, if any
+	 * @tparam Area the type of area to find, either Region or Country
+	 * @param areaView view of all areas of that type
+	 * @param position the position to search for
+	 * @return the first area with a matching point, or nullptr if not found
+	 */
+	template<typename Area, typename AreaView>
+	entt::handle locate(AreaView& areaView, const GeoPosition& position)
+	{
+		auto areas = areaView.each();
+
+		auto containsPoint = [&position](const std::tuple<entt::entity, Area&>& each) {
+			return std::get<1>(each).getRules()->contains(position.longitude, position.latitude);
+			};
+
+		auto findResult = std::ranges::find_if(areas, containsPoint);
+		return findResult != areas.end() ? entt::handle(_registry, std::get<0>(*findResult)) : entt::handle();
+	}
+
 public:
 	GeoSystem(entt::registry& registry) : _registry(registry) { }
 
@@ -42,35 +66,45 @@ public:
 	template<typename Area>
 	entt::handle locate(const GeoPosition& position)
 	{
-		auto areaView = _registry.view<Area>().each();
-
-		auto containsPoint = [&position](const std::tuple<entt::entity, Area>& each) {
-			return std::get<1>(each).getRules()->contains(position.longitude, position.latitude);
-			};
-
-		auto findResult = std::ranges::find_if(areaView, containsPoint);
-		return findResult != areaView.end() ? entt::handle(_registry, std::get<0>(*findResult)) : entt::handle();
+		auto areaView = _registry.view<Area>();
+		return locate<Area>(areaView, position);
 	}
 
 	/**
 	 * @brief Updates the current region and country value for all geopositions.
+	 * Areas are located on worker threads, update signals are sent after that on current thread.
 	 */
 	void updateAllRegionsAndCountries()
 	{
-		for (auto&& [entity, geoPosition] : _registry.view<GeoPosition>().each())
-		{
-			entt::handle currentCountry = geoPosition.country;
-			entt::handle currentRegion  = geoPosition.region;
+		// making view can add storage to registry, so it is not done by workers
+		auto countries = _registry.view<Country>();
+		auto regions = _registry.view<Region>();
 
-			entt::handle newCountry = locate<Country>(geoPosition);
-			entt::handle newRegion  = locate<Region>(geoPosition);
+		std::mutex changedMutex;
+		std::vector<entt::entity> changed;
+		parallelEach<GeoPosition>(_registry, [&](entt::entity entity, GeoPosition& geoPosition)
+		{
+			entt::handle newCountry = locate<Country>(countries, geoPosition);
+			entt::handle newRegion  = locate<Region>(regions, geoPosition);
 
-			if ((currentCountry.entity() != newCountry.entity()) || (currentRegion.entity() != newRegion.entity()))
+			if ((geoPosition.country.entity() != newCountry.entity()) || (geoPosition.region.entity() != newRegion.entity()))
 			{
 				geoPosition.country = newCountry;
 				geoPosition.region  = newRegion;
-				_registry.replace<GeoPosition>(entity, geoPosition);
+				std::lock_guard<std::mutex> lock(changedMutex);
+				changed.push_back(entity);
 			}
+		});
+
+		// same order as serial loop over view, it goes from last to first element of storage
+		auto& storage = _registry.storage<GeoPosition>();
+		std::sort(changed.begin(), changed.end(), [&storage](entt::entity a, entt::entity b)
+		{
+			return storage.index(a) > storage.index(b);
+		});
+		for (entt::entity entity : changed)
+		{
+			_registry.patch<GeoPosition>(entity);
 		}
 	}
 };
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SystemScheduler.h"
+#include <algorithm>
+#include <cstdlib>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+#include "../../Engine/Game.h"
+#include "../../Engine/Options.h"
+#include "../../Engine/Profiler.h"
+#include "../../Engine/ThreadPool.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Gets name of type that can be shown to user. GCC and Clang give mangled names
+ * like `N8OpenXcom10TimeSystemE`, MSVC gives `class OpenXcom::TimeSystem`.
+ * @param type Type info.
+ * @return Name without namespace, class keyword and mangling.
+ */
+std::string getReadableTypeName(const std::type_info& type)
+{
+	std::string name = type.name();
+#ifdef __GNUC__
+	int status = 0;
+	char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+	if (status == 0 && demangled)
+	{
+		name = demangled;
+	}
+	std::free(demangled);
+#endif
+	for (const char* prefix : { "class ", "struct ", "OpenXcom::" })
+	{
+		const std::string p = prefix;
+		if (name.compare(0, p.size(), p) == 0)
+		{
+			name.erase(0, p.size());
+		}
+	}
+	return name;
+}
+
+/**
+ * Checks if two systems can't run at same time.
+ * @param a First system.
+ * @param b Second system.
+ * @return True if any of them writes something that other one use.
+ */
+bool SystemScheduler::conflicts(const Entry& a, const Entry& b)
+{
+	if (a.exclusive || b.exclusive)
+	{
+		return true;
+	}
+	auto intersects = [](const std::vector<std::type_index>& x, const std::vector<std::type_index>& y)
+	{
+		for (const auto& t : x)
+		{
+			if (std::find(y.begin(), y.end(), t) != y.end())
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+	return intersects(a.writes, b.writes) || intersects(a.writes, b.reads) || intersects(a.reads, b.writes);
+}
+
+/**
+ * Adds system to scheduler, it will run after all conflicting systems added before.
+ * System always writes its own type, so other system can declare that it reads it.
+ * @param type Type of system.
+ * @param name Name used for profiler zone, need to live as long as program.
+ * @param system System, must live as long as scheduler.
+ * @param reads Types that system reads.
+ * @param writes Types that system writes.
+ * @param exclusive System can touch anything.
+ */
+void SystemScheduler::add(std::type_index type, const char* name, TypeErasedUpdatePtr& system, std::vector<std::type_index> reads, std::vector<std::type_index> writes, bool exclusive)
+{
+	if (!system.hasUpdate())
+	{
+		return;
+	}
+	writes.push_back(type);
+	_entries.push_back(Entry{ type, name, &system, std::move(reads), std::move(writes), exclusive });
+	_dirty = true;
+}
+
+/**
+ * Splits systems to stages, system is put in stage after last stage
+ * that have any system it conflicts with.
+ */
+void SystemScheduler::build()
+{
+	_stages.clear();
+	std::vector<size_t> stageOf(_entries.size());
+	for (size_t i = 0; i < _entries.size(); ++i)
+	{
+		size_t stage = 0;
+		for (size_t j = 0; j < i; ++j)
+		{
+			if (conflicts(_entries[i], _entries[j]))
+			{
+				stage = std::max(stage, stageOf[j] + 1);
+			}
+		}
+		stageOf[i] = stage;
+		if (stage == _stages.size())
+		{
+			_stages.emplace_back();
+		}
+		_stages[stage].push_back(i);
+	}
+	_dirty = false;
+}
+
+/**
+ * Gets indexes of systems in every stage.
+ * @return List of stages, each one have systems in registration order.
+ */
+const std::vector<std::vector<size_t>>& SystemScheduler::getStages()
+{
+	if (_dirty)
+	{
+		build();
+	}
+	return _stages;
+}
+
+/**
+ * Runs update of all systems stage by stage. Systems in one stage run on worker threads,
+ * stage with single system runs on current thread so workers are not woken up for it.
+ * Systems without update (most engine ones) are not in any stage.
+ * When option `oxceParallelSystems` is off all run on current thread in registration order.
+ */
+void SystemScheduler::update()
+{
+	if (!Options::oxceParallelSystems)
+	{
+		for (auto& entry : _entries)
+		{
+			OXCE_PROFILE_ZONE(entry.name);
+			entry.system->update();
+		}
+		return;
+	}
+
+	Game* game = getGame();
+	for (const auto& stage : getStages())
+	{
+		if (stage.size() == 1)
+		{
+			OXCE_PROFILE_ZONE(_entries[stage.front()].name);
+			_entries[stage.front()].system->update();
+			continue;
+		}
+		ThreadPool::getGlobal().parallelFor(stage.size(), [&](size_t index, size_t)
+		{
+			setThreadLocalGame(game);
+			OXCE_PROFILE_ZONE(_entries[stage[index]].name);
+			_entries[stage[index]].system->update();
+		});
+	}
+}
+
+} // namespace OpenXcom
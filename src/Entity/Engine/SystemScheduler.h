@@ -0,0 +1,153 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "../../Engine/ThreadPool.h"
+#include "../../Engine/TypeErasedPtr.h"
+
+#include <algorithm>
+#include <entt/entt.hpp>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * List of types (components or other systems) that system use.
+ * System declare them as `using Reads = SystemAccess<...>;` and `using Writes = SystemAccess<...>;`.
+ * System that declare neither of them can touch anything and never run at same time as other systems.
+ */
+template <typename... Types>
+struct SystemAccess
+{
+	static std::vector<std::type_index> get() { return { std::type_index(typeid(Types))... }; }
+};
+
+/// Gets types that system reads, `declared` is false if system do not have `Reads`.
+template <typename SystemType, typename = void>
+struct SystemReads
+{
+	static constexpr bool declared = false;
+	static std::vector<std::type_index> get() { return { }; }
+};
+
+template <typename SystemType>
+struct SystemReads<SystemType, std::void_t<typename SystemType::Reads>>
+{
+	static constexpr bool declared = true;
+	static std::vector<std::type_index> get() { return SystemType::Reads::get(); }
+};
+
+/// Gets types that system writes, `declared` is false if system do not have `Writes`.
+template <typename SystemType, typename = void>
+struct SystemWrites
+{
+	static constexpr bool declared = false;
+	static std::vector<std::type_index> get() { return { }; }
+};
+
+template <typename SystemType>
+struct SystemWrites<SystemType, std::void_t<typename SystemType::Writes>>
+{
+	static constexpr bool declared = true;
+	static std::vector<std::type_index> get() { return SystemType::Writes::get(); }
+};
+
+/// Gets type name without compiler mangling and namespace, like `TimeSystem`.
+std::string getReadableTypeName(const std::type_info& type);
+
+/// Gets readable name of system, it lives as long as program so it can be used as profiler zone name.
+template <typename SystemType>
+const char* getSystemName()
+{
+	static const std::string name = getReadableTypeName(typeid(SystemType));
+	return name.c_str();
+}
+
+/**
+ * Runs updates of systems. Systems are split to stages, system goes to first stage after every
+ * earlier registered system that it conflicts with (one writes what other one reads or writes).
+ * Systems in one stage run on worker threads, so result is always same as when run one by one
+ * in registration order.
+ */
+class SystemScheduler
+{
+	struct Entry
+	{
+		std::type_index type;
+		const char* name;
+		TypeErasedUpdatePtr* system;
+		std::vector<std::type_index> reads, writes;
+		bool exclusive;
+	};
+
+	std::vector<Entry> _entries;
+	std::vector<std::vector<size_t>> _stages;
+	bool _dirty = false;
+
+	/// Checks if two systems can't run at same time.
+	static bool conflicts(const Entry& a, const Entry& b);
+	/// Splits systems to stages.
+	void build();
+
+public:
+	/// Adds system with given access, system without update function is ignored.
+	void add(std::type_index type, const char* name, TypeErasedUpdatePtr& system, std::vector<std::type_index> reads, std::vector<std::type_index> writes, bool exclusive);
+
+	/// Adds system, access is taken from its `Reads` and `Writes` declarations.
+	template <typename SystemType>
+	void add(TypeErasedUpdatePtr& system)
+	{
+		add(std::type_index(typeid(SystemType)), getSystemName<SystemType>(), system, SystemReads<SystemType>::get(), SystemWrites<SystemType>::get(), !SystemReads<SystemType>::declared && !SystemWrites<SystemType>::declared);
+	}
+
+	/// Gets indexes of systems (in registration order) in every stage.
+	const std::vector<std::vector<size_t>>& getStages();
+
+	/// Runs update of all systems.
+	void update();
+};
+
+/**
+ * Calls function for every entity that has all given components, entities are split to chunks
+ * that are processed on worker threads. Function get entity and its components and must not
+ * touch other entities or change registry structure.
+ * @param registry Registry with entities.
+ * @param func Function to call, `func(entity, components&...)`.
+ * @param chunkSize Number of entities processed by one job, fewer entities run on current thread.
+ */
+template <typename... Components, typename Func>
+void parallelEach(entt::registry& registry, Func&& func, size_t chunkSize = 256)
+{
+	auto view = registry.view<Components...>();
+	std::vector<entt::entity> entities(view.begin(), view.end());
+	const size_t chunks = (entities.size() + chunkSize - 1) / chunkSize;
+	ThreadPool::getGlobal().parallelFor(chunks, [&](size_t chunk, size_t)
+	{
+		const size_t end = std::min(entities.size(), (chunk + 1) * chunkSize);
+		for (size_t i = chunk * chunkSize; i < end; ++i)
+		{
+			func(entities[i], view.template get<Components>(entities[i])...);
+		}
+	});
+}
+
+} // namespace OpenXcom
@@ -67,8 +67,4 @@ void TickableSystem::tick(entt::entity& entity)
 	}
 }
 
-void TickableSystem::update()
-{
-}
-
 } // namespace OpenXcom
@@ -50,8 +50,6 @@ public:
 	~TickableSystem();
 
 	void tick(entt::entity& entity);
-
-	void update();
 };
 
 } // namespace OpenXcom
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include "GeoIndex.h"
+#include "../fmath.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates empty index.
+ */
+GeoIndex::GeoIndex() : _cells(CellsLon * CellsLat), _size(0)
+{
+
+}
+
+/**
+ * Gets column of grid cell that contains longitude.
+ * @param lon Longitude, any range.
+ * @return Column of cell.
+ */
+int GeoIndex::getColumn(double lon)
+{
+	lon = std::fmod(lon, 2 * M_PI);
+	if (lon < 0)
+	{
+		lon += 2 * M_PI;
+	}
+	return std::clamp((int)(Rad2Deg(lon) / CellSize), 0, CellsLon - 1);
+}
+
+/**
+ * Gets row of grid cell that contains latitude.
+ * @param lat Latitude.
+ * @return Row of cell.
+ */
+int GeoIndex::getRow(double lat)
+{
+	return std::clamp((int)std::floor((Rad2Deg(lat) + 90) / CellSize), 0, CellsLat - 1);
+}
+
+/**
+ * Drops all points, only cells that were used are touched.
+ */
+void GeoIndex::clear()
+{
+	for (int cell : _used)
+	{
+		_cells[cell].clear();
+	}
+	_used.clear();
+	_size = 0;
+}
+
+/**
+ * Adds point to index.
+ * @param id Id of point returned by queries, usually index in some list.
+ * @param lon Longitude of point.
+ * @param lat Latitude of point.
+ */
+void GeoIndex::insert(int id, double lon, double lat)
+{
+	int cell = getRow(lat) * CellsLon + getColumn(lon);
+	if (_cells[cell].empty())
+	{
+		_used.push_back(cell);
+	}
+	_cells[cell].push_back(id);
+	++_size;
+}
+
+/**
+ * Gets ids of all points that can be in given distance from point. Result is conservative,
+ * it contains every point in range and some that are slightly out of it, so caller still need
+ * test exact distance. Ids are sorted, so iterating them keeps order of original list.
+ * @param lon Longitude of center.
+ * @param lat Latitude of center.
+ * @param radius Angular distance in radians, same as `Target::getDistance`.
+ * @param result Ids of points near center.
+ */
+void GeoIndex::query(double lon, double lat, double radius, std::vector<int>& result) const
+{
+	result.clear();
+	if (_size == 0 || radius < 0)
+	{
+		return;
+	}
+
+	radius += 1e-6;
+	const double latMin = lat - radius;
+	const double latMax = lat + radius;
+
+	// max difference of longitude of points in cap around center, if cap do not cover pole
+	double lonSpan = M_PI;
+	if (latMin > -M_PI_2 && latMax < M_PI_2)
+	{
+		lonSpan = std::asin(std::min(1.0, std::sin(radius) / std::cos(lat)));
+	}
+
+	int colFirst = 0, colCount = CellsLon;
+	if (lonSpan < M_PI)
+	{
+		colFirst = getColumn(lon - lonSpan);
+		colCount = std::min(CellsLon, (getColumn(lon + lonSpan) - colFirst + CellsLon) % CellsLon + 1);
+	}
+
+	for (int y = getRow(latMin); y <= getRow(latMax); ++y)
+	{
+		for (int i = 0; i < colCount; ++i)
+		{
+			const auto& cell = _cells[y * CellsLon + (colFirst + i) % CellsLon];
+			result.insert(result.end(), cell.begin(), cell.end());
+		}
+	}
+	std::sort(result.begin(), result.end());
+}
+
+}
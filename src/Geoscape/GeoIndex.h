@@ -0,0 +1,60 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+namespace OpenXcom
+{
+
+/**
+ * Spatial index of points on globe, used to find targets near some point without checking all of them.
+ * Globe is split to grid of latitude/longitude cells, each cell has list of ids of points in it.
+ * Index is cheap to rebuild, so it is filled again from current positions every time it is needed.
+ */
+class GeoIndex
+{
+	/// Size of grid cell in degrees.
+	static constexpr int CellSize = 10;
+	static constexpr int CellsLon = 360 / CellSize;
+	static constexpr int CellsLat = 180 / CellSize;
+
+	std::vector<std::vector<int>> _cells;
+	std::vector<int> _used;
+	size_t _size;
+
+	/// Gets column of cell that contains longitude.
+	static int getColumn(double lon);
+	/// Gets row of cell that contains latitude.
+	static int getRow(double lat);
+
+public:
+	/// Creates empty index.
+	GeoIndex();
+
+	/// Drops all points.
+	void clear();
+	/// Adds point with given id.
+	void insert(int id, double lon, double lat);
+	/// Number of points in index.
+	size_t size() const { return _size; }
+	/// Gets ids of all points that can be in given distance from point.
+	void query(double lon, double lat, double radius, std::vector<int>& result) const;
+};
+
+}
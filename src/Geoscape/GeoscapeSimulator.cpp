@@ -0,0 +1,186 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GeoscapeSimulator.h"
+#include <iomanip>
+#include "GeoscapeState.h"
+#include "../Engine/Game.h"
+#include "../Engine/Options.h"
+#include "../Savegame/GameTime.h"
+#include "../Savegame/SavedGame.h"
+#include "../fallthrough.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+const char* const PhaseNames[GeoscapeSimulator::PHASE_MAX] =
+{
+	"5 seconds",
+	"10 minutes",
+	"30 minutes",
+	"1 hour",
+	"1 day",
+	"1 month",
+	"quiet skip",
+	"discard events",
+};
+
+/// Converts clock duration to milliseconds.
+double toMs(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double, std::milli>(d).count();
+}
+
+} //namespace
+
+/**
+ * Creates simulator and replaces all game states by new geoscape.
+ * Geoscape is initialized like in the game loop, this runs first month setup of new games.
+ * @param game Pointer to the core game, with mod and saved game loaded.
+ */
+GeoscapeSimulator::GeoscapeSimulator(Game* game) : _game(game), _geo(new GeoscapeState)
+{
+	_game->setState(_geo);
+	_geo->init();
+}
+
+/**
+ * Runs function and adds its time to the phase.
+ * @param phase Phase to update.
+ * @param func Function to run.
+ */
+template<typename F>
+void GeoscapeSimulator::measure(Phase phase, F&& func)
+{
+	auto start = Clock::now();
+	func();
+	_phaseTime[phase] += Clock::now() - start;
+	_phaseCalls[phase] += 1;
+}
+
+/**
+ * Advances time by one 5 second step and runs every triggered period, like
+ * `GeoscapeState::timeStep()` but with measuring each of them. When scheduler
+ * option is on, quiet steps are skipped same way as in normal game.
+ * After that everything that waits for the player is thrown away.
+ */
+void GeoscapeSimulator::step()
+{
+	if (Options::oxceGeoScheduler > 0)
+	{
+		int quiet = _geo->countQuietSteps(12 * 60 * 24);
+		if (quiet > 0)
+		{
+			measure(PHASE_SKIP, [&]
+			{
+				if (Options::oxceGeoScheduler == 2)
+				{
+					_geo->checkQuietSteps(quiet);
+				}
+				else
+				{
+					_geo->skipQuietSteps(quiet);
+				}
+			});
+			return;
+		}
+	}
+
+	TimeTrigger trigger = _game->getSavedGame()->getTime()->advance();
+	switch (trigger)
+	{
+	case TIME_1MONTH:
+		measure(PHASE_1MONTH, [&]{ _geo->time1Month(); });
+		++_months;
+		FALLTHROUGH;
+	case TIME_1DAY:
+		measure(PHASE_1DAY, [&]{ _geo->time1Day(); });
+		++_days;
+		FALLTHROUGH;
+	case TIME_1HOUR:
+		measure(PHASE_1HOUR, [&]{ _geo->time1Hour(); });
+		FALLTHROUGH;
+	case TIME_30MIN:
+		measure(PHASE_30MIN, [&]{ _geo->time30Minutes(); });
+		FALLTHROUGH;
+	case TIME_10MIN:
+		measure(PHASE_10MIN, [&]{ _geo->time10Minutes(); });
+		FALLTHROUGH;
+	case TIME_5SEC:
+		measure(PHASE_5SEC, [&]{ _geo->time5Seconds(); });
+	}
+
+	measure(PHASE_EVENTS, [&]
+	{
+		_discarded += _geo->discardPendingEvents();
+		while (_game->getState() != _geo)
+		{
+			_game->popState();
+			++_discarded;
+		}
+		_game->deletePoppedStates();
+	});
+}
+
+/**
+ * Runs simulation until given number of month ends pass or game ends.
+ * @param months Number of months to simulate.
+ */
+void GeoscapeSimulator::run(int months)
+{
+	auto start = Clock::now();
+	int end = _months + months;
+	while (_months < end && _game->getSavedGame()->getEnding() == END_NONE)
+	{
+		step();
+	}
+	_totalTime += Clock::now() - start;
+}
+
+/**
+ * Writes total time, time per simulated day and times of all phases.
+ * @param out Output stream.
+ */
+void GeoscapeSimulator::report(std::ostream& out) const
+{
+	double total = toMs(_totalTime);
+	out << std::fixed << std::setprecision(3);
+	out << "Simulated " << _days << " days (" << _months << " months) in " << total << " ms";
+	if (_days > 0)
+	{
+		out << ", " << total / _days << " ms per day";
+	}
+	out << std::endl;
+	out << "Discarded popups, dogfights and states: " << _discarded << std::endl;
+	out << std::left << std::setw(16) << "phase" << std::right << std::setw(10) << "calls" << std::setw(14) << "total ms" << std::setw(14) << "ms per call" << std::setw(14) << "ms per day" << std::setw(8) << "%" << std::endl;
+	for (int i = 0; i < PHASE_MAX; ++i)
+	{
+		double time = toMs(_phaseTime[i]);
+		out << std::left << std::setw(16) << PhaseNames[i] << std::right << std::setw(10) << _phaseCalls[i];
+		out << std::setw(14) << time;
+		out << std::setw(14) << (_phaseCalls[i] > 0 ? time / _phaseCalls[i] : 0.0);
+		out << std::setw(14) << (_days > 0 ? time / _days : 0.0);
+		out << std::setw(8) << std::setprecision(1) << (total > 0 ? 100 * time / total : 0.0) << std::setprecision(3);
+		out << std::endl;
+	}
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <ostream>
+
+namespace OpenXcom
+{
+
+class Game;
+class GeoscapeState;
+
+/**
+ * Runs geoscape time logic without player and without drawing anything.
+ * Popups and dogfights are thrown away as soon as they appear, so battles are
+ * never started. Collects wall time spent in every time period, which can be
+ * used to benchmark mods and to find performance regressions of strategic layer.
+ */
+class GeoscapeSimulator
+{
+public:
+	/// Measured parts of single time step.
+	enum Phase { PHASE_5SEC, PHASE_10MIN, PHASE_30MIN, PHASE_1HOUR, PHASE_1DAY, PHASE_1MONTH, PHASE_SKIP, PHASE_EVENTS, PHASE_MAX };
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	Game* _game;
+	GeoscapeState* _geo;
+	Clock::duration _phaseTime[PHASE_MAX] = { };
+	int _phaseCalls[PHASE_MAX] = { };
+	Clock::duration _totalTime = { };
+	int _days = 0, _months = 0, _discarded = 0;
+
+	/// Runs function and adds its time to the phase.
+	template<typename F>
+	void measure(Phase phase, F&& func);
+	/// Advances time by one 5 second step, or over all following quiet steps.
+	void step();
+
+public:
+	/// Creates simulator for the saved game loaded in the game.
+	GeoscapeSimulator(Game* game);
+	/// Runs simulation for given number of months.
+	void run(int months);
+	/// Number of simulated days.
+	int getDays() const { return _days; }
+	/// Writes times of all phases.
+	void report(std::ostream& out) const;
+};
+
+}
@@ -81,6 +81,7 @@
 #include "../Engine/Surface.h"
 #include "../Engine/Timer.h"
 #include "../Engine/Unicode.h"
+#include "../Engine/Profiler.h"
 #include "../Entity/Engine/GeoSystem.h"
 #include "../fallthrough.h"
 #include "../fmath.h"
@@ -149,7 +150,7 @@ namespace OpenXcom
  * @param game Pointer to the core game.
  */
 GeoscapeState::GeoscapeState()
-	: State("GeoscapeState", true), _pause(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _minimizedDogfights(0), _slowdownCounter(0)
+	: State("GeoscapeState", true), _pause(false), _zoomInEffectDone(false), _zoomOutEffectDone(false), _activeCraftsRadarRange(0), _radarBasesRange(0), _minimizedDogfights(0), _slowdownCounter(0)
 {
 	int screenWidth = Options::baseXGeoscape;
 	int screenHeight = Options::baseYGeoscape;
@@ -879,28 +880,27 @@ void GeoscapeState::timeAdvance()
 
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
-		TimeTrigger trigger;
-		trigger = getGame()->getSavedGame()->getTime()->advance();
-		switch (trigger)
+		if (Options::oxceGeoScheduler > 0)
 		{
-		case TIME_1MONTH:
-			time1Month();
-			FALLTHROUGH;
-		case TIME_1DAY:
-			time1Day();
-			FALLTHROUGH;
-		case TIME_1HOUR:
-			time1Hour();
-			FALLTHROUGH;
-		case TIME_30MIN:
-			time30Minutes();
-			FALLTHROUGH;
-		case TIME_10MIN:
-			time10Minutes();
-			FALLTHROUGH;
-		case TIME_5SEC:
-			time5Seconds();
+			int quiet = countQuietSteps(timeSpan - i);
+			if (quiet > 0)
+			{
+				if (Options::oxceGeoScheduler == 2)
+				{
+					quiet = checkQuietSteps(quiet);
+				}
+				else
+				{
+					quiet = skipQuietSteps(quiet);
+				}
+			}
+			if (quiet > 0)
+			{
+				i += quiet - 1;
+				continue;
+			}
 		}
+		timeStep();
 	}
 
 	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
@@ -910,18 +910,361 @@ void GeoscapeState::timeAdvance()
 }
 
 /**
- * Update list of active crafts.
+ * Advances the game time by one 5 second step and runs
+ * logic of every period that ends with this step.
+ */
+void GeoscapeState::timeStep()
+{
+	TimeTrigger trigger;
+	trigger = getGame()->getSavedGame()->getTime()->advance();
+	switch (trigger)
+	{
+	case TIME_1MONTH:
+		time1Month();
+		FALLTHROUGH;
+	case TIME_1DAY:
+		time1Day();
+		FALLTHROUGH;
+	case TIME_1HOUR:
+		time1Hour();
+		FALLTHROUGH;
+	case TIME_30MIN:
+		time30Minutes();
+		FALLTHROUGH;
+	case TIME_10MIN:
+		time10Minutes();
+		FALLTHROUGH;
+	case TIME_5SEC:
+		time5Seconds();
+	}
+}
+
+namespace
+{
+
+/**
+ * Checks if 5 second step leaves shield of UFO or craft untouched: it is initialized and
+ * it is either full or it does not recharge on geoscape (recharge draws random numbers).
+ */
+template<typename T>
+bool isShieldSteady(const T& target)
+{
+	return target.getShield() != -1 && (target.getShield() >= target.getCraftStats().shieldCapacity || target.getCraftStats().shieldRechargeInGeoscape == 0);
+}
+
+/**
+ * Counts 5 second steps that moving target surely keeps away from its destination.
+ * Arrival is the only event of flying: `MovingTarget::move()` snaps to destination when
+ * it is closer than one step, so the distance must stay above it. Both speeds are doubled
+ * as margin, near poles longitude steps are longer than radian speed.
+ * @param target Moving UFO or craft.
+ * @return Number of steps, INT_MAX if target can't get any closer.
+ */
+int stepsBeforeArrival(const MovingTarget& target)
+{
+	const Target* dest = target.getDestination();
+	if (!dest)
+	{
+		return INT_MAX;
+	}
+	double speed = target.getSpeedRadian();
+	if (const MovingTarget* movingDest = dynamic_cast<const MovingTarget*>(dest))
+	{
+		speed += movingDest->getSpeedRadian();
+	}
+	const double distance = target.getDistance(dest);
+	if (distance <= 2 * speed)
+	{
+		return 0;
+	}
+	if (speed <= 0)
+	{
+		return INT_MAX;
+	}
+	return (int)std::min((distance - 2 * speed) / speed, (double)INT_MAX);
+}
+
+/**
+ * Checks if no UFO or craft reaches its destination during the next 5 second step.
+ */
+bool isNextStepQuiet(const std::vector<Ufo*>& ufos, const std::vector<Craft*>& crafts)
+{
+	for (const Ufo* ufo : ufos)
+	{
+		if (ufo->getStatus() == Ufo::FLYING && stepsBeforeArrival(*ufo) == 0)
+		{
+			return false;
+		}
+	}
+	for (const Craft* craft : crafts)
+	{
+		if (stepsBeforeArrival(*craft) == 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+/**
+ * Counts how many following 5 second steps are quiet. Step is quiet when it do not end
+ * any longer period and `time5Seconds()` would only advance UFOs and crafts by their own
+ * `think()`: nothing arrives, lifts off, expires, starts a dogfight or recharges shields.
+ * Fuel, detection, missions, research, ... run on 10 minute or longer periods that are never skipped,
+ * so the next event is the sooner of the next 10 minute period and the first arrival.
+ * @param limit Max number of steps to check.
+ * @return Number of quiet steps, they can be skipped by `skipQuietSteps()`.
+ */
+int GeoscapeState::countQuietSteps(int limit)
+{
+	if ((_timeSpeed == _btn5Secs || _timeSpeed == _btn1Min) && getGame()->getMod()->getHunterKillerFastRetarget())
+	{
+		return 0;
+	}
+	if (!_dogfights.empty() || !_dogfightsToBeStarted.empty())
+	{
+		return 0;
+	}
+	if (getRegistry().empty<Base>() || getGame()->getSavedGame()->getEnding() == END_LOSE)
+	{
+		return 0;
+	}
+
+	for (Waypoint* way : getGame()->getSavedGame()->getWaypoints())
+	{
+		if (way->getFollowers()->empty())
+		{
+			return 0;
+		}
+	}
+
+	std::vector<Ufo*> ufos;
+	std::vector<Craft*> crafts;
+	getQuietStepTargets(ufos, crafts);
+	return countQuietSteps(*getGame()->getSavedGame()->getTime(), ufos, crafts, limit);
+}
+
+/**
+ * Counts how many following 5 second steps are allowed by the clock, UFOs and crafts:
+ * no longer period ends, no UFO or craft reaches its destination, no landed UFO lifts off,
+ * no crashed UFO expires and no shield recharges.
+ * Distances give only estimate, `skipQuietSteps()` checks arrivals again before every step.
+ * @param time Current game time.
+ * @param ufos All UFOs.
+ * @param crafts All crafts, in order of bases.
+ * @param limit Max number of steps to check.
+ * @return Number of quiet steps.
+ */
+int GeoscapeState::countQuietSteps(const GameTime& time, const std::vector<Ufo*>& ufos, const std::vector<Craft*>& crafts, int limit)
+{
+	// last step before next 10 minute trigger
+	int steps = ((10 - time.getMinute() % 10) * 60 - time.getSecond()) / 5 - 1;
+	steps = std::min(steps, limit);
+
+	for (const Ufo* ufo : ufos)
+	{
+		if (steps <= 0)
+		{
+			return 0;
+		}
+		switch (ufo->getStatus())
+		{
+		case Ufo::FLYING:
+			if (!isShieldSteady(*ufo))
+			{
+				return 0;
+			}
+			steps = std::min(steps, stepsBeforeArrival(*ufo));
+			break;
+		case Ufo::LANDED:
+			// step that lifts UFO is not quiet
+			steps = std::min(steps, (int)(ufo->getSecondsRemaining() / 5) - 1);
+			break;
+		case Ufo::CRASHED:
+			if (ufo->getSecondsRemaining() == 0 || !ufo->getDetected())
+			{
+				return 0;
+			}
+			break;
+		default:
+			return 0;
+		}
+	}
+
+	for (const Craft* craft : crafts)
+	{
+		if (steps <= 0)
+		{
+			return 0;
+		}
+		if (craft->isDestroyed() || !isShieldSteady(*craft))
+		{
+			return 0;
+		}
+		if (const Ufo* ufo = dynamic_cast<const Ufo*>(craft->getDestination()))
+		{
+			// `time5Seconds()` redirects or stops crafts chasing these
+			if (!ufo->getDetected() || ufo->getStatus() == Ufo::DESTROYED || (ufo->getStatus() == Ufo::LANDED && craft->isInDogfight()))
+			{
+				return 0;
+			}
+		}
+		else if (craft->getDestination() && craft->isInDogfight())
+		{
+			return 0;
+		}
+		steps = std::min(steps, stepsBeforeArrival(*craft));
+	}
+	return std::max(steps, 0);
+}
+
+/**
+ * Collects UFOs and crafts in the order `time5Seconds()` handles them.
+ * @param ufos Gets all UFOs.
+ * @param crafts Gets all crafts.
+ */
+void GeoscapeState::getQuietStepTargets(std::vector<Ufo*>& ufos, std::vector<Craft*>& crafts)
+{
+	for (Ufo& ufo : getRegistry().list<Ufo>())
+	{
+		ufos.push_back(&ufo);
+	}
+	for (const Base& xcomBase : getRegistry().list<Base>())
+	{
+		crafts.insert(crafts.end(), xcomBase.getCrafts().begin(), xcomBase.getCrafts().end());
+	}
+}
+
+/**
+ * Jumps over quiet steps, advance clock, UFOs and crafts like `time5Seconds()` would do.
+ * @param steps Number of steps, need be no more than `countQuietSteps()` returned.
+ * @return Number of steps skipped.
+ */
+int GeoscapeState::skipQuietSteps(int steps)
+{
+	std::vector<Ufo*> ufos;
+	std::vector<Craft*> crafts;
+	getQuietStepTargets(ufos, crafts);
+	return skipQuietSteps(*getGame()->getSavedGame()->getTime(), ufos, crafts, steps);
+}
+
+/**
+ * Advances clock, UFOs and crafts by given number of 5 second steps.
+ * Stops early before step where some UFO or craft could reach its destination.
+ * @param time Game time to advance.
+ * @param ufos All UFOs.
+ * @param crafts All crafts, in order of bases.
+ * @param steps Number of steps, need be no more than `countQuietSteps()` returned.
+ * @return Number of steps skipped.
+ */
+int GeoscapeState::skipQuietSteps(GameTime& time, const std::vector<Ufo*>& ufos, const std::vector<Craft*>& crafts, int steps)
+{
+	for (int i = 0; i < steps; ++i)
+	{
+		if (!isNextStepQuiet(ufos, crafts))
+		{
+			return i;
+		}
+		time.advance();
+		for (Ufo* ufo : ufos)
+		{
+			ufo->think();
+		}
+		for (Craft* craft : crafts)
+		{
+			craft->think();
+		}
+	}
+	return steps;
+}
+
+/**
+ * Skips quiet steps, then undoes it and runs same steps normally,
+ * and reports if full saved state differ between the two.
+ * @param steps Number of steps returned by `countQuietSteps()`.
+ * @return Number of steps run.
+ */
+int GeoscapeState::checkQuietSteps(int steps)
+{
+	SavedGame* save = getGame()->getSavedGame();
+	GameTime* time = save->getTime();
+	auto saveState = [&]
+	{
+		YAML::Node node = save->saveState(getGame()->getMod());
+		node["time"] = time->save();
+		return YAML::Dump(node);
+	};
+
+	std::vector<Ufo*> ufos;
+	std::vector<Craft*> crafts;
+	getQuietStepTargets(ufos, crafts);
+
+	// everything skipping can change
+	const GameTime start = *time;
+	std::vector<std::pair<YAML::Node, size_t>> ufoStart;
+	for (const Ufo* ufo : ufos)
+	{
+		ufoStart.push_back(std::make_pair(ufo->MovingTarget::save(), ufo->getSecondsRemaining()));
+	}
+	std::vector<std::pair<YAML::Node, int>> craftStart;
+	for (const Craft* craft : crafts)
+	{
+		craftStart.push_back(std::make_pair(craft->MovingTarget::save(), craft->getTakeoff()));
+	}
+
+	steps = skipQuietSteps(*time, ufos, crafts, steps);
+	const std::string skipped = saveState();
+
+	*time = start;
+	for (size_t i = 0; i < ufos.size(); ++i)
+	{
+		ufos[i]->MovingTarget::load(ufoStart[i].first);
+		ufos[i]->setSecondsRemaining(ufoStart[i].second);
+	}
+	for (size_t i = 0; i < crafts.size(); ++i)
+	{
+		crafts[i]->MovingTarget::load(craftStart[i].first);
+		crafts[i]->setTakeoff(craftStart[i].second);
+	}
+
+	for (int i = 0; i < steps && !_pause; ++i)
+	{
+		timeStep();
+	}
+	const std::string stepped = saveState();
+
+	if (skipped != stepped)
+	{
+		std::istringstream skippedLines(skipped), steppedLines(stepped);
+		std::string skippedLine, steppedLine;
+		while (std::getline(skippedLines, skippedLine) && std::getline(steppedLines, steppedLine) && skippedLine == steppedLine)
+		{
+		}
+		Log(LOG_ERROR) << "Geoscape scheduler: skipping " << steps << " steps would change game state at " << time->getHour() << ":" << time->getMinute() << ":" << time->getSecond()
+			<< ", skipped '" << skippedLine << "' stepped '" << steppedLine << "'";
+	}
+	return steps;
+}
+/**
+ * Update list of active crafts and spatial index of them,
+ * ids in index are positions in list.
  * @return Const pointer to updated list.
  */
 const std::vector<Craft*>& GeoscapeState::updateActiveCrafts()
 {
 	_activeCrafts.clear();
+	_activeCraftsIndex.clear();
+	_activeCraftsRadarRange = 0;
 	for (const Base& xcomBase : getRegistry().list<Base>())
 	{
 		for (Craft* xcraft : xcomBase.getCrafts())
 		{
 			if (xcraft->getStatus() == "STR_OUT" && !xcraft->isDestroyed())
 			{
+				_activeCraftsIndex.insert((int)_activeCrafts.size(), xcraft->getLongitude(), xcraft->getLatitude());
+				_activeCraftsRadarRange = std::max(_activeCraftsRadarRange, xcraft->getCraftStats().radarRange);
 				_activeCrafts.push_back(xcraft);
 			}
 		}
@@ -929,12 +1272,30 @@ const std::vector<Craft*>& GeoscapeState::updateActiveCrafts()
 	return _activeCrafts;
 }
 
+/**
+ * Update list of all bases and spatial index of them, used by UFO detection.
+ * Ids in index are positions in list.
+ */
+void GeoscapeState::updateRadarBases()
+{
+	_radarBases.clear();
+	_radarBasesIndex.clear();
+	_radarBasesRange = 0;
+	for (Base& xcomBase : getRegistry().list<Base>())
+	{
+		_radarBasesIndex.insert((int)_radarBases.size(), xcomBase.getLongitude(), xcomBase.getLatitude());
+		_radarBasesRange = std::max(_radarBasesRange, xcomBase.getMaxRadarRange());
+		_radarBases.push_back(&xcomBase);
+	}
+}
+
 /**
  * Takes care of any game logic that has to
  * run every game second, like craft movement.
  */
 void GeoscapeState::time5Seconds()
 {
+	OXCE_PROFILE_ZONE("GeoscapeState::time5Seconds");
 	// broadcast game.battlescape.PauseState to any listeners
 	//if (!getGame()->getGameScript()->getGeoscapeScript().Broadcast("PauseState"))
 	//{
@@ -1450,6 +1811,7 @@ void GeoscapeState::time5Seconds()
  */
 void GeoscapeState::time10Minutes()
 {
+	OXCE_PROFILE_ZONE("GeoscapeState::time10Minutes");
 	for (Base& xcomBase : getRegistry().list<Base>())
 	{
 		// Fuel consumption for XCOM craft.
@@ -1575,9 +1937,11 @@ void GeoscapeState::ufoHuntingAndEscorting()
 			newAttraction = newTarget->getHunterKillerAttraction(ufo.getHuntMode());
 		}
 
-		// look for more attractive target
-		for (Craft* craft : activeCrafts)
+		// look for more attractive target, only crafts in radar range can be one
+		_activeCraftsIndex.query(ufo.getLongitude(), ufo.getLatitude(), ufo.getCraftStats().radarRange > 0 ? Nautical(ufo.getCraftStats().radarRange) : -1.0, _nearby);
+		for (int id : _nearby)
 		{
+			Craft* craft = activeCrafts[id];
 			if (!craft->isIgnoredByHK() && !craft->getRules()->isUndetectable())
 			{
 				int tmpAttraction = craft->getHunterKillerAttraction(ufo.getHuntMode());
@@ -1646,8 +2010,10 @@ void GeoscapeState::baseHunting()
 			{
 				// Look for nearby craft
 				bool started = false;
-				for (Craft* craft : activeCrafts)
+				_activeCraftsIndex.query(ab->getLongitude(), ab->getLatitude(), Nautical(ab->getDeployment()->getBaseDetectionRange()), _nearby);
+				for (int id : _nearby)
 				{
+					Craft* craft = activeCrafts[id];
 					// Craft is flying (i.e. not in base)
 					if (craft->getStatus() == "STR_OUT" && !craft->isDestroyed() && !craft->getRules()->isUndetectable() && !craft->isIgnoredByHK())
 					{
@@ -1776,6 +2142,7 @@ bool GeoscapeState::processMissionSite(MissionSite *site)
  */
 void GeoscapeState::time30Minutes()
 {
+	OXCE_PROFILE_ZONE("GeoscapeState::time30Minutes");
 	getRegistry().getService<GeoSystem>().updateAllRegionsAndCountries();
 
 	// Decrease mission countdowns
@@ -1877,7 +2244,8 @@ void GeoscapeState::time30Minutes()
 	}
 
 	// can be updated by previous loop
-	auto& activeCrafts = updateActiveCrafts();
+	updateActiveCrafts();
+	updateRadarBases();
 
 	// hidden alien activity variables
 	entt::entity ufoRegion = entt::null;
@@ -1903,7 +2271,7 @@ void GeoscapeState::time30Minutes()
 			AreaSystem::addAlienActivityToCountryAndRegion(points, ufo);
 
 			// detection ufo state
-			ufoDetection(&ufo, activeCrafts);
+			ufoDetection(&ufo);
 
 			// accumulate hidden ufos
 			if (!ufo.getDetected())
@@ -2020,9 +2388,13 @@ bool GeoscapeState::processHiddenAlienActivity(
 
 /**
  * Logic responsible for detecting ufo and its tracking.
+ * Bases and crafts from lists updated by `updateRadarBases()` and `updateActiveCrafts()` are used.
+ * When UFO do not have detection scripts, only ones that can have it in radar range are tested,
+ * others would always fail anyway. For them only random draw of failed detection is done,
+ * in same order as in lists, so random sequence of game stay same as without index.
  * @param ufo
  */
-void GeoscapeState::ufoDetection(Ufo* ufo, const std::vector<Craft*>& activeCrafts)
+void GeoscapeState::ufoDetection(Ufo* ufo)
 {
 	auto maskTest = [](UfoDetection value, UfoDetection mask)
 	{
@@ -2037,14 +2409,49 @@ void GeoscapeState::ufoDetection(Ufo* ufo, const std::vector<Craft*>& activeCraf
 	auto alreadyTracked = ufo->getDetected();
 	auto save = getGame()->getSavedGame();
 
-	for (Base& xcomBase : getRegistry().list<Base>())
+	// calls `detect` for nearby ones and consumes random draw of `RNG::percent(0)` for others
+	auto detectNearby = [&](const auto& list)
+	{
+		std::sort(_nearby.begin(), _nearby.end());
+		auto next = _nearby.begin();
+		for (int id = 0; id < (int)list.size(); ++id)
+		{
+			if (next != _nearby.end() && *next == id)
+			{
+				detected = maskBitOr(detected, list[id]->detect(ufo, save, alreadyTracked));
+				++next;
+			}
+			else
+			{
+				RNG::percent(0);
+			}
+		}
+	};
+
+	if (ufo->getRules()->getScript<ModScript::DetectUfoFromBase>().empty())
 	{
-		detected = maskBitOr(detected, xcomBase.detect(ufo, save, alreadyTracked));
+		_radarBasesIndex.query(ufo->getLongitude(), ufo->getLatitude(), Nautical(_radarBasesRange + 1), _nearby);
+		detectNearby(_radarBases);
+	}
+	else
+	{
+		for (Base* xcomBase : _radarBases)
+		{
+			detected = maskBitOr(detected, xcomBase->detect(ufo, save, alreadyTracked));
+		}
 	}
 
-	for (Craft* craft : activeCrafts)
+	if (ufo->getRules()->getScript<ModScript::DetectUfoFromCraft>().empty())
+	{
+		_activeCraftsIndex.query(ufo->getLongitude(), ufo->getLatitude(), Nautical(_activeCraftsRadarRange + 1), _nearby);
+		detectNearby(_activeCrafts);
+	}
+	else
 	{
-		detected = maskBitOr(detected, craft->detect(ufo, save, alreadyTracked));
+		for (Craft* craft : _activeCrafts)
+		{
+			detected = maskBitOr(detected, craft->detect(ufo, save, alreadyTracked));
+		}
 	}
 
 	if (!alreadyTracked)
@@ -2088,6 +2495,7 @@ void GeoscapeState::ufoDetection(Ufo* ufo, const std::vector<Craft*>& activeCraf
  */
 void GeoscapeState::time1Hour()
 {
+	OXCE_PROFILE_ZONE("GeoscapeState::time1Hour");
 	// Handle craft maintenance
 	for (Base& xcomBase : getRegistry().list<Base>())
 	{
@@ -2328,6 +2736,7 @@ void GenerateSupplyMission::operator()(AlienBase *base) const
  */
 void GeoscapeState::time1Day()
 {
+	OXCE_PROFILE_ZONE("GeoscapeState::time1Day");
 	SavedGame *saveGame = getGame()->getSavedGame();
 	Mod *mod = getGame()->getMod();
 	bool psiStrengthEval = (Options::psiStrengthEval && saveGame->isResearched(mod->getPsiRequirements()));
@@ -2739,6 +3148,7 @@ void GeoscapeState::time1Day()
  */
 void GeoscapeState::time1Month()
 {
+	OXCE_PROFILE_ZONE("GeoscapeState::time1Month");
 	getGame()->getSavedGame()->addMonth();
 
 	// Determine alien mission for this month.
@@ -2807,6 +3217,35 @@ void GeoscapeState::popup(State *state)
 	_popups.push_back(state);
 }
 
+/**
+ * Throws away everything that waits for the player: queued popups, dogfights and
+ * dogfights that did not start yet. Intercepting crafts are sent home, otherwise
+ * they would catch the same UFO again on next step. Used by headless simulation.
+ * @return Number of discarded popups and dogfights.
+ */
+int GeoscapeState::discardPendingEvents()
+{
+	int discarded = _popups.size() + _dogfights.size() + _dogfightsToBeStarted.size();
+	for (auto* dogfights : { &_dogfights, &_dogfightsToBeStarted })
+	{
+		for (auto* dfs : *dogfights)
+		{
+			if (dfs->getCraft())
+			{
+				dfs->getCraft()->setInDogfight(false);
+				dfs->getCraft()->setInterceptionOrder(0);
+				dfs->getCraft()->returnToBase();
+			}
+		}
+	}
+	Collections::deleteAll(_popups);
+	Collections::deleteAll(_dogfights);
+	Collections::deleteAll(_dogfightsToBeStarted);
+	_minimizedDogfights = 0;
+	_pause = false;
+	return discarded;
+}
+
 /**
  * Processes any left-clicks on globe markers,
  * or right-clicks to scroll the globe.
@@ -20,6 +20,7 @@
 #include "../Engine/State.h"
 #include "../Savegame/Region.h"
 #include "../Savegame/Country.h"
+#include "GeoIndex.h"
 #include <list>
 #include <entt/entt.hpp>
 
@@ -36,6 +37,7 @@ class Timer;
 class DogfightState;
 class Craft;
 class Ufo;
+class GameTime;
 class MissionSite;
 class Base;
 class RuleMissionScript;
@@ -66,6 +68,10 @@ private:
 	std::list<State*> _popups;
 	std::list<DogfightState*> _dogfights, _dogfightsToBeStarted;
 	std::vector<Craft*> _activeCrafts;
+	std::vector<Base*> _radarBases;
+	GeoIndex _activeCraftsIndex, _radarBasesIndex;
+	int _activeCraftsRadarRange, _radarBasesRange;
+	std::vector<int> _nearby;
 	size_t _minimizedDogfights;
 	int _slowdownCounter;
 
@@ -78,6 +84,8 @@ private:
 
 	/// Update list of active crafts.
 	const std::vector<Craft*>& updateActiveCrafts();
+	/// Update list of bases with radars.
+	void updateRadarBases();
 
 	void cbxRegionChange(Action *action);
 	void cbxZoneChange(Action *action);
@@ -100,6 +108,20 @@ public:
 	void timeDisplay();
 	/// Advances the game timer.
 	void timeAdvance();
+	/// Advances the game time by 5 seconds and runs all triggered logic.
+	void timeStep();
+	/// Counts following 5 second steps that can't change anything except the clock, UFO countdowns and positions of flying objects.
+	int countQuietSteps(int limit);
+	/// Counts quiet steps allowed by the clock, UFOs and crafts, flying stops before first arrival.
+	static int countQuietSteps(const GameTime& time, const std::vector<Ufo*>& ufos, const std::vector<Craft*>& crafts, int limit);
+	/// Collects UFOs and crafts in order of 5 second logic.
+	void getQuietStepTargets(std::vector<Ufo*>& ufos, std::vector<Craft*>& crafts);
+	/// Jumps over quiet steps without running 5 second logic.
+	int skipQuietSteps(int steps);
+	/// Advances the clock, UFOs and crafts over quiet steps.
+	static int skipQuietSteps(GameTime& time, const std::vector<Ufo*>& ufos, const std::vector<Craft*>& crafts, int steps);
+	/// Runs quiet steps one by one and checks that skipping them would give same saved state.
+	int checkQuietSteps(int steps);
 	/// Trigger whenever 5 seconds pass.
 	void time5Seconds();
 	/// Trigger whenever 10 minutes pass.
@@ -108,7 +130,7 @@ public:
 	void baseHunting();
 	/// Trigger whenever 30 minutes pass.
 	void time30Minutes();
-	void ufoDetection(Ufo* ufo, const std::vector<Craft*>& activeCrafts);
+	void ufoDetection(Ufo* ufo);
 	/// Trigger whenever 1 hour passes.
 	void time1Hour();
 	/// Trigger whenever 1 day passes.
@@ -119,6 +141,8 @@ public:
 	void timerReset();
 	/// Displays a popup window.
 	void popup(State *state);
+	/// Throws away queued popups and dogfights, used when nobody can answer them.
+	int discardPendingEvents();
 	/// Gets the Geoscape globe.
 	[[nodiscard]] Globe* getGlobe() const { return _globe; }
 	/// Handler for clicking the globe.
@@ -450,48 +450,15 @@ bool Globe::pointBack(double lon, double lat) const
 	return cos(_cenPosition.latitude) * cos(lat) * cos(lon - _cenPosition.longitude) + sin(_cenPosition.latitude) * sin(lat) < 0.0;
 }
 
+/**
+ * Gets polygon of globe that contains a polar point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Polygon or null if point is not on land.
+ */
 Polygon* Globe::getPolygonFromLonLat(double lon, double lat) const
 {
-	const double zDiscard=0.75f;
-	double coslat = cos(lat);
-	double sinlat = sin(lat);
-
-	for (auto* polygon : *_rules->getPolygons())
-	{
-		double x, y, z, x2, y2;
-		double clat, clon;
-		z = 0;
-		for (int j = 0; j < polygon->getPoints(); ++j)
-		{
-			z = coslat * cos(polygon->getLatitude(j)) * cos(polygon->getLongitude(j) - lon) + sinlat * sin(polygon->getLatitude(j));
-			if (z<zDiscard) break; //discarded
-		}
-		if (z<zDiscard) continue; //discarded
-
-		bool odd = false;
-
-		clat = polygon->getLatitude(0); //initial point
-		clon = polygon->getLongitude(0);
-		x = cos(clat) * sin(clon - lon);
-		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-
-		for (int j = 0; j < polygon->getPoints(); ++j)
-		{
-			int k = (j + 1) % polygon->getPoints(); //index of next point in poly
-			clat = polygon->getLatitude(k);
-			clon = polygon->getLongitude(k);
-
-			x2 = cos(clat) * sin(clon - lon);
-			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
-			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
-				odd = !odd;
-			x = x2;
-			y = y2;
-
-		}
-		if (odd) return polygon;
-	}
-	return NULL;
+	return _rules->getPolygonIndex().find(lon, lat);
 }
 
 /**
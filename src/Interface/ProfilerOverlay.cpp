@@ -0,0 +1,188 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ProfilerOverlay.h"
+#include <iomanip>
+#include <sstream>
+#include "../Engine/Action.h"
+#include "../Engine/Game.h"
+#include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/Timer.h"
+#include "Text.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a profiler overlay of the specified size.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ * @param x X position in pixels.
+ * @param y Y position in pixels.
+ */
+ProfilerOverlay::ProfilerOverlay(int width, int height, int x, int y) : Surface(width, height, x, y), _text(0), _color(0)
+{
+	_visible = false;
+
+	_timer = new Timer(1000);
+	_timer->onSurface(std::bind(&ProfilerOverlay::update, this));
+	_timer->start();
+}
+
+/**
+ * Deletes profiler overlay content.
+ */
+ProfilerOverlay::~ProfilerOverlay()
+{
+	delete _text;
+	delete _timer;
+}
+
+/**
+ * Replaces a certain amount of colors in the overlay palette.
+ * @param colors Pointer to the set of colors.
+ * @param firstcolor Offset of the first color to replace.
+ * @param ncolors Amount of colors to replace.
+ */
+void ProfilerOverlay::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
+{
+	Surface::setPalette(colors, firstcolor, ncolors);
+	if (_text)
+	{
+		_text->setPalette(colors, firstcolor, ncolors);
+	}
+}
+
+/**
+ * Sets the text color of the overlay.
+ * @param color The color to set.
+ */
+void ProfilerOverlay::setColor(Uint8 color)
+{
+	_color = color;
+	if (_text)
+	{
+		_text->setColor(color);
+	}
+}
+
+/**
+ * Creates text of overlay, fonts and language are only available after mods are loaded.
+ * @return True if text exists.
+ */
+bool ProfilerOverlay::createText()
+{
+	if (!_text && getGame()->getMod())
+	{
+		_text = new Text(getWidth(), getHeight(), 0, 0);
+		_text->setPalette(getPalette());
+		_text->setColor(_color);
+		_text->setHighContrast(true);
+	}
+	return _text != 0;
+}
+
+/**
+ * Deletes text before mod or language it use is destroyed,
+ * visible overlay creates new one on next update.
+ */
+void ProfilerOverlay::dropText()
+{
+	delete _text;
+	_text = 0;
+	_redraw = true;
+}
+
+/**
+ * Shows / hides the overlay, with Ctrl starts / stops trace capture instead.
+ * Alt is left for debug slow speed toggle of `Screen::handle`.
+ * @param action Pointer to an action.
+ */
+void ProfilerOverlay::handle(Action *action)
+{
+	if (action->getDetails()->type != SDL_KEYDOWN || action->getDetails()->key.keysym.sym != Options::keyProfiler || getGame()->isAltPressed())
+	{
+		return;
+	}
+	if (getGame()->isCtrlPressed())
+	{
+		if (Profiler::isCapturing())
+		{
+			Profiler::saveTrace("profile");
+		}
+		else
+		{
+			Profiler::startCapture(Options::oxceProfilerCaptureFrames);
+		}
+		return;
+	}
+	_visible = !_visible && createText();
+	Profiler::setOverlay(_visible);
+	_redraw = true;
+}
+
+/**
+ * Advances overlay timer.
+ */
+void ProfilerOverlay::think()
+{
+	_timer->think(false, true);
+}
+
+/**
+ * Updates list of slowest zones.
+ */
+void ProfilerOverlay::update()
+{
+	if (!_visible || !createText())
+	{
+		return;
+	}
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	if (Profiler::isCapturing())
+	{
+		ss << "CAPTURING\n";
+	}
+	int count = 0;
+	for (const auto& zone : Profiler::getStats())
+	{
+		if (++count > MaxZones)
+		{
+			break;
+		}
+		ss << zone.msPerFrame << " ms " << std::setprecision(1) << zone.callsPerFrame << "x " << zone.name << std::setprecision(2) << '\n';
+	}
+	_text->setText(ss.str());
+	_redraw = true;
+}
+
+/**
+ * Draws the profiler overlay.
+ */
+void ProfilerOverlay::draw()
+{
+	Surface::draw();
+	if (_text)
+	{
+		_text->blit(this->getSurface());
+	}
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "../Engine/Surface.h"
+
+namespace OpenXcom
+{
+
+class Text;
+class Timer;
+class Action;
+
+/**
+ * Shows zones of built-in profiler that take most time per frame,
+ * also starts and stops trace captures.
+ */
+class ProfilerOverlay : public Surface
+{
+private:
+	Text *_text;
+	Timer *_timer;
+	Uint8 _color;
+
+	/// Creates text with fonts of current mod.
+	bool createText();
+public:
+	/// Number of zones shown.
+	static constexpr int MaxZones = 10;
+
+	/// Creates a new profiler overlay.
+	ProfilerOverlay(int width, int height, int x, int y);
+	/// Cleans up the profiler overlay.
+	~ProfilerOverlay();
+	/// Sets the overlay's palette.
+	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256) override;
+	/// Sets the overlay's color.
+	void setColor(Uint8 color) override;
+	/// Drops text that use fonts and language of current mod.
+	void dropText();
+	/// Handles keyboard events.
+	void handle(Action *action);
+	/// Advances overlay timer.
+	void think() override;
+	/// Updates shown zones.
+	void update();
+	/// Draws the overlay.
+	void draw() override;
+};
+
+}
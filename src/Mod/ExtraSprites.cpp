@@ -281,6 +281,7 @@ SurfaceSet *ExtraSprites::loadSurfaceSet(SurfaceSet *set)
 			}
 		}
 	}
+	set->buildSpans();
 	return set;
 }
 
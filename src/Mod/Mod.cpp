@@ -64,6 +64,7 @@
 #include "RuleTerrain.h"
 #include "RuleUfo.h"
 #include "RuleVideo.h"
+#include "RulesetCache.h"
 #include "SoundDefinition.h"
 #include "StatString.h"
 #include "UfoTrajectory.h"
@@ -90,6 +91,7 @@
 #include "../Engine/SoundSet.h"
 #include "../Engine/Surface.h"
 #include "../Engine/SurfaceSet.h"
+#include "../Engine/ThreadPool.h"
 #include "../Entity/Game/BaseFactory.h"
 #include "../Entity/Game/CountryFactory.h"
 #include "../Entity/Game/RegionFactory.h"
@@ -2171,6 +2173,26 @@ void Mod::loadAll()
 	_soundOffsetGeo = _sounds["GEO.CAT"]->getMaxSharedSounds();
 
 	Log(LOG_INFO) << "Loading rulesets...";
+	RulesetCache rulesetCache;
+	size_t rulesetCacheDocument = 0;
+	const std::string rulesetCachePath = Options::getUserFolder() + "rulesets.cache";
+	if (Options::oxceRulesetCache)
+	{
+		size_t rulesetFiles = 0;
+		for (const ModInfo* modInfo : _modFiles.getModData())
+		{
+			rulesetFiles += modInfo->getRulesetFiles().size();
+		}
+		const Uint64 key = RulesetCache::makeKey(_modFiles.getModData());
+		if (rulesetCache.load(rulesetCachePath, key, rulesetFiles))
+		{
+			Log(LOG_INFO) << "Using ruleset cache " << rulesetCachePath;
+		}
+		else
+		{
+			rulesetCache.record(key);
+		}
+	}
 	// load rest rulesets
 	for (const ModInfo* modInfo : _modFiles.getModData())
 	{
@@ -2178,7 +2200,7 @@ void Mod::loadAll()
 		{
 			_modCurrent = modInfo;
 			_scriptGlobal->setMod((int)_modCurrent->getOffset());
-			loadMod(modInfo->getRulesetFiles(), parser);
+			loadMod(modInfo->getRulesetFiles(), parser, rulesetCache, rulesetCacheDocument);
 		}
 		catch (Exception &e)
 		{
@@ -2186,6 +2208,10 @@ void Mod::loadAll()
 			throwModOnErrorHelper(modId, e.what());
 		}
 	}
+	if (rulesetCache.isRecording() && rulesetCache.save(rulesetCachePath))
+	{
+		Log(LOG_INFO) << "Ruleset cache saved to " << rulesetCachePath;
+	}
 
 	// back master
 	_modCurrent = _modFiles.getModData()[0];
@@ -2252,6 +2278,7 @@ void Mod::loadAll()
 	afterLoadHelper("craftWeapons", this, _craftWeapons, &RuleCraftWeapon::afterLoad);
 	afterLoadHelper("countries", this, _countries, &RuleCountry::afterLoad);
 	afterLoadHelper("crafts", this, _crafts, &RuleCraft::afterLoad);
+	_globe->afterLoad();
 
 	for (auto& a : _armors)
 	{
@@ -2407,28 +2434,74 @@ void Mod::loadAll()
 /**
  * Loads a list of rulesets from YAML files for the mod at the specified index. The first
  * mod loaded should be the master at index 0, then 1, and so on.
+ * Files are parsed in batches on worker threads, then rules are applied one by one in original order,
+ * parse errors are reported when their file is reached, so result is same as loading everything serially.
  * @param rulesetFiles List of rulesets to load.
  * @param parsers Object with all available parsers.
+ * @param cache Cache of parsed rulesets, when loaded documents are taken from it, when recording they are added to it.
+ * @param cacheDocument Index of document in cache for first file of this mod, moved after last one.
  */
-void Mod::loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers)
+void Mod::loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers, RulesetCache &cache, size_t &cacheDocument)
 {
-	for (const FileMap::FileRecord& filerec : rulesetFiles)
+	ThreadPool& pool = ThreadPool::getGlobal();
+	// parsed files take lot more memory than text, only few of them per worker are kept at once
+	const size_t batchSize = pool.getWorkerCount() * 4;
+	std::vector<YAML::Node> docs;
+	std::vector<std::exception_ptr> errors;
+	for (size_t batchBegin = 0; batchBegin < rulesetFiles.size(); batchBegin += batchSize)
 	{
-		Log(LOG_VERBOSE) << "- " << filerec.fullpath;
-		try
-		{
-			_scriptGlobal->fileLoad(filerec.fullpath);
-			loadFile(filerec, parsers);
-		}
-		catch (Exception &e)
+		const size_t batchEnd = std::min(batchBegin + batchSize, rulesetFiles.size());
+		docs.assign(batchEnd - batchBegin, YAML::Node());
+		errors.assign(batchEnd - batchBegin, nullptr);
+		pool.parallelFor(batchEnd - batchBegin, [&](size_t i, size_t)
 		{
-			throw Exception(filerec.fullpath + ": " + std::string(e.what()));
-		}
-		catch (YAML::Exception &e)
+			try
+			{
+				if (cache.isLoaded())
+				{
+					docs[i] = cache.get(cacheDocument + batchBegin + i);
+				}
+				else
+				{
+					docs[i] = YAML::Load(*rulesetFiles[batchBegin + i].getIStream());
+				}
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		});
+
+		for (size_t i = batchBegin; i < batchEnd; ++i)
 		{
-			throw Exception(filerec.fullpath + ": " + std::string(e.what()));
+			const FileMap::FileRecord& filerec = rulesetFiles[i];
+			Log(LOG_VERBOSE) << "- " << filerec.fullpath;
+			try
+			{
+				_scriptGlobal->fileLoad(filerec.fullpath);
+				if (errors[i - batchBegin])
+				{
+					Log(LOG_FATAL) << "Error loading file '" << filerec.fullpath << "'";
+					std::rethrow_exception(errors[i - batchBegin]);
+				}
+				if (cache.isRecording())
+				{
+					cache.add(docs[i - batchBegin]);
+				}
+				loadFile(filerec, docs[i - batchBegin], parsers);
+				docs[i - batchBegin] = YAML::Node();
+			}
+			catch (Exception &e)
+			{
+				throw Exception(filerec.fullpath + ": " + std::string(e.what()));
+			}
+			catch (YAML::Exception &e)
+			{
+				throw Exception(filerec.fullpath + ": " + std::string(e.what()));
+			}
 		}
 	}
+	cacheDocument += rulesetFiles.size();
 
 	// these need to be validated, otherwise we're gonna get into some serious trouble down the line.
 	// it may seem like a somewhat arbitrary limitation, but there is a good reason behind it.
@@ -2656,12 +2729,12 @@ void Mod::loadConstants(const YAML::Node &node)
 /**
  * Loads a ruleset's contents from a YAML file.
  * Rules that match pre-existing rules overwrite them.
- * @param filename YAML filename.
+ * @param filerec YAML file.
+ * @param doc Parsed content of file.
  * @param parsers Object with all available parsers.
  */
-void Mod::loadFile(const FileMap::FileRecord &filerec, ModScript &parsers)
+void Mod::loadFile(const FileMap::FileRecord &filerec, YAML::Node doc, ModScript &parsers)
 {
-	YAML::Node doc = filerec.getYAML();
 
 	auto loadDocInfoHelper = [&](const char* nodeName)
 	{
@@ -5808,6 +5881,7 @@ void Mod::loadBattlescapeResources()
 				ShaderDraw<HairXCOM1>(head, ShaderScalar<Uint8>(HairXCOM1::Face + 6));
 				surf->unlock();
 			}
+			xcom_1->buildSpans();
 		}
 
 		//all TFTD armors
@@ -5893,6 +5967,7 @@ void Mod::loadBattlescapeResources()
 						surf->unlock();
 					}
 				}
+				xcom_2->buildSpans();
 			}
 		}
 	}
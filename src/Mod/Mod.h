@@ -102,6 +102,7 @@ class RuleEvent;
 class RuleMissionScript;
 class ModScript;
 class ModScriptGlobal;
+class RulesetCache;
 class ScriptParserBase;
 class ScriptGlobal;
 struct StatAdjustment;
@@ -323,8 +324,8 @@ private:
 	/// Loads a ruleset from a YAML file that have basic resources configuration.
 	void loadResourceConfigFile(const FileMap::FileRecord &filerec);
 	void loadConstants(const YAML::Node &node);
-	/// Loads a ruleset from a YAML file.
-	void loadFile(const FileMap::FileRecord &filerec, ModScript &parsers);
+	/// Loads a ruleset from a parsed YAML file.
+	void loadFile(const FileMap::FileRecord &filerec, YAML::Node doc, ModScript &parsers);
 
 	template<typename T>
 	struct RuleFactory
@@ -357,7 +358,7 @@ private:
 	/// Creates a transparency lookup table for a given palette.
 	void createTransparencyLUT(Palette *pal);
 	/// Loads a specified mod content.
-	void loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers);
+	void loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers, RulesetCache &cache, size_t &cacheDocument);
 	/// Loads resources from vanilla.
 	void loadVanillaResources();
 	/// Loads resources from extra rulesets.
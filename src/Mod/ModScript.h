@@ -18,6 +18,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "../Engine/Script.h"
+#include "../Engine/Profiler.h"
 
 
 namespace OpenXcom
@@ -566,6 +567,7 @@ public:
 		typename ScriptType::Output arg{};
 		typename ScriptType::Worker work{ std::forward<Args>(args)... };
 
+		OXCE_PROFILE_ZONE(ScriptType::scriptName);
 		work.execute(t->template getScript<ScriptType>(), arg);
 	}
 
@@ -582,6 +584,7 @@ public:
 		typename ScriptType::Output arg{ first };
 		typename ScriptType::Worker work{ std::forward<Args>(args)... };
 
+		OXCE_PROFILE_ZONE(ScriptType::scriptName);
 		work.execute(t->template getScript<ScriptType>(), arg);
 
 		return arg.getFirst();
@@ -601,6 +604,7 @@ public:
 		typename ScriptType::Output arg{ first, second };
 		typename ScriptType::Worker work{ std::forward<Args>(args)... };
 
+		OXCE_PROFILE_ZONE(ScriptType::scriptName);
 		work.execute(t->template getScript<ScriptType>(), arg);
 
 		return arg.getFirst();
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include "PolygonIndex.h"
+#include "Polygon.h"
+#include "../fmath.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Minimal value of dot product between point and all polygon vertexes, polygons further away are ignored.
+const double zDiscard = 0.75f;
+
+}
+
+/**
+ * Creates empty index.
+ */
+PolygonIndex::PolygonIndex()
+{
+
+}
+
+/**
+ * Gets index of grid cell that contains point.
+ * @param lon Longitude of point, any range.
+ * @param lat Latitude of point.
+ * @return Index of cell.
+ */
+int PolygonIndex::getCell(double lon, double lat)
+{
+	lon = std::fmod(lon, 2 * M_PI);
+	if (lon < 0)
+	{
+		lon += 2 * M_PI;
+	}
+	int x = (int)(Rad2Deg(lon) / CellSize);
+	int y = (int)((Rad2Deg(lat) + 90) / CellSize);
+	x = std::clamp(x, 0, CellsLon - 1);
+	y = std::clamp(y, 0, CellsLat - 1);
+	return y * CellsLon + x;
+}
+
+/**
+ * Converts polar point to unit vector.
+ * @param lon Longitude of point.
+ * @param lat Latitude of point.
+ * @return Point on unit sphere.
+ */
+PolygonIndex::Vector PolygonIndex::toVector(double lon, double lat)
+{
+	return Vector{ std::cos(lat) * std::cos(lon), std::cos(lat) * std::sin(lon), std::sin(lat) };
+}
+
+/**
+ * Builds index for polygons, order of list is kept, so lookup return same polygon as linear search.
+ * Polygon can contain only points inside the smallest cap around its center that have all its vertexes,
+ * so it is added to every cell that is close enough to that cap.
+ * @param polygons List of globe polygons.
+ */
+void PolygonIndex::build(const std::list<Polygon*>& polygons)
+{
+	clear();
+	_cells.resize(CellsLon * CellsLat);
+
+	// angular distance from center of cell to its farthest point is less than this
+	const double cellRadius = Deg2Rad(CellSize);
+	std::vector<Vector> cellCenters;
+	cellCenters.reserve(CellsLon * CellsLat);
+	for (int y = 0; y < CellsLat; ++y)
+	{
+		for (int x = 0; x < CellsLon; ++x)
+		{
+			cellCenters.push_back(toVector(Deg2Rad((x + 0.5) * CellSize), Deg2Rad((y + 0.5) * CellSize - 90)));
+		}
+	}
+	for (auto* polygon : polygons)
+	{
+		Entry entry = { polygon, _vertexes.size(), _vertexes.size() };
+		Vector center = { 0, 0, 0 };
+		for (int j = 0; j < polygon->getPoints(); ++j)
+		{
+			Vector v = toVector(polygon->getLongitude(j), polygon->getLatitude(j));
+			_vertexes.push_back(v);
+			center.x += v.x;
+			center.y += v.y;
+			center.z += v.z;
+		}
+		entry.end = _vertexes.size();
+		const int id = (int)_entries.size();
+		_entries.push_back(entry);
+
+		const double length = std::sqrt(center.x * center.x + center.y * center.y + center.z * center.z);
+		double capRadius = M_PI;
+		if (length > 1e-9)
+		{
+			center.x /= length;
+			center.y /= length;
+			center.z /= length;
+			capRadius = 0;
+			for (size_t j = entry.begin; j < entry.end; ++j)
+			{
+				const Vector& v = _vertexes[j];
+				const double dot = std::clamp(center.x * v.x + center.y * v.y + center.z * v.z, -1.0, 1.0);
+				capRadius = std::max(capRadius, std::acos(dot));
+			}
+		}
+		const double maxDistance = capRadius + cellRadius + 1e-6;
+		const double minDot = maxDistance >= M_PI ? -2.0 : std::cos(maxDistance);
+		const double centerLat = std::asin(std::clamp(center.z, -1.0, 1.0));
+
+		for (int y = 0; y < CellsLat; ++y)
+		{
+			// difference of latitudes is lower bound of distance
+			if (std::abs(Deg2Rad((y + 0.5) * CellSize - 90) - centerLat) > maxDistance)
+			{
+				continue;
+			}
+			for (int x = 0; x < CellsLon; ++x)
+			{
+				const Vector& c = cellCenters[y * CellsLon + x];
+				if (center.x * c.x + center.y * c.y + center.z * c.z >= minDot)
+				{
+					_cells[y * CellsLon + x].push_back(id);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Drops all polygons.
+ */
+void PolygonIndex::clear()
+{
+	_vertexes.clear();
+	_entries.clear();
+	_cells.clear();
+}
+
+/**
+ * Gets first polygon from list that contains point. Same test as before indexing:
+ * polygon is ignored when any vertex is too far away, otherwise point is checked
+ * against polygon projected orthographically around it.
+ * @param lon Longitude of point.
+ * @param lat Latitude of point.
+ * @return Polygon or null if point is not inside any one.
+ */
+Polygon* PolygonIndex::find(double lon, double lat) const
+{
+	if (_cells.empty())
+	{
+		return nullptr;
+	}
+
+	const double coslat = std::cos(lat), sinlat = std::sin(lat);
+	const double coslon = std::cos(lon), sinlon = std::sin(lon);
+	// point, and east and north direction in its tangent plane
+	const Vector p = { coslat * coslon, coslat * sinlon, sinlat };
+	const Vector e = { -sinlon, coslon, 0 };
+	const Vector n = { -sinlat * coslon, -sinlat * sinlon, coslat };
+
+	for (int id : _cells[getCell(lon, lat)])
+	{
+		const Entry& entry = _entries[id];
+		bool discarded = entry.begin == entry.end;
+		for (size_t j = entry.begin; j < entry.end; ++j)
+		{
+			const Vector& v = _vertexes[j];
+			if (p.x * v.x + p.y * v.y + p.z * v.z < zDiscard)
+			{
+				discarded = true;
+				break;
+			}
+		}
+		if (discarded)
+		{
+			continue;
+		}
+
+		bool odd = false;
+		const Vector& first = _vertexes[entry.begin];
+		double x = first.x * e.x + first.y * e.y;
+		double y = first.x * n.x + first.y * n.y + first.z * n.z;
+		for (size_t j = entry.begin; j < entry.end; ++j)
+		{
+			const Vector& v = _vertexes[j + 1 < entry.end ? j + 1 : entry.begin];
+			const double x2 = v.x * e.x + v.y * e.y;
+			const double y2 = v.x * n.x + v.y * n.y + v.z * n.z;
+			if (((y > 0) != (y2 > 0)) && (0 < (x2 - x) * (0 - y) / (y2 - y) + x))
+				odd = !odd;
+			x = x2;
+			y = y2;
+		}
+		if (odd)
+		{
+			return entry.polygon;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Gets number of polygons that lookup of point need to check.
+ * @param lon Longitude of point.
+ * @param lat Latitude of point.
+ * @return Number of candidates.
+ */
+size_t PolygonIndex::getCandidates(double lon, double lat) const
+{
+	if (_cells.empty())
+	{
+		return 0;
+	}
+	return _cells[getCell(lon, lat)].size();
+}
+
+}
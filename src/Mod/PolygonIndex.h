@@ -0,0 +1,80 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <list>
+#include <vector>
+
+namespace OpenXcom
+{
+
+class Polygon;
+
+/**
+ * Spatial index of globe polygons, used to find polygon under a point without checking every polygon.
+ * Globe is split to grid of latitude/longitude cells, each cell has list of polygons that can contain point in it.
+ * Vertexes are stored as unit vectors, so lookup do not need any trigonometry per vertex.
+ */
+class PolygonIndex
+{
+	/**
+	 * Point on unit sphere.
+	 */
+	struct Vector
+	{
+		double x, y, z;
+	};
+
+	/**
+	 * Polygon with precomputed vertexes.
+	 */
+	struct Entry
+	{
+		Polygon* polygon;
+		size_t begin, end;
+	};
+
+	/// Size of grid cell in degrees.
+	static constexpr int CellSize = 2;
+	static constexpr int CellsLon = 360 / CellSize;
+	static constexpr int CellsLat = 180 / CellSize;
+
+	std::vector<Vector> _vertexes;
+	std::vector<Entry> _entries;
+	std::vector<std::vector<int>> _cells;
+
+	/// Gets cell that contains point.
+	static int getCell(double lon, double lat);
+	/// Converts polar point to unit vector.
+	static Vector toVector(double lon, double lat);
+
+public:
+	/// Creates empty index.
+	PolygonIndex();
+
+	/// Builds index for list of polygons.
+	void build(const std::list<Polygon*>& polygons);
+	/// Drops all polygons.
+	void clear();
+	/// Gets first polygon from list that contains point.
+	Polygon* find(double lon, double lat) const;
+	/// Gets number of polygons that need be checked for point.
+	size_t getCandidates(double lon, double lat) const;
+};
+
+}
@@ -139,6 +139,14 @@ void RuleGlobe::load(const YAML::Node &node)
 	Globe::OCEAN_SHADING = node["oceanShading"].as<bool>(Globe::OCEAN_SHADING);
 }
 
+/**
+ * Builds spatial index of polygons, it need be done after all mods finish changing them.
+ */
+void RuleGlobe::afterLoad()
+{
+	_polygonIndex.build(_polygons);
+}
+
 /**
  * Returns the list of polygons in the globe.
  * @return Pointer to the list of polygons.
@@ -20,6 +20,7 @@
 #include <list>
 #include <string>
 #include <yaml-cpp/yaml.h>
+#include "PolygonIndex.h"
 
 namespace OpenXcom
 {
@@ -39,6 +40,7 @@ private:
 	std::list<Polygon*> _polygons;
 	std::list<Polyline*> _polylines;
 	std::map<int, Texture*> _textures;
+	PolygonIndex _polygonIndex;
 public:
 	/// Creates a blank globe ruleset.
 	RuleGlobe();
@@ -46,8 +48,12 @@ public:
 	~RuleGlobe();
 	/// Loads the globe from YAML.
 	void load(const YAML::Node& node);
+	/// Builds lookup structures after all mods are loaded.
+	void afterLoad();
 	/// Gets the list of world polygons.
 	std::list<Polygon*> *getPolygons();
+	/// Gets spatial index of world polygons.
+	const PolygonIndex &getPolygonIndex() const { return _polygonIndex; }
 	/// Gets the list of world polylines.
 	std::list<Polyline*> *getPolylines();
 	/// Loads a set of polygons from a DAT file.
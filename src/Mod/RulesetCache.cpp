@@ -0,0 +1,240 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+#include "RulesetCache.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/FileMap.h"
+#include "../Engine/Logger.h"
+#include "../Engine/ModInfo.h"
+#include "../Engine/YamlBinary.h"
+#include "../version.h"
+
+namespace OpenXcom
+{
+
+using namespace YamlBinary;
+
+namespace
+{
+
+const char Magic[4] = { 'O', 'X', 'R', 'C' };
+
+/// Size of file header: magic, format version, key, number of documents, payload size and payload checksum.
+const size_t HeaderSize = 4 + 4 + 8 + 8 + 8 + 8;
+
+/**
+ * FNV-1a hash, used for both cache key and checksum of data.
+ */
+struct Hash
+{
+	Uint64 value = 14695981039346656037ull;
+
+	void add(const void *data, size_t size)
+	{
+		const unsigned char *bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; ++i)
+		{
+			value ^= bytes[i];
+			value *= 1099511628211ull;
+		}
+	}
+	void add(Uint64 v)
+	{
+		add(&v, sizeof(v));
+	}
+	void add(const std::string &s)
+	{
+		add((Uint64)s.size());
+		add(s.data(), s.size());
+	}
+};
+
+}
+
+/**
+ * Creates empty cache that is neither loaded nor recording.
+ */
+RulesetCache::RulesetCache() : _key(0), _loaded(false), _recording(false)
+{
+
+}
+
+/**
+ * Calculates key of ruleset files, it change when engine version, list of mods or any ruleset file change.
+ * @param mods Active mods in load order.
+ * @return Key of cache.
+ */
+Uint64 RulesetCache::makeKey(const std::vector<const ModInfo*> &mods)
+{
+	Hash hash;
+	hash.add(std::string(OPENXCOM_VERSION_SHORT OPENXCOM_VERSION_GIT));
+	hash.add((Uint64)FormatVersion);
+	for (const ModInfo *modInfo : mods)
+	{
+		hash.add(modInfo->getName());
+		hash.add((Uint64)modInfo->getRulesetFiles().size());
+		for (const FileMap::FileRecord &filerec : modInfo->getRulesetFiles())
+		{
+			Uint64 size, stamp;
+			filerec.getStat(size, stamp);
+			hash.add(filerec.fullpath);
+			hash.add(size);
+			hash.add(stamp);
+		}
+	}
+	return hash.value;
+}
+
+/**
+ * Loads cache file. File is rejected when its header, key, number of documents or checksum do not match,
+ * or when any document is malformed.
+ * @param path Path of cache file.
+ * @param key Expected key, from `makeKey`.
+ * @param documents Expected number of documents.
+ * @return True if cache can be used.
+ */
+bool RulesetCache::load(const std::string &path, Uint64 key, size_t documents)
+{
+	_loaded = false;
+	_recording = false;
+	_data.clear();
+	_documents.clear();
+	if (!CrossPlatform::fileExists(path))
+	{
+		return false;
+	}
+
+	std::vector<char> file;
+	try
+	{
+		auto stream = CrossPlatform::readFile(path);
+		stream->seekg(0, std::ios::end);
+		file.resize((size_t)stream->tellg());
+		stream->seekg(0, std::ios::beg);
+		stream->read(file.data(), file.size());
+	}
+	catch (Exception &)
+	{
+		return false;
+	}
+
+	if (file.size() < HeaderSize || memcmp(file.data(), Magic, sizeof(Magic)) != 0)
+	{
+		Log(LOG_INFO) << "Ruleset cache " << path << " is not valid.";
+		return false;
+	}
+	Uint64 version = readFixed(file, 4, 4);
+	Uint64 fileKey = readFixed(file, 8, 8);
+	Uint64 fileDocuments = readFixed(file, 16, 8);
+	Uint64 payloadSize = readFixed(file, 24, 8);
+	Uint64 checksum = readFixed(file, 32, 8);
+	if (version != FormatVersion || fileKey != key || fileDocuments != documents || payloadSize != file.size() - HeaderSize)
+	{
+		Log(LOG_INFO) << "Ruleset cache " << path << " is outdated.";
+		return false;
+	}
+	Hash hash;
+	hash.add(file.data() + HeaderSize, (size_t)payloadSize);
+	if (hash.value != checksum)
+	{
+		Log(LOG_INFO) << "Ruleset cache " << path << " is corrupted.";
+		return false;
+	}
+
+	_data.assign(file.begin() + HeaderSize, file.end());
+	size_t offset = 0;
+	for (size_t i = 0; i < documents; ++i)
+	{
+		_documents.push_back(offset);
+		if (!validateNode(_data, offset))
+		{
+			Log(LOG_INFO) << "Ruleset cache " << path << " is corrupted.";
+			_data.clear();
+			_documents.clear();
+			return false;
+		}
+	}
+	_key = key;
+	_loaded = offset == _data.size();
+	return _loaded;
+}
+
+/**
+ * Starts recording of parsed documents, they will be saved with given key.
+ * @param key Key of cache, from `makeKey`.
+ */
+void RulesetCache::record(Uint64 key)
+{
+	_key = key;
+	_loaded = false;
+	_recording = true;
+	_data.clear();
+	_documents.clear();
+}
+
+/**
+ * Saves recorded documents to file.
+ * @param path Path of cache file.
+ * @return True on success.
+ */
+bool RulesetCache::save(const std::string &path) const
+{
+	if (!_recording)
+	{
+		return false;
+	}
+	std::vector<char> header(Magic, Magic + sizeof(Magic));
+	writeFixed(header, FormatVersion, 4);
+	writeFixed(header, _key, 8);
+	writeFixed(header, _documents.size(), 8);
+	writeFixed(header, _data.size(), 8);
+	Hash hash;
+	hash.add(_data.data(), _data.size());
+	writeFixed(header, hash.value, 8);
+
+	std::vector<unsigned char> file;
+	file.reserve(header.size() + _data.size());
+	file.insert(file.end(), header.begin(), header.end());
+	file.insert(file.end(), _data.begin(), _data.end());
+	return CrossPlatform::writeFile(path, file);
+}
+
+/**
+ * Gets document, every call create new node tree. Data is only read, so documents can be created in parallel.
+ * @param index Index of document, in order they were added.
+ * @return Root node of document.
+ */
+YAML::Node RulesetCache::get(size_t index) const
+{
+	size_t offset = _documents.at(index);
+	return readNode(_data, offset);
+}
+
+/**
+ * Adds parsed document at end of recorded ones.
+ * @param doc Root node of document.
+ */
+void RulesetCache::add(const YAML::Node &doc)
+{
+	_documents.push_back(_data.size());
+	writeNode(_data, doc);
+}
+
+}
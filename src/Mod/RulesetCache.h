@@ -0,0 +1,71 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+class ModInfo;
+
+/**
+ * On disk cache of parsed ruleset files, used to skip YAML parsing on startup.
+ * Documents are stored as compact binary node trees, file is valid only for same engine version,
+ * same list of mods and same size and modification time of every ruleset file.
+ * Rules are still applied from documents in usual way, so result of loading is same as from YAML.
+ */
+class RulesetCache
+{
+	/// Version of binary format, bump on every change of it.
+	static constexpr Uint32 FormatVersion = 1;
+
+	Uint64 _key;
+	bool _loaded, _recording;
+	std::vector<char> _data;
+	std::vector<size_t> _documents;
+
+public:
+	/// Creates empty cache.
+	RulesetCache();
+
+	/// Calculates key of ruleset files of given mods.
+	static Uint64 makeKey(const std::vector<const ModInfo*> &mods);
+	/// Loads cache file, return false if it does not exist or does not match key.
+	bool load(const std::string &path, Uint64 key, size_t documents);
+	/// Starts recording of parsed documents.
+	void record(Uint64 key);
+	/// Saves recorded documents to file.
+	bool save(const std::string &path) const;
+
+	/// Was cache loaded from file?
+	bool isLoaded() const { return _loaded; }
+	/// Are parsed documents recorded?
+	bool isRecording() const { return _recording; }
+	/// Number of stored documents.
+	size_t size() const { return _documents.size(); }
+	/// Gets document, can be called from many threads at once.
+	YAML::Node get(size_t index) const;
+	/// Adds parsed document at end of cache.
+	void add(const YAML::Node &doc);
+};
+
+}
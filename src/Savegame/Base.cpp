@@ -1258,6 +1258,24 @@ int Base::getLongRangeDetection() const
 	return total;
 }
 
+/**
+ * Returns the biggest radar range of all finished facilities in the base,
+ * UFOs further away can't be detected by the base's own radars.
+ * @return Range in nautical miles.
+ */
+int Base::getMaxRadarRange() const
+{
+	int range = 0;
+	for (const auto* fac : _facilities)
+	{
+		if (fac->getBuildTime() == 0)
+		{
+			range = std::max(range, fac->getRules()->getRadarRange());
+		}
+	}
+	return range;
+}
+
 /**
  * Computes base short range detection probability.
  * Short range detection probability includes all radars short and long range.
@@ -242,6 +242,8 @@ public:
 	int getShortRangeDetection() const;
 	/// Gets the base's long range detection.
 	int getLongRangeDetection() const;
+	/// Gets the biggest radar range of the base's finished facilities.
+	int getMaxRadarRange() const;
 	/// Gets the base's short range detection probability.
 	int getShortRangeDetectionProbabilityPercentage() const;
 	/// Gets the base's long range detection probability.
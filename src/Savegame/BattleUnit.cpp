@@ -34,6 +34,8 @@
 #include "../Battlescape/AIModule.h"
 #include "../Battlescape/Inventory.h"
 #include "../Battlescape/TileEngine.h"
+#include "../Battlescape/ReachabilityCache.h"
+#include "../Battlescape/InfluenceMap.h"
 #include "../Battlescape/ExplosionBState.h"
 #include "../Mod/Mod.h"
 #include "../Mod/Armor.h"
@@ -3568,10 +3570,20 @@ void BattleUnit::setTile(Tile *tile, SavedBattleGame *saveBattleGame)
 	}
 
 	auto armorSize = _armor->getSize() - 1;
+	auto reachabilityCache = saveBattleGame->getReachabilityCache();
+	auto influenceMap = saveBattleGame->getInfluenceMap();
 	// Reset tiles moved from.
 	if (_tile)
 	{
 		auto prevPos = _tile->getPosition();
+		if (reachabilityCache)
+		{
+			reachabilityCache->invalidate(prevPos, armorSize + 1);
+		}
+		if (influenceMap)
+		{
+			influenceMap->invalidate(prevPos, armorSize + 1);
+		}
 		for (int x = armorSize; x >= 0; --x)
 		{
 			for (int y = armorSize; y >= 0; --y)
@@ -3597,6 +3609,14 @@ void BattleUnit::setTile(Tile *tile, SavedBattleGame *saveBattleGame)
 
 	// Update tiles moved to.
 	auto newPos = _tile->getPosition();
+	if (reachabilityCache)
+	{
+		reachabilityCache->invalidate(newPos, armorSize + 1);
+	}
+	if (influenceMap)
+	{
+		influenceMap->invalidate(newPos, armorSize + 1);
+	}
 	for (int x = armorSize; x >= 0; --x)
 	{
 		for (int y = armorSize; y >= 0; --y)
@@ -6034,32 +6054,6 @@ void BattleUnit::checkForReactivation()
 	}
 }
 
-void BattleUnit::setReachablePositions(std::map<Position, int, PositionComparator> reachable)
-{
-	_reachablePositions = reachable;
-}
-
-std::map<Position, int, PositionComparator> BattleUnit::getReachablePositions()
-{
-	return _reachablePositions;
-}
-
-void BattleUnit::setPositionOfUpdate(Position pos, bool withMaxTUs)
-{
-	_positionWhenReachableWasUpdated = pos;
-	_maxTUsWhenReachableWasUpdated = withMaxTUs;
-}
-
-Position BattleUnit::getPositionOfUpdate()
-{
-	return _positionWhenReachableWasUpdated;
-}
-
-bool BattleUnit::wasMaxTusOfUpdate()
-{
-	return _maxTUsWhenReachableWasUpdated;
-}
-
 bool BattleUnit::isLeeroyJenkins(bool ignoreBrutal) const
 {
 	if (!isBrutal() || ignoreBrutal)
@@ -164,7 +164,6 @@ private:
 	bool _summonedPlayerUnit, _resummonedFakeCivilian;
 	bool _pickUpWeaponsMoreActively;
 	bool _disableIndicators;
-	bool _ranOutOfTUs;
 	MovementType _movementType;
 	MovementType _originalMovementType;
 	ArmorMoveCost _moveCostBase = { 0, 0 };
@@ -172,9 +171,6 @@ private:
 	ArmorMoveCost _moveCostBaseClimb = { 0, 0 };
 	ArmorMoveCost _moveCostBaseNormal = { 0, 0 };
 	std::vector<std::pair<Uint8, Uint8> > _recolor;
-	std::map<Position, int, PositionComparator> _reachablePositions;
-	Position _positionWhenReachableWasUpdated = Position(-1, -1, -1);
-	bool _maxTUsWhenReachableWasUpdated;
 	bool _capturable;
 	bool _vip;
 	bool _bannedInNextStage;
@@ -888,16 +884,6 @@ public:
 	int aiTargetMode();
 	/// Checks whether it makes sense to reactivate a unit that wanted to end it's turn and do so if it's the case
 	void checkForReactivation();
-	/// Cache inside the unit what positions it can reach for reference by AI
-	void setReachablePositions(std::map<Position, int, PositionComparator> reachable);
-	std::map<Position, int, PositionComparator> getReachablePositions();
-	/// Remember this value in order to check whether an update is due
-	void setPositionOfUpdate(Position posOfUpdate, bool withMaxTUs);
-	Position getPositionOfUpdate();
-	bool wasMaxTusOfUpdate();
-	/// Remember whether it ran out of TUs while doing the reachability-check
-	void setRanOutOfTUs(bool ranOutOfTUs) { _ranOutOfTUs = ranOutOfTUs; }
-	bool getRanOutOfTUs() { return _ranOutOfTUs; }
 
 	/// Multiplier of move cost.
 	ArmorMoveCost getMoveCostBase() const { return _moveCostBase; }
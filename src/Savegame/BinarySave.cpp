@@ -0,0 +1,419 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <SDL.h>
+#include "BinarySave.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/YamlBinary.h"
+
+#define MINIZ_NO_STDIO
+#include "../../libs/miniz/miniz.h"
+
+namespace OpenXcom
+{
+
+namespace BinarySave
+{
+
+using namespace YamlBinary;
+
+namespace
+{
+
+const char Magic[4] = { 'O', 'X', 'S', 'V' };
+
+/// Size of file header: magic and format version.
+const size_t HeaderSize = 4 + 4;
+
+/// Size of chunk header: type, flags, raw size, stored size and checksum of raw data.
+const size_t ChunkHeaderSize = 1 + 1 + 4 + 4 + 4;
+
+/// Biggest chunk accepted in file.
+const Uint64 MaxChunkSize = 0x7FFFFFFF;
+
+/// Types of chunks.
+enum ChunkType : Uint8
+{
+	CT_END = 0,
+	CT_BRIEF = 1,
+	CT_DATA = 2,
+	CT_ENTRY = 3,
+};
+
+/// Flags of chunks.
+enum ChunkFlags : Uint8
+{
+	CF_COMPRESSED = 1,
+};
+
+/**
+ * Closes file when it goes out of scope.
+ */
+struct FileCloser
+{
+	void operator()(SDL_RWops *file) const
+	{
+		SDL_RWclose(file);
+	}
+};
+
+using FilePtr = std::unique_ptr<SDL_RWops, FileCloser>;
+
+/**
+ * Calculates checksum of chunk data.
+ */
+Uint32 checksum(const std::vector<char> &data)
+{
+	return (Uint32)mz_crc32(MZ_CRC32_INIT, (const unsigned char*)data.data(), data.size());
+}
+
+/**
+ * Writes chunks to file one by one, buffers are reused between chunks.
+ */
+class ChunkWriter
+{
+	std::string _filename;
+	FilePtr _file;
+	bool _compress;
+	std::vector<char> _header, _packed, _data;
+
+	void writeBytes(const std::vector<char> &bytes)
+	{
+		if (!bytes.empty() && SDL_RWwrite(_file.get(), bytes.data(), (int)bytes.size(), 1) != 1)
+		{
+			throw Exception("Failed to write " + _filename + ": " + SDL_GetError());
+		}
+	}
+
+public:
+	/// Gets node data of current chunk.
+	std::vector<char> &getData() { return _data; }
+
+	ChunkWriter(const std::string &filename, bool compress) : _filename(filename), _compress(compress)
+	{
+		// Even SDL1 file IO accepts UTF-8 file names on windows.
+		_file.reset(SDL_RWFromFile(filename.c_str(), "wb"));
+		if (!_file)
+		{
+			throw Exception("Failed to write " + filename + ": " + SDL_GetError());
+		}
+		_header.assign(Magic, Magic + sizeof(Magic));
+		writeFixed(_header, FormatVersion, 4);
+		writeBytes(_header);
+	}
+
+	/**
+	 * Writes current data as chunk of given type, data is compressed when it make it smaller.
+	 */
+	void writeChunk(ChunkType type)
+	{
+		if (_data.size() > MaxChunkSize)
+		{
+			throw Exception("Failed to write " + _filename + ": save data is too big");
+		}
+		const std::vector<char> *payload = &_data;
+		Uint8 flags = 0;
+		if (_compress && !_data.empty())
+		{
+			mz_ulong packedSize = mz_compressBound((mz_ulong)_data.size());
+			_packed.resize(packedSize);
+			if (mz_compress2((unsigned char*)_packed.data(), &packedSize, (const unsigned char*)_data.data(), (mz_ulong)_data.size(), MZ_BEST_SPEED) == MZ_OK && packedSize < _data.size())
+			{
+				_packed.resize(packedSize);
+				payload = &_packed;
+				flags |= CF_COMPRESSED;
+			}
+		}
+		_header.clear();
+		_header.push_back(type);
+		_header.push_back(flags);
+		writeFixed(_header, _data.size(), 4);
+		writeFixed(_header, payload->size(), 4);
+		writeFixed(_header, checksum(_data), 4);
+		writeBytes(_header);
+		writeBytes(*payload);
+		_data.clear();
+	}
+};
+
+/**
+ * Reads chunks from file one by one, every chunk is checked before use.
+ */
+class ChunkReader
+{
+	std::string _filename;
+	FilePtr _file;
+	std::vector<char> _header, _packed, _data;
+
+	[[noreturn]] void fail(const std::string &reason) const
+	{
+		throw Exception("Failed to load " + _filename + ": " + reason);
+	}
+	void readBytes(std::vector<char> &buffer, size_t size)
+	{
+		buffer.resize(size);
+		if (size > 0 && SDL_RWread(_file.get(), buffer.data(), (int)size, 1) != 1)
+		{
+			fail("file is truncated");
+		}
+	}
+
+public:
+	/// Gets node data of current chunk.
+	std::vector<char> &getData() { return _data; }
+
+	ChunkReader(const std::string &filename) : _filename(filename)
+	{
+		_file.reset(SDL_RWFromFile(filename.c_str(), "rb"));
+		if (!_file)
+		{
+			fail(SDL_GetError());
+		}
+		readBytes(_header, HeaderSize);
+		if (memcmp(_header.data(), Magic, sizeof(Magic)) != 0)
+		{
+			fail("not a binary save");
+		}
+		if (readFixed(_header, 4, 4) != FormatVersion)
+		{
+			fail("unsupported format version");
+		}
+	}
+
+	/**
+	 * Reads next chunk into data and checks that it holds given number of complete nodes.
+	 * @return Type of chunk.
+	 */
+	ChunkType readChunk()
+	{
+		readBytes(_header, ChunkHeaderSize);
+		const ChunkType type = (ChunkType)_header[0];
+		const Uint8 flags = (Uint8)_header[1];
+		const Uint64 rawSize = readFixed(_header, 2, 4);
+		const Uint64 storedSize = readFixed(_header, 6, 4);
+		const Uint32 crc = (Uint32)readFixed(_header, 10, 4);
+		if (rawSize > MaxChunkSize || storedSize > MaxChunkSize)
+		{
+			fail("file is corrupted");
+		}
+		if (flags & CF_COMPRESSED)
+		{
+			readBytes(_packed, (size_t)storedSize);
+			_data.resize((size_t)rawSize);
+			mz_ulong size = (mz_ulong)rawSize;
+			if (mz_uncompress((unsigned char*)_data.data(), &size, (const unsigned char*)_packed.data(), (mz_ulong)storedSize) != MZ_OK || size != rawSize)
+			{
+				fail("file is corrupted");
+			}
+		}
+		else
+		{
+			if (storedSize != rawSize)
+			{
+				fail("file is corrupted");
+			}
+			readBytes(_data, (size_t)rawSize);
+		}
+		if (checksum(_data) != crc)
+		{
+			fail("file is corrupted");
+		}
+
+		size_t nodes;
+		switch (type)
+		{
+		case CT_END: nodes = 0; break;
+		case CT_BRIEF: nodes = 1; break;
+		case CT_DATA: nodes = 1; break;
+		case CT_ENTRY: nodes = 2; break;
+		default: fail("file is corrupted");
+		}
+		size_t offset = 0;
+		for (size_t i = 0; i < nodes; ++i)
+		{
+			if (!validateNode(_data, offset))
+			{
+				fail("file is corrupted");
+			}
+		}
+		if (offset != _data.size())
+		{
+			fail("file is corrupted");
+		}
+		return type;
+	}
+
+	/**
+	 * Reads next chunk that need be of given type and holds single node.
+	 * @return Node of chunk.
+	 */
+	YAML::Node readSingle(ChunkType type)
+	{
+		if (readChunk() != type)
+		{
+			fail("file is corrupted");
+		}
+		size_t offset = 0;
+		return readNode(_data, offset);
+	}
+};
+
+}
+
+/**
+ * Checks if file starts with magic of binary save.
+ * @param filename Full path of file.
+ * @return True if file is binary save.
+ */
+bool isBinary(const std::string &filename)
+{
+	FilePtr file(SDL_RWFromFile(filename.c_str(), "rb"));
+	char magic[sizeof(Magic)];
+	return file && SDL_RWread(file.get(), magic, sizeof(magic), 1) == 1 && memcmp(magic, Magic, sizeof(Magic)) == 0;
+}
+
+/**
+ * Saves game to binary file. Each top level entry of game data is encoded and written
+ * separately, so only one chunk is kept in memory besides the node tree.
+ * @param filename Full path of file.
+ * @param brief Brief info shown in save list.
+ * @param doc Game data, need be map.
+ * @param compress Compress chunks.
+ */
+void save(const std::string &filename, const YAML::Node &brief, const YAML::Node &doc, bool compress)
+{
+	if (!doc.IsMap())
+	{
+		throw Exception("Failed to save " + filename + ": game data is not a map");
+	}
+	ChunkWriter writer(filename, compress);
+	writeNode(writer.getData(), brief);
+	writer.writeChunk(CT_BRIEF);
+	// empty map that keep tag of game data, its entries follow
+	YAML::Node root(YAML::NodeType::Map);
+	root.SetTag(doc.Tag());
+	writeNode(writer.getData(), root);
+	writer.writeChunk(CT_DATA);
+	for (YAML::const_iterator i = doc.begin(); i != doc.end(); ++i)
+	{
+		writeNode(writer.getData(), i->first);
+		writeNode(writer.getData(), i->second);
+		writer.writeChunk(CT_ENTRY);
+	}
+	writer.writeChunk(CT_END);
+}
+
+/**
+ * Loads brief info from binary file, rest of file is not read.
+ * @param filename Full path of file.
+ * @return Brief info.
+ */
+YAML::Node loadBrief(const std::string &filename)
+{
+	ChunkReader reader(filename);
+	return reader.readSingle(CT_BRIEF);
+}
+
+/**
+ * Loads binary file, chunks are decoded one by one as they are read,
+ * but all entries end in one node tree that is given whole to `SavedGame::load`.
+ * @param filename Full path of file.
+ * @param brief Loaded brief info.
+ * @param doc Loaded game data.
+ */
+void load(const std::string &filename, YAML::Node &brief, YAML::Node &doc)
+{
+	ChunkReader reader(filename);
+	brief = reader.readSingle(CT_BRIEF);
+	doc = reader.readSingle(CT_DATA);
+	while (reader.readChunk() == CT_ENTRY)
+	{
+		size_t offset = 0;
+		YAML::Node key = readNode(reader.getData(), offset);
+		YAML::Node value = readNode(reader.getData(), offset);
+		doc.force_insert(key, value);
+	}
+}
+
+/**
+ * Saves game to YAML file, brief info and game data are separate documents.
+ * @param filename Full path of file.
+ * @param brief Brief info shown in save list.
+ * @param doc Game data.
+ */
+void saveYaml(const std::string &filename, const YAML::Node &brief, const YAML::Node &doc)
+{
+	YAML::Emitter out;
+	out << brief;
+	out << YAML::BeginDoc;
+	out << doc;
+	if (!CrossPlatform::writeFile(filename, out.c_str()))
+	{
+		throw Exception("Failed to save " + filename);
+	}
+}
+
+/**
+ * Loads save file, format is detected from its content.
+ * @param filename Full path of file.
+ * @param brief Loaded brief info.
+ * @param doc Loaded game data.
+ */
+void loadAny(const std::string &filename, YAML::Node &brief, YAML::Node &doc)
+{
+	if (isBinary(filename))
+	{
+		load(filename, brief, doc);
+		return;
+	}
+	std::vector<YAML::Node> file = YAML::LoadAll(*CrossPlatform::readFile(filename));
+	if (file.size() < 2)
+	{
+		throw Exception("Failed to load " + filename + ": file is not a save");
+	}
+	brief = file[0];
+	doc = file[1];
+}
+
+/**
+ * Converts save file from any format to given one.
+ * @param from Full path of source file.
+ * @param to Full path of destination file.
+ * @param format Format of destination file.
+ */
+void convert(const std::string &from, const std::string &to, SaveFormat format)
+{
+	YAML::Node brief, doc;
+	loadAny(from, brief, doc);
+	if (format == SF_YAML)
+	{
+		saveYaml(to, brief, doc);
+	}
+	else
+	{
+		save(to, brief, doc, format == SF_BINARY_COMPRESSED);
+	}
+}
+
+} // namespace BinarySave
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <SDL_types.h>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Binary savegame format, alternative to YAML text for big saves.
+ * File start with magic and format version, followed by chunks: first one hold brief info
+ * used by save list, then every top level entry of game data has own chunk.
+ * Each chunk has checksum and can be compressed, chunks are encoded and decoded one by one
+ * so besides the node tree only one chunk is in memory. Loaded node tree is still whole
+ * game data, as before. Node trees are stored same way as in ruleset cache, conversion
+ * to and from YAML is lossless.
+ */
+namespace BinarySave
+{
+
+/// Version of binary format, bump on every change of it.
+constexpr Uint32 FormatVersion = 1;
+
+/// Formats in which game can be saved, value of `oxceBinarySaves` option.
+enum SaveFormat
+{
+	SF_YAML = 0,
+	SF_BINARY = 1,
+	SF_BINARY_COMPRESSED = 2,
+};
+
+/// Checks if file is binary save.
+bool isBinary(const std::string &filename);
+/// Saves brief info and game data to binary file.
+void save(const std::string &filename, const YAML::Node &brief, const YAML::Node &doc, bool compress);
+/// Loads only brief info from binary file.
+YAML::Node loadBrief(const std::string &filename);
+/// Loads brief info and game data from binary file.
+void load(const std::string &filename, YAML::Node &brief, YAML::Node &doc);
+
+/// Saves brief info and game data to YAML file.
+void saveYaml(const std::string &filename, const YAML::Node &brief, const YAML::Node &doc);
+/// Loads brief info and game data from file in any format.
+void loadAny(const std::string &filename, YAML::Node &brief, YAML::Node &doc);
+/// Converts save file to given format.
+void convert(const std::string &from, const std::string &to, SaveFormat format);
+
+}
+
+}
@@ -1164,6 +1164,24 @@ bool Craft::isTakingOff() const
 	return _takeoff == 60;
 }
 
+/**
+ * Gets number of 5 second steps before the craft starts moving.
+ * @return Steps to takeoff, 0 when craft is not taking off.
+ */
+int Craft::getTakeoff() const
+{
+	return _takeoff;
+}
+
+/**
+ * Sets number of 5 second steps before the craft starts moving.
+ * @param takeoff Steps to takeoff.
+ */
+void Craft::setTakeoff(int takeoff)
+{
+	_takeoff = takeoff;
+}
+
 /**
  * Checks the condition of all the craft's systems
  * to define its new status (eg. when arriving at base).
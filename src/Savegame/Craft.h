@@ -261,6 +261,10 @@ public:
 	bool think();
 	/// Is the craft about to take off?
 	bool isTakingOff() const;
+	/// Gets number of steps before the craft takes off.
+	int getTakeoff() const;
+	/// Sets number of steps before the craft takes off.
+	void setTakeoff(int takeoff);
 	/// Does a craft full checkup.
 	void checkup();
 	/// Consumes the craft's fuel.
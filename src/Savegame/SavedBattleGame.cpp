@@ -30,6 +30,8 @@
 #include "../Mod/MapDataSet.h"
 #include "../Battlescape/Pathfinding.h"
 #include "../Battlescape/TileEngine.h"
+#include "../Battlescape/ReachabilityCache.h"
+#include "../Battlescape/InfluenceMap.h"
 #include "../Battlescape/BattlescapeState.h"
 #include "../Battlescape/BattlescapeGame.h"
 #include "../Battlescape/Position.h"
@@ -54,6 +56,7 @@
 #include "../fallthrough.h"
 #include "../fmath.h"
 #include "../Engine/Language.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -64,7 +67,7 @@ namespace OpenXcom
 SavedBattleGame::SavedBattleGame(Mod *rule, Language *lang, bool isPreview) :
 	_isPreview(isPreview), _craftPos(), _craftZ(0), _craftForPreview(nullptr),
 	_battleState(0), _rule(rule), _mapsize_x(0), _mapsize_y(0), _mapsize_z(0), _selectedUnit(0),
-	_lastSelectedUnit(0), _pathfinding(0), _tileEngine(0),
+	_lastSelectedUnit(0), _pathfinding(0), _tileEngine(0), _reachabilityCache(0), _influenceMap(0),
 	_reinforcementsItemLevel(0), _startingCondition(nullptr), _enviroEffects(nullptr), _ecEnabledFriendly(false), _ecEnabledHostile(false), _ecEnabledNeutral(false),
 	_globalShade(0), _side(FACTION_PLAYER), _turn(0), _bughuntMinTurn(20), _animFrame(0), _nameDisplay(false),
 	_debugMode(false), _bughuntMode(false), _aborted(false), _itemId(0),
@@ -122,6 +125,12 @@ SavedBattleGame::~SavedBattleGame()
 	}
 	delete _pathfinding;
 	delete _tileEngine;
+	delete _reachabilityCache;
+	delete _influenceMap;
+	for (auto* pf : _workerPathfinding)
+	{
+		delete pf;
+	}
 	delete _baseItems;
 	delete _hitLog;
 }
@@ -760,6 +769,7 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z, bool
 	_mapsize_z = mapsize_z;
 
 	_tiles.clear();
+	_tileStore.init(_mapsize_z * _mapsize_y * _mapsize_x);
 	_tiles.reserve(_mapsize_z * _mapsize_y * _mapsize_x);
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
@@ -776,9 +786,20 @@ void SavedBattleGame::initUtilities(Mod *mod, bool craftInventory)
 {
 	delete _pathfinding;
 	delete _tileEngine;
+	delete _reachabilityCache;
+	delete _influenceMap;
+	for (auto* pf : _workerPathfinding)
+	{
+		delete pf;
+	}
+	_workerPathfinding.clear();
 	_baseCraftInventory = craftInventory;
 	_pathfinding = craftInventory ? nullptr : new Pathfinding(this);
 	_tileEngine = new TileEngine(this, mod);
+	_reachabilityCache = new ReachabilityCache();
+	_reachabilityCache->init(_mapsize_x, _mapsize_y, _mapsize_z);
+	_influenceMap = new InfluenceMap();
+	_influenceMap->init(_mapsize_x, _mapsize_y, _mapsize_z);
 }
 
 /**
@@ -1144,6 +1165,21 @@ Pathfinding *SavedBattleGame::getPathfinding() const
 	return _pathfinding;
 }
 
+/**
+ * Gets pathfinding objects that worker threads can use for read only searches, one per worker.
+ * Missing ones are created, so it need be called before work is split between threads.
+ * @param workers Number of workers.
+ * @return List of pathfinding objects, at least as long as number of workers.
+ */
+const std::vector<Pathfinding*> &SavedBattleGame::getWorkerPathfinding(size_t workers)
+{
+	while (_workerPathfinding.size() < workers)
+	{
+		_workerPathfinding.push_back(new Pathfinding(this));
+	}
+	return _workerPathfinding;
+}
+
 /**
  * Gets the terrain modifier object.
  * @return Pointer to the terrain modifier object.
@@ -1153,6 +1189,24 @@ TileEngine *SavedBattleGame::getTileEngine() const
 	return _tileEngine;
 }
 
+/**
+ * Gets the reachability cache, AI units use it to share results of reachability searches during a turn.
+ * @return Pointer to the reachability cache.
+ */
+ReachabilityCache *SavedBattleGame::getReachabilityCache() const
+{
+	return _reachabilityCache;
+}
+
+/**
+ * Gets the influence map, AI units use its layers as scratch space when rating positions.
+ * @return Pointer to the influence map.
+ */
+InfluenceMap *SavedBattleGame::getInfluenceMap() const
+{
+	return _influenceMap;
+}
+
 /**
  * Gets the array of mapblocks.
  * @return Pointer to the array of mapblocks.
@@ -1542,6 +1596,18 @@ const RuleCraftDeployment& SavedBattleGame::getCustomDeployment(const RuleCraft*
  */
 void SavedBattleGame::endTurn()
 {
+	OXCE_PROFILE_ZONE("SavedBattleGame::endTurn");
+	// units get new time units, every reachability need be calculated again
+	if (_reachabilityCache)
+	{
+		_reachabilityCache->clear();
+	}
+	// same for influence, smoke spread at end of turn is not reported anywhere else
+	if (_influenceMap)
+	{
+		_influenceMap->clear();
+	}
+
 	// reset turret direction for all hostile and neutral units (as it may have been changed during reaction fire)
 	for (auto* bu : _units)
 	{
@@ -37,6 +37,8 @@ class BattlescapeGame;
 class Position;
 class Pathfinding;
 class TileEngine;
+class ReachabilityCache;
+class InfluenceMap;
 class RuleStartingCondition;
 class RuleEnviroEffects;
 class BattleItem;
@@ -73,6 +75,7 @@ private:
 	Mod *_rule;
 	int _mapsize_x, _mapsize_y, _mapsize_z;
 	std::vector<MapDataSet*> _mapDataSets;
+	TileStore _tileStore;
 	std::vector<Tile> _tiles;
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
@@ -80,6 +83,9 @@ private:
 	std::vector<BattleItem*> _items, _deleted;
 	Pathfinding *_pathfinding;
 	TileEngine *_tileEngine;
+	ReachabilityCache *_reachabilityCache;
+	InfluenceMap *_influenceMap;
+	std::vector<Pathfinding*> _workerPathfinding;
 	std::string _missionType, _strTarget, _strCraftOrBase, _alienCustomDeploy, _alienCustomMission;
 	std::string _lastUsedMapScript;
 	int _alienItemLevel = 0;
@@ -300,6 +306,11 @@ public:
 		return &_tiles[i];
 	}
 
+	/// Gets packed per tile state, indexed same as tiles.
+	TileStore& getTileStore() { return _tileStore; }
+	/// Gets packed per tile state, indexed same as tiles.
+	const TileStore& getTileStore() const { return _tileStore; }
+
 	/**
 	 * Get tile that is below current one (const version).
 	 * @param tile
@@ -378,8 +389,14 @@ public:
 	BattleUnit *selectUnit(Position pos);
 	/// Gets the pathfinding object.
 	Pathfinding *getPathfinding() const;
+	/// Gets separate pathfinding objects for worker threads.
+	const std::vector<Pathfinding*> &getWorkerPathfinding(size_t workers);
 	/// Gets a pointer to the tile engine.
 	TileEngine *getTileEngine() const;
+	/// Gets reachability of units shared by AI.
+	ReachabilityCache *getReachabilityCache() const;
+	/// Gets per tile scores used by AI.
+	InfluenceMap *getInfluenceMap() const;
 	/// Gets the playing side.
 	UnitFaction getSide() const;
 	/// Can unit use that weapon?
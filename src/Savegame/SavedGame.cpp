@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "SavedGame.h"
+#include "BinarySave.h"
 #include <algorithm>
 #include <ctime>
 #include <functional>
@@ -299,7 +300,7 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 {
 	std::string fullname = Options::getMasterUserFolder() + file;
-	YAML::Node doc = YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
+	YAML::Node doc = BinarySave::isBinary(fullname) ? BinarySave::loadBrief(fullname) : YAML::Load(*CrossPlatform::getYamlSaveHeader(fullname));
 	SaveInfo save;
 
 	save.fileName = file;
@@ -372,7 +373,7 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 }
 
 /**
- * Loads a saved game's contents from a YAML file.
+ * Loads a saved game's contents from a YAML or binary file.
  * @note Assumes the saved game is blank.
  * @param filename YAML filename.
  * @param mod Mod for the saved game.
@@ -381,15 +382,14 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 void SavedGame::load(const std::string &filename, Mod *mod, Language *lang, YAML::Node& doc)
 {
 	std::string filepath = Options::getMasterUserFolder() + filename;
-	std::vector<YAML::Node> file = YAML::LoadAll(*CrossPlatform::readFile(filepath));
+	YAML::Node brief;
+	BinarySave::loadAny(filepath, brief, doc);
 	// Get brief save info
-	YAML::Node brief = file[0];
 	_time->load(brief["time"]);
 	_name = (brief["name"]) ? _name = brief["name"].as<std::string>() : _name = filename;
 	_ironman = brief["ironman"].as<bool>(_ironman);
 
 	// Get full save data
-	doc = file[1];
 	_difficulty = (GameDifficulty)doc["difficulty"].as<int>(_difficulty);
 	_end = (GameEnding)doc["end"].as<int>(_end);
 	if (doc["rng"] && (_ironman || !Options::newSeedOnLoad))
@@ -704,13 +704,11 @@ void SavedGame::load(const std::string &filename, Mod *mod, Language *lang, YAML
 }
 
 /**
- * Saves a saved game's contents to a YAML file.
+ * Saves a saved game's contents to a YAML or binary file, depending on options.
  * @param filename YAML filename.
  */
 void SavedGame::save(const std::string &filename, Mod *mod) const
 {
-	YAML::Emitter out;
-
 	// Saves the brief game info used in the saves list
 	YAML::Node brief;
 	brief["name"] = _name;
@@ -740,9 +738,26 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 	brief["mods"] = modsList;
 	if (_ironman)
 		brief["ironman"] = _ironman;
-	out << brief;
-	// Saves the full game data to the save
-	out << YAML::BeginDoc;
+	YAML::Node node = saveState(mod);
+
+	std::string filepath = Options::getMasterUserFolder() + filename;
+	if (Options::oxceBinarySaves == BinarySave::SF_BINARY || Options::oxceBinarySaves == BinarySave::SF_BINARY_COMPRESSED)
+	{
+		BinarySave::save(filepath, brief, node, Options::oxceBinarySaves == BinarySave::SF_BINARY_COMPRESSED);
+	}
+	else
+	{
+		BinarySave::saveYaml(filepath, brief, node);
+	}
+}
+
+/**
+ * Saves the full game data, everything except the brief info used in the saves list.
+ * @param mod Game mod.
+ * @return YAML node.
+ */
+YAML::Node SavedGame::saveState(Mod *mod) const
+{
 	YAML::Node node;
 	node["difficulty"] = (int)_difficulty;
 	node["end"] = (int)_end;
@@ -908,15 +923,7 @@ void SavedGame::save(const std::string &filename, Mod *mod) const
 		node["battleGame"] = _battleGame->save();
 	}
 	_scriptValues.save(node, mod->getScriptGlobal());
-
-	out << node;
-
-
-	std::string filepath = Options::getMasterUserFolder() + filename;
-	if (!CrossPlatform::writeFile(filepath, out.c_str()))
-	{
-		throw Exception("Failed to save " + filepath);
-	}
+	return node;
 }
 
 /**
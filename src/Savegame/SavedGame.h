@@ -193,6 +193,8 @@ public:
 	void load(const std::string& filename, Mod* mod, Language* lang, YAML::Node& doc);
 	/// Saves a saved game to YAML.
 	void save(const std::string &filename, Mod *mod) const;
+	/// Saves the full game data without the brief info.
+	YAML::Node saveState(Mod *mod) const;
 	/// Gets the game name.
 	std::string getName() const { return _name; }
 	/// Sets the game name.
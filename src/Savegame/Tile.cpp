@@ -56,7 +56,7 @@ const Tile::SerializationKey Tile::SerializationKey::defaultKey() {
  * constructor
  * @param pos Position.
  */
-Tile::Tile(Position pos, SavedBattleGame* save): _save(save), _pos(pos)
+Tile::Tile(Position pos, SavedBattleGame* save): _save(save), _store(&save->getTileStore()), _index(save->getTileIndex(pos)), _pos(pos)
 {
 	for (int i = 0; i < O_MAX; ++i)
 	{
@@ -65,14 +65,6 @@ Tile::Tile(Position pos, SavedBattleGame* save): _save(save), _pos(pos)
 		_mapData->SetID[i] = -1;
 		_objectsCache[i].currentFrame = 0;
 	}
-	for (int layer = 0; layer < LL_MAX; layer++)
-	{
-		_light[layer] = 0;
-	}
-	for (int i = 0; i < O_MAX; ++i)
-	{
-		_objectsCache[i].discovered = 0;
-	}
 	_cache.isNoFloor = 1;
 	_cache.isGravLift = 0;
 	_cache.isLadderOnObject = 0;
@@ -100,8 +92,8 @@ void Tile::load(const YAML::Node &node)
 		_mapData->ID[i] = node["mapDataID"][i].as<int>(_mapData->ID[i]);
 		_mapData->SetID[i] = node["mapDataSetID"][i].as<int>(_mapData->SetID[i]);
 	}
-	_fire = node["fire"].as<int>(_fire);
-	_smoke = node["smoke"].as<int>(_smoke);
+	_store->setFire(_index, node["fire"].as<int>(getFire()));
+	_store->setSmoke(_index, node["smoke"].as<int>(getSmoke()));
 
 	const Tile::SerializationKey def = Tile::SerializationKey::defaultKey();
 	_lastExploredByHostile = node["lastExploredByHostile"].as<int>(def._lastExploredByHostile);
@@ -113,7 +105,7 @@ void Tile::load(const YAML::Node &node)
 		for (int i = 0; i < 3; i++)
 		{
 			auto realTilePart = (i == 2 ? 0 : i - 1); //convert old convention to new one
-			_objectsCache[realTilePart].discovered = (Uint8)node["discovered"][i].as<bool>();
+			_store->setDiscovered(_index, (TilePart)realTilePart, node["discovered"][i].as<bool>());
 		}
 	}
 	if (node["openDoorWest"])
@@ -124,7 +116,7 @@ void Tile::load(const YAML::Node &node)
 	{
 		_objectsCache[2].currentFrame = 7;
 	}
-	if (_fire || _smoke)
+	if (getFire() || getSmoke())
 	{
 		_animationOffset = RNG::seedless(0, 3);
 	}
@@ -146,19 +138,19 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	_mapData->SetID[2] = unserializeInt(&buffer, serKey._mapDataSetID);
 	_mapData->SetID[3] = unserializeInt(&buffer, serKey._mapDataSetID);
 
-	_smoke = unserializeInt(&buffer, serKey._smoke);
-	_fire = unserializeInt(&buffer, serKey._fire);
+	_store->setSmoke(_index, unserializeInt(&buffer, serKey._smoke));
+	_store->setFire(_index, unserializeInt(&buffer, serKey._fire));
 
 	Uint8 boolFields = unserializeInt(&buffer, serKey.boolFields);
-	_objectsCache[O_WESTWALL].discovered = (boolFields & 1) ? 1 : 0;
-	_objectsCache[O_NORTHWALL].discovered = (boolFields & 2) ? 1 : 0;
-	_objectsCache[O_FLOOR].discovered = (boolFields & 4) ? 1 : 0;
+	_store->setDiscovered(_index, O_WESTWALL, boolFields & 1);
+	_store->setDiscovered(_index, O_NORTHWALL, boolFields & 2);
+	_store->setDiscovered(_index, O_FLOOR, boolFields & 4);
 	_objectsCache[O_WESTWALL].currentFrame = (boolFields & 8) ? 7 : 0;
 	_objectsCache[O_NORTHWALL].currentFrame = (boolFields & 0x10) ? 7 : 0;
 	_lastExploredByHostile = unserializeInt(&buffer, static_cast < Uint8>(serKey._lastExploredByHostile));
 	_lastExploredByNeutral = unserializeInt(&buffer, static_cast<Uint8>(serKey._lastExploredByNeutral));
 	_lastExploredByPlayer = unserializeInt(&buffer, static_cast<Uint8>(serKey._lastExploredByPlayer));
-	if (_fire || _smoke)
+	if (getFire() || getSmoke())
 	{
 		_animationOffset = RNG::seedless(0, 3);
 	}
@@ -178,17 +170,17 @@ YAML::Node Tile::save() const
 		node["mapDataID"].push_back(_mapData->ID[i]);
 		node["mapDataSetID"].push_back(_mapData->SetID[i]);
 	}
-	if (_smoke)
-		node["smoke"] = _smoke;
-	if (_fire)
-		node["fire"] = _fire;
+	if (getSmoke())
+		node["smoke"] = getSmoke();
+	if (getFire())
+		node["fire"] = getFire();
 	if (_lastExploredByHostile)
 		node["lastExploredByHostile"] = _lastExploredByHostile;
 	if (_lastExploredByNeutral)
 		node["lastExploredByNeutral"] = _lastExploredByNeutral;
 	if (_lastExploredByPlayer)
 		node["lastExploredByPlayer"] = _lastExploredByPlayer;
-	if (_objectsCache[O_FLOOR].discovered || _objectsCache[O_WESTWALL].discovered || _objectsCache[O_NORTHWALL].discovered)
+	if (isDiscovered(O_FLOOR) || isDiscovered(O_WESTWALL) || isDiscovered(O_NORTHWALL))
 	{
 		throw Exception("Obsolete code");
 //		for (int i = O_FLOOR; i <= O_NORTHWALL; i++)
@@ -224,10 +216,10 @@ void Tile::saveBinary(Uint8** buffer) const
 	serializeInt(buffer, def._mapDataSetID, _mapData->SetID[2]);
 	serializeInt(buffer, def._mapDataSetID, _mapData->SetID[3]);
 
-	serializeInt(buffer, def._smoke, _smoke);
-	serializeInt(buffer, def._fire, _fire);
+	serializeInt(buffer, def._smoke, getSmoke());
+	serializeInt(buffer, def._fire, getFire());
 
-	Uint8 boolFields = (_objectsCache[O_WESTWALL].discovered?1:0) + (_objectsCache[O_NORTHWALL].discovered?2:0) + (_objectsCache[O_FLOOR].discovered?4:0);
+	Uint8 boolFields = (isDiscovered(O_WESTWALL)?1:0) + (isDiscovered(O_NORTHWALL)?2:0) + (isDiscovered(O_FLOOR)?4:0);
 	boolFields |= isUfoDoorOpen(O_WESTWALL) ? 8 : 0; // west
 	boolFields |= isUfoDoorOpen(O_NORTHWALL) ? 0x10 : 0; // north?
 	serializeInt(buffer, def.boolFields, boolFields);
@@ -313,27 +305,30 @@ void Tile::getMapData(int *mapDataID, int *mapDataSetID, TilePart part) const
  */
 bool Tile::isVoid() const
 {
-	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && _smoke == 0 && _inventory.empty();
+	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && getSmoke() == 0 && _inventory.empty();
 }
 
 /**
- * Gets the TU cost to walk over a certain part of the tile.
+ * Recalculates TU costs of a certain part of the tile stored in tile store.
+ * Need be called every time map data or frame of the part change.
  * @param part The part number.
- * @param movementType The movement type.
- * @return TU cost.
  */
-int Tile::getTUCost(int part, MovementType movementType) const
+void Tile::updateTUCost(TilePart part)
 {
+	int costs[TileStore::TUCostTypes] = { };
 	if (_objects[part])
 	{
-		if (_objectsCache[part].isUfoDoor && _objectsCache[part].currentFrame > 1)
-			return 0;
-		if (part == O_OBJECT && _objects[part]->getBigWall() >= 4)
-			return 0;
-		return _objects[part]->getTUCost(movementType);
+		const bool open = _objectsCache[part].isUfoDoor && _objectsCache[part].currentFrame > 1;
+		const bool passable = part == O_OBJECT && _objects[part]->getBigWall() >= 4;
+		if (!open && !passable)
+		{
+			for (int type = 0; type < TileStore::TUCostTypes; ++type)
+			{
+				costs[type] = _objects[part]->getTUCost((MovementType)type);
+			}
+		}
 	}
-	else
-		return 0;
+	_store->setTUCost(_index, part, costs);
 }
 
 /**
@@ -407,7 +402,7 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve, bo
 			return -1;
 		if (unit && cost.Time && !cost.haveTU())
 			return 4;
-		if (_unit && _unit != unit && _unit->getPosition() != getPosition())
+		if (getUnit() && getUnit() != unit && getUnit()->getPosition() != getPosition())
 			return -1;
 		setMapData(_objects[part]->getDataset()->getObject(_objects[part]->getAltMCD()), _objects[part]->getAltMCD(), _mapData->SetID[part],
 				   _objects[part]->getDataset()->getObject(_objects[part]->getAltMCD())->getObjectType());
@@ -453,13 +448,13 @@ int Tile::closeUfoDoor()
  */
 void Tile::setDiscovered(bool flag, TilePart part)
 {
-	if (_objectsCache[part].discovered != flag)
+	if (isDiscovered(part) != flag)
 	{
-		_objectsCache[part].discovered = flag;
+		_store->setDiscovered(_index, part, flag);
 		if (part == O_FLOOR && flag == true)
 		{
-			_objectsCache[O_WESTWALL].discovered = true;
-			_objectsCache[O_NORTHWALL].discovered = true;
+			_store->setDiscovered(_index, O_WESTWALL, true);
+			_store->setDiscovered(_index, O_NORTHWALL, true);
 		}
 	}
 }
@@ -471,7 +466,7 @@ void Tile::setDiscovered(bool flag, TilePart part)
  */
 bool Tile::isDiscovered(TilePart part) const
 {
-	return _objectsCache[part].discovered;
+	return _store->isDiscovered(_index, part);
 }
 
 
@@ -481,7 +476,7 @@ bool Tile::isDiscovered(TilePart part) const
  */
 void Tile::resetLight(LightLayers layer)
 {
-	_light[layer] = 0;
+	_store->setLight(_index, layer, 0);
 }
 
 /**
@@ -492,7 +487,7 @@ void Tile::resetLightMulti(LightLayers layer)
 {
 	for (int l = layer; l < LL_MAX; l++)
 	{
-		_light[l] = 0;
+		_store->setLight(_index, (LightLayers)l, 0);
 	}
 }
 
@@ -503,8 +498,8 @@ void Tile::resetLightMulti(LightLayers layer)
  */
 void Tile::addLight(int light, LightLayers layer)
 {
-	if (_light[layer] < light)
-		_light[layer] = light;
+	if (_store->getLight(_index, layer) < light)
+		_store->setLight(_index, layer, light);
 }
 
 /**
@@ -514,7 +509,7 @@ void Tile::addLight(int light, LightLayers layer)
  */
 int Tile::getLight(LightLayers layer) const
 {
-	return _light[layer];
+	return _store->getLight(_index, layer);
 }
 
 int Tile::getLightMulti(LightLayers layer) const
@@ -523,8 +518,7 @@ int Tile::getLightMulti(LightLayers layer) const
 
 	for (int l = layer; l >= 0; --l)
 	{
-		if (_light[l] > light)
-			light = _light[l];
+		light = std::max<int>(light, _store->getLight(_index, (LightLayers)l));
 	}
 
 	return light;
@@ -542,8 +536,7 @@ int Tile::getShade() const
 
 	for (int layer = 0; layer < LL_MAX; layer++)
 	{
-		if (_light[layer] > light)
-			light = _light[layer];
+		light = std::max<int>(light, _store->getLight(_index, (LightLayers)layer));
 	}
 
 	return std::max(0, 15 - light);
@@ -701,11 +694,11 @@ void Tile::ignite(int power)
 		}
 		if (RNG::percent(power) && getFuel())
 		{
-			if (_fire == 0)
+			if (getFire() == 0)
 			{
-				_smoke = 15 - Clamp(getFlammability() / 10, 1, 12);
+				_store->setSmoke(_index, 15 - Clamp(getFlammability() / 10, 1, 12));
 				_overlaps = 1;
-				_fire = getFuel() + 1;
+				_store->setFire(_index, getFuel() + 1);
 				_animationOffset = RNG::generate(0,3);
 			}
 		}
@@ -744,11 +737,11 @@ void Tile::animate()
 }
 
 /**
- * Update cached value of sprite.
+ * Update cached value of sprite and TU costs that depend on current frame.
  */
 void Tile::updateSprite(TilePart part)
 {
-	if (_objects[part])
+	if (_objects[part] && _objects[part]->getDataset()->getSurfaceset())
 	{
 		_currentSurface[part] = _objects[part]->getDataset()->getSurfaceset()->getFrame(_objects[part]->getSprite(_objectsCache[part].currentFrame));
 	}
@@ -756,6 +749,7 @@ void Tile::updateSprite(TilePart part)
 	{
 		_currentSurface[part] = nullptr;
 	}
+	updateTUCost(part);
 }
 
 /**
@@ -784,34 +778,25 @@ BattleUnit *Tile::getOverlappingUnit(const SavedBattleGame *saveBattleGame, Tile
  */
 void Tile::setFire(int fire)
 {
-	_fire = Clamp(fire, 0, 255);
+	_store->setFire(_index, Clamp(fire, 0, 255));
 	_animationOffset = RNG::generate(0,3);
 }
 
-/**
- * Get the amount of turns this tile is on fire. 0 = no fire.
- * @return fire : amount of turns this tile is on fire.
- */
-int Tile::getFire() const
-{
-	return _fire;
-}
-
 /**
  * Set the amount of turns this tile is smoking. 0 = no smoke.
  * @param smoke : amount of turns this tile is smoking.
  */
 void Tile::addSmoke(int smoke)
 {
-	if (_fire == 0)
+	if (getFire() == 0)
 	{
 		if (_overlaps == 0)
 		{
-			_smoke = Clamp(_smoke + smoke, 1, 15);
+			_store->setSmoke(_index, Clamp(getSmoke() + smoke, 1, 15));
 		}
 		else
 		{
-			_smoke += smoke;
+			_store->setSmoke(_index, getSmoke() + smoke);
 		}
 		_animationOffset = RNG::generate(0,3);
 		addOverlap();
@@ -824,20 +809,10 @@ void Tile::addSmoke(int smoke)
  */
 void Tile::setSmoke(int smoke)
 {
-	_smoke = Clamp(smoke, 0, 255);
+	_store->setSmoke(_index, Clamp(smoke, 0, 255));
 	_animationOffset = RNG::generate(0,3);
 }
 
-
-/**
- * Get the amount of turns this tile is smoking. 0 = no smoke.
- * @return smoke : amount of turns this tile is smoking.
- */
-int Tile::getSmoke() const
-{
-	return _smoke;
-}
-
 /**
  * Get the number of frames the fire or smoke animation is off-sync.
  * To void fire and smoke animations of different tiles moving nice in sync - it looks fake.
@@ -952,17 +927,17 @@ static inline void applyEnvi(BattleUnit* unit, int smoke, int fire, bool smokeDa
 void Tile::prepareNewTurn(bool smokeDamage)
 {
 	// we've received new smoke in this turn, but we're not on fire, average out the smoke.
-	if ( _overlaps != 0 && _smoke != 0 && _fire == 0)
+	if ( _overlaps != 0 && getSmoke() != 0 && getFire() == 0)
 	{
-		_smoke = Clamp((_smoke / _overlaps) - 1, 0, 15);
+		_store->setSmoke(_index, Clamp((getSmoke() / _overlaps) - 1, 0, 15));
 	}
 	// if we still have smoke/fire
-	if (_smoke)
+	if (getSmoke())
 	{
-		applyEnvi(_unit, _smoke, _fire, smokeDamage);
+		applyEnvi(getUnit(), getSmoke(), getFire(), smokeDamage);
 		for (auto* bi : _inventory)
 		{
-			applyEnvi(bi->getUnit(), _smoke, _fire, smokeDamage);
+			applyEnvi(bi->getUnit(), getSmoke(), getFire(), smokeDamage);
 		}
 	}
 	_overlaps = 0;
@@ -22,6 +22,7 @@
 #include "../Engine/Surface.h"
 #include "../Battlescape/Position.h"
 #include "../Mod/MapData.h"
+#include "TileStore.h"
 
 #include <SDL_types.h> // for Uint8
 
@@ -35,8 +36,6 @@ class RuleInventory;
 class SavedBattleGame;
 class ScriptParserBase;
 
-enum LightLayers : Uint8 { LL_AMBIENT, LL_FIRE, LL_ITEMS, LL_UNITS, LL_MAX };
-
 enum TileUnitOverlapping : int
 {
 	/// Any unit overlapping tile will be returned
@@ -49,6 +48,7 @@ enum TileUnitOverlapping : int
 
 /**
  * Basic element of which a battle map is build.
+ * Smoke, fire, light, discovered flags, unit and TU costs are kept in `TileStore` of battle.
  * @sa http://www.ufopaedia.org/index.php?title=MAPS
  */
 class Tile
@@ -94,7 +94,6 @@ public:
 	{
 		Sint8 offsetY;
 		Uint8 currentFrame:4;
-		Uint8 discovered:1;
 		Uint8 isUfoDoor:1;
 		Uint8 isDoor:1;
 		Uint8 isBackTileObject:1;
@@ -116,17 +115,15 @@ public:
 
 protected:
 	SavedBattleGame* _save;
+	TileStore* _store;
+	int _index;
 	MapData *_objects[O_MAX];
-	BattleUnit *_unit = nullptr;
 	std::vector<BattleItem *> _inventory;
 	std::unique_ptr<TileMapDataCache> _mapData = std::make_unique<TileMapDataCache>();
 	SurfaceRaw<const Uint8> _currentSurface[O_MAX] = { };
 	TileObjectCache _objectsCache[O_MAX] = { };
 	TileCache _cache = { };
 	Position _pos;
-	Uint8 _light[LL_MAX];
-	Uint8 _fire = 0;
-	Uint8 _smoke = 0;
 	Uint8 _markerColor = 0;
 	Uint8 _animationOffset = 0;
 	Uint8 _obstacle = 0;
@@ -141,6 +138,8 @@ protected:
 	int _lastExploredByHostile = 0;
 	int _lastExploredByNeutral = 0;
 
+	/// Update cached TU costs of tile part.
+	void updateTUCost(TilePart part);
 
 public:
 	/// Creates a tile.
@@ -199,7 +198,10 @@ public:
 	/// Gets whether this tile has no objects
 	bool isVoid() const;
 	/// Get the TU cost to walk over a certain part of the tile.
-	int getTUCost(int part, MovementType movementType) const;
+	int getTUCost(int part, MovementType movementType) const
+	{
+		return _store->getTUCost(_index, part, movementType);
+	}
 	/// Checks if this tile has a floor.
 	bool hasNoFloor(const SavedBattleGame *savedBattleGame = nullptr) const;
 	/// Checks if this tile has a GravLift floor.
@@ -240,6 +242,15 @@ public:
 		return _pos;
 	}
 
+	/**
+	 * Gets the tile's index in the map and in the tile store.
+	 * @return index
+	 */
+	int getIndex() const
+	{
+		return _index;
+	}
+
 	/// Gets the floor object footstep sound.
 	int getFootstepSound(Tile *tileBelow) const;
 	/// Open a door, returns the ID, 0(normal), 1(ufo) or -1 if no door opened.
@@ -343,7 +354,7 @@ public:
 	 */
 	void setUnit(BattleUnit *unit)
 	{
-		_unit = unit;
+		_store->setUnit(_index, unit);
 	}
 
 	/**
@@ -352,7 +363,7 @@ public:
 	 */
 	BattleUnit *getUnit() const
 	{
-		return _unit;
+		return _store->getUnit(_index);
 	}
 
 	/// Get unit from this tile or from tile below.
@@ -360,13 +371,13 @@ public:
 	/// Set fire, does not increment overlaps.
 	void setFire(int fire);
 	/// Get fire.
-	int getFire() const;
+	int getFire() const { return _store->getFire(_index); }
 	/// Add smoke, increments overlap.
 	void addSmoke(int smoke);
 	/// Set smoke, does not increment overlaps.
 	void setSmoke(int smoke);
 	/// Get smoke.
-	int getSmoke() const;
+	int getSmoke() const { return _store->getSmoke(_index); }
 	/// Get flammability.
 	int getFlammability() const;
 	/// Get turns to burn
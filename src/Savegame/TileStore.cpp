@@ -0,0 +1,59 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TileStore.h"
+#include <algorithm>
+
+namespace OpenXcom
+{
+
+/**
+ * Resizes all arrays to given number of tiles, every value is reset to zero.
+ * @param size Number of tiles.
+ */
+void TileStore::init(size_t size)
+{
+	_size = size;
+	_smoke.assign(size, 0);
+	_fire.assign(size, 0);
+	_discovered.assign(size, 0);
+	for (auto& layer : _light)
+	{
+		layer.assign(size, 0);
+	}
+	_tuCost.assign(size * TUCostStride, 0);
+	_units.assign(size, nullptr);
+}
+
+/**
+ * Stores TU costs of one part of tile. Pathfinding treat any cost of 255 or more
+ * as impassable, so bigger values are clamped without changing results.
+ * @param index Tile index.
+ * @param part Part of tile.
+ * @param costs Cost for each movement type.
+ */
+void TileStore::setTUCost(int index, int part, const int (&costs)[TUCostTypes])
+{
+	Uint8* dest = &_tuCost[index * TUCostStride + part * TUCostTypes];
+	for (int i = 0; i < TUCostTypes; ++i)
+	{
+		dest[i] = (Uint8)std::clamp(costs[i], 0, 255);
+	}
+}
+
+}
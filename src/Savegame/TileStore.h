@@ -0,0 +1,117 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_types.h>
+#include "../Mod/MapData.h"
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+
+enum LightLayers : Uint8 { LL_AMBIENT, LL_FIRE, LL_ITEMS, LL_UNITS, LL_MAX };
+
+/**
+ * Hot per tile state of battle map kept in packed arrays indexed by tile index.
+ * `Tile` objects are only facade over it, this allow scans over whole map
+ * (lighting, smoke, pathfinding) touch only data they need.
+ */
+class TileStore
+{
+public:
+	/// Number of movement types that have own TU cost in map data.
+	static constexpr int TUCostTypes = MT_SLIDE + 1;
+	/// Number of TU cost values for one tile.
+	static constexpr int TUCostStride = O_MAX * TUCostTypes;
+
+private:
+	size_t _size = 0;
+	std::vector<Uint8> _smoke;
+	std::vector<Uint8> _fire;
+	std::vector<Uint8> _discovered;
+	std::vector<Uint8> _light[LL_MAX];
+	std::vector<Uint8> _tuCost;
+	std::vector<BattleUnit*> _units;
+
+public:
+	/// Creates empty store.
+	TileStore() = default;
+
+	/// Resizes store to given number of tiles and resets all values.
+	void init(size_t size);
+	/// Number of tiles in store.
+	size_t size() const { return _size; }
+
+	/// Gets smoke of tile.
+	Uint8 getSmoke(int index) const { return _smoke[index]; }
+	/// Sets smoke of tile.
+	void setSmoke(int index, Uint8 smoke) { _smoke[index] = smoke; }
+	/// Gets smoke of all tiles.
+	const Uint8* getSmokeData() const { return _smoke.data(); }
+
+	/// Gets fire of tile.
+	Uint8 getFire(int index) const { return _fire[index]; }
+	/// Sets fire of tile.
+	void setFire(int index, Uint8 fire) { _fire[index] = fire; }
+	/// Gets fire of all tiles.
+	const Uint8* getFireData() const { return _fire.data(); }
+
+	/// Checks if part of tile is discovered.
+	bool isDiscovered(int index, TilePart part) const { return _discovered[index] & (1 << part); }
+	/// Sets discovered flag of part of tile.
+	void setDiscovered(int index, TilePart part, bool flag)
+	{
+		_discovered[index] = flag ? (_discovered[index] | (1 << part)) : (_discovered[index] & ~(1 << part));
+	}
+
+	/// Gets light of tile in given layer.
+	Uint8 getLight(int index, LightLayers layer) const { return _light[layer][index]; }
+	/// Sets light of tile in given layer.
+	void setLight(int index, LightLayers layer, Uint8 light) { _light[layer][index] = light; }
+	/// Gets light layer of all tiles.
+	Uint8* getLightData(LightLayers layer) { return _light[layer].data(); }
+	/// Gets light layer of all tiles.
+	const Uint8* getLightData(LightLayers layer) const { return _light[layer].data(); }
+
+	/// Gets unit standing on tile.
+	BattleUnit* getUnit(int index) const { return _units[index]; }
+	/// Sets unit standing on tile.
+	void setUnit(int index, BattleUnit* unit) { _units[index] = unit; }
+
+	/**
+	 * Gets TU cost of walking over part of tile.
+	 * @param index Tile index.
+	 * @param part Part of tile.
+	 * @param movementType Movement type, types without own cost return zero.
+	 * @return TU cost, values above 255 are stored as 255.
+	 */
+	int getTUCost(int index, int part, MovementType movementType) const
+	{
+		if (movementType >= TUCostTypes)
+		{
+			return 0;
+		}
+		return _tuCost[index * TUCostStride + part * TUCostTypes + movementType];
+	}
+	/// Stores TU costs of part of tile for every movement type.
+	void setTUCost(int index, int part, const int (&costs)[TUCostTypes]);
+};
+
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+#include "../../Battlescape/Pathfinding.h"
+#include "../../Battlescape/TileEngine.h"
+#include "../../Engine/Language.h"
+#include "../../Mod/MapData.h"
+#include "../../Mod/MapDataSet.h"
+#include "../../Mod/Mod.h"
+#include "../../Mod/ModFile.h"
+#include "../../Mod/RuleInventory.h"
+#include "../../Savegame/SavedBattleGame.h"
+#include "../../Savegame/Tile.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+const int SizeX = 32, SizeY = 32, SizeZ = 3;
+
+/**
+ * Map with floors on ground level and on part of upper level, random walls, objects and big walls.
+ */
+struct FovEngineTest : public ::testing::Test
+{
+	ModFile modFiles;
+	std::unique_ptr<Mod> mod;
+	Language lang;
+	std::unique_ptr<SavedBattleGame> save;
+	MapDataSet dataSet = MapDataSet("TEST");
+	std::vector<std::unique_ptr<MapData>> parts;
+
+	MapData* addPart(TilePart type, bool blockVision, int bigWall = 0)
+	{
+		parts.push_back(std::make_unique<MapData>(&dataSet));
+		MapData* dat = parts.back().get();
+		dat->setObjectType(type);
+		dat->setBlockValue(0, blockVision ? 1 : 0, 0, 0, 0, 0);
+		dat->setBigWall(bigWall);
+		if (type == O_OBJECT && bigWall == 0 && blockVision)
+		{
+			dat->setTUCosts(Pathfinding::INVALID_MOVE_COST, Pathfinding::INVALID_MOVE_COST, Pathfinding::INVALID_MOVE_COST);
+		}
+		return dat;
+	}
+
+	void SetUp() override
+	{
+		mod = std::make_unique<Mod>(modFiles);
+		// only rule needed by tile engine
+		(*mod->getInventories())["STR_GROUND"] = new RuleInventory("STR_GROUND", 0);
+		save = std::make_unique<SavedBattleGame>(mod.get(), &lang);
+		save->initMap(SizeX, SizeY, SizeZ);
+
+		MapData* floor = addPart(O_FLOOR, true);
+		MapData* westWall = addPart(O_WESTWALL, true);
+		MapData* northWall = addPart(O_NORTHWALL, true);
+		MapData* window = addPart(O_WESTWALL, false);
+		MapData* objects[] = {
+			addPart(O_OBJECT, true),
+			addPart(O_OBJECT, true, Pathfinding::BIGWALLNESW),
+			addPart(O_OBJECT, true, Pathfinding::BIGWALLNWSE),
+			addPart(O_OBJECT, true, Pathfinding::BIGWALLWEST),
+			addPart(O_OBJECT, true, Pathfinding::BIGWALLSOUTH),
+			addPart(O_OBJECT, false),
+		};
+
+		std::mt19937 rng(1234);
+		for (int z = 0; z < SizeZ; ++z)
+		{
+			for (int y = 0; y < SizeY; ++y)
+			{
+				for (int x = 0; x < SizeX; ++x)
+				{
+					Tile* tile = save->getTile(Position(x, y, z));
+					if (z == 0 || (z == 1 && x > SizeX / 2 && rng() % 4 != 0))
+					{
+						tile->setMapData(floor, 0, 0, O_FLOOR);
+					}
+					if (rng() % 10 == 0)
+					{
+						tile->setMapData(rng() % 3 ? westWall : window, 0, 0, O_WESTWALL);
+					}
+					if (rng() % 10 == 0)
+					{
+						tile->setMapData(northWall, 0, 0, O_NORTHWALL);
+					}
+					if (rng() % 25 == 0)
+					{
+						tile->setMapData(objects[rng() % std::size(objects)], 0, 0, O_OBJECT);
+					}
+				}
+			}
+		}
+		save->initUtilities(mod.get());
+		save->getTileEngine()->calculateLighting(LL_AMBIENT, TileEngine::invalid, 0, true);
+	}
+
+	void TearDown() override
+	{
+		save.reset();
+		mod.reset();
+	}
+
+	std::vector<int> tilesInFOV(FovEngine engine, Position eye, int direction, int size)
+	{
+		std::vector<Position> tiles;
+		save->getTileEngine()->getTilesInFOV(engine, eye, direction, size, tiles);
+
+		std::vector<int> indexes;
+		for (const auto& p : tiles)
+		{
+			indexes.push_back(save->getTileIndex(p));
+		}
+		std::sort(indexes.begin(), indexes.end());
+		indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+		return indexes;
+	}
+};
+
+}
+
+TEST_F(FovEngineTest, PropagationMatchesLegacy)
+{
+	std::mt19937 rng(99);
+	for (int i = 0; i < 40; ++i)
+	{
+		const int size = i % 4 == 0 ? 2 : 1;
+		const Position eye(rng() % (SizeX - 1), rng() % (SizeY - 1), i % 5 == 0 ? 1 : 0);
+		for (int direction = 0; direction < 8; ++direction)
+		{
+			const auto legacy = tilesInFOV(FOV_ENGINE_LEGACY, eye, direction, size);
+			const auto propagation = tilesInFOV(FOV_ENGINE_PROPAGATION, eye, direction, size);
+			EXPECT_FALSE(legacy.empty());
+			EXPECT_EQ(legacy, propagation) << "eye " << eye << " direction " << direction << " size " << size;
+		}
+	}
+}
+
+TEST_F(FovEngineTest, ParityModeUsesLegacy)
+{
+	const Position eye(SizeX / 2, SizeY / 2, 0);
+	for (int direction = 0; direction < 8; ++direction)
+	{
+		EXPECT_EQ(tilesInFOV(FOV_ENGINE_PARITY, eye, direction, 1), tilesInFOV(FOV_ENGINE_LEGACY, eye, direction, 1));
+	}
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include "../../Battlescape/InfluenceMap.h"
+#include "../../Battlescape/ReachabilityCache.h"
+#include "../../Battlescape/PathfindingNode.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+const int SizeX = 10, SizeY = 8, SizeZ = 2;
+
+struct InfluenceMapTest : public ::testing::Test
+{
+	InfluenceMap map;
+
+	void SetUp() override
+	{
+		map.init(SizeX, SizeY, SizeZ);
+	}
+};
+
+}
+
+TEST_F(InfluenceMapTest, AddSumsValues)
+{
+	EXPECT_EQ(map.get(IL_ENEMY_REACH, 5), 0.0f);
+
+	map.add(IL_ENEMY_REACH, 5, 3.0f);
+	map.add(IL_ENEMY_REACH, 5, 4.0f);
+	map.add(IL_ENEMY_REACH, 7, 1.0f);
+
+	EXPECT_EQ(map.get(IL_ENEMY_REACH, 5), 7.0f);
+	EXPECT_EQ(map.get(IL_ENEMY_REACH, 7), 1.0f);
+	EXPECT_EQ(map.get(IL_FRIEND_REACH, 5), 0.0f);
+	ASSERT_EQ(map.getTiles(IL_ENEMY_REACH).size(), 2u);
+	EXPECT_EQ(map.getTiles(IL_ENEMY_REACH)[0], 5);
+	EXPECT_EQ(map.getTiles(IL_ENEMY_REACH)[1], 7);
+}
+
+TEST_F(InfluenceMapTest, ClearDropsOnlyGivenLayer)
+{
+	map.add(IL_ENEMY_REACH, 5, 3.0f);
+	map.add(IL_FRIEND_REACH, 5, 2.0f);
+
+	map.clear(IL_ENEMY_REACH);
+	EXPECT_EQ(map.get(IL_ENEMY_REACH, 5), 0.0f);
+	EXPECT_TRUE(map.getTiles(IL_ENEMY_REACH).empty());
+	EXPECT_EQ(map.get(IL_FRIEND_REACH, 5), 2.0f);
+
+	map.add(IL_ENEMY_REACH, 5, 1.0f);
+	EXPECT_EQ(map.get(IL_ENEMY_REACH, 5), 1.0f);
+
+	map.clear();
+	EXPECT_TRUE(map.getTiles(IL_FRIEND_REACH).empty());
+}
+
+TEST_F(InfluenceMapTest, TilesByValue)
+{
+	map.add(IL_FRIEND_REACH, 10, 2.0f);
+	map.add(IL_FRIEND_REACH, 3, 9.0f);
+	map.add(IL_FRIEND_REACH, 12, 2.0f);
+	map.add(IL_FRIEND_REACH, 1, 5.0f);
+
+	const auto& tiles = map.getTilesByValue(IL_FRIEND_REACH);
+	ASSERT_EQ(tiles.size(), 4u);
+	EXPECT_EQ(tiles[0], 3);
+	EXPECT_EQ(tiles[1], 1);
+	EXPECT_EQ(tiles[2], 10);
+	EXPECT_EQ(tiles[3], 12);
+
+	// insertion order is kept
+	const auto& inOrder = map.getTiles(IL_FRIEND_REACH);
+	ASSERT_EQ(inOrder.size(), 4u);
+	EXPECT_EQ(inOrder[0], 10);
+	EXPECT_EQ(inOrder[1], 3);
+	EXPECT_EQ(inOrder[2], 12);
+	EXPECT_EQ(inOrder[3], 1);
+}
+
+TEST_F(InfluenceMapTest, PositionRoundTrip)
+{
+	Position p(3, 5, 1);
+	int i = map.getTileIndex(p);
+	EXPECT_EQ(i, 3 + 5 * SizeX + SizeX * SizeY);
+	EXPECT_EQ(map.getPosition(i), p);
+}
+
+TEST_F(InfluenceMapTest, AddReachableArea)
+{
+	std::vector<PathfindingNode> nodes;
+	nodes.reserve(2);
+	nodes.emplace_back(Position(1, 1, 0));
+	nodes.back().connect({ 10, 0 }, nullptr, 0);
+	nodes.emplace_back(Position(2, 1, 0));
+	nodes.back().connect({ 20, 0 }, nullptr, 0);
+	std::vector<PathfindingNode*> reachable = { &nodes[0], &nodes[1] };
+
+	ReachabilityCache cache;
+	cache.init(SizeX, SizeY, SizeZ);
+	ReachabilityKey key;
+	key.unitId = 1;
+	const auto area = cache.store(key, reachable, 50, false);
+
+	map.add(IL_ENEMY_REACH, *area);
+	map.add(IL_ENEMY_REACH, *area);
+	EXPECT_EQ(map.get(IL_ENEMY_REACH, map.getTileIndex(Position(1, 1, 0))), 80.0f);
+	EXPECT_EQ(map.get(IL_ENEMY_REACH, map.getTileIndex(Position(2, 1, 0))), 60.0f);
+}
+
+TEST_F(InfluenceMapTest, ChannelsOfTile)
+{
+	EXPECT_FALSE(map.has(IL_THREAT, 5));
+	map.set(IL_THREAT, 5, 3, 2.0f);
+	EXPECT_TRUE(map.has(IL_THREAT, 5));
+	EXPECT_EQ(map.get(IL_THREAT, 5, 3), 2.0f);
+	EXPECT_EQ(map.get(IL_THREAT, 5, 0), 0.0f);
+	EXPECT_FALSE(map.has(IL_THREAT, 6));
+
+	map.set(IL_THREAT, 6, 7, 1.0f);
+	EXPECT_EQ(map.get(IL_THREAT, 5, 3), 2.0f);
+	EXPECT_EQ(map.get(IL_THREAT, 6, 7), 1.0f);
+	EXPECT_EQ(map.getTiles(IL_THREAT).size(), 2u);
+}
+
+TEST_F(InfluenceMapTest, ThreatKeptWhileSourcesDoNotChange)
+{
+	map.setThreatSources({ Position(4, 4, 0) });
+	map.set(IL_THREAT, 1, 0, 1.0f);
+
+	map.setThreatSources({ Position(4, 4, 0) });
+	EXPECT_TRUE(map.has(IL_THREAT, 1));
+
+	// unit moving elsewhere keep threat
+	map.invalidate(Position(7, 7, 0), 1);
+	EXPECT_TRUE(map.has(IL_THREAT, 1));
+
+	// known enemy moved
+	map.invalidate(Position(3, 3, 0), 2);
+	EXPECT_FALSE(map.has(IL_THREAT, 1));
+
+	map.set(IL_THREAT, 1, 0, 1.0f);
+	map.setThreatSources({ Position(5, 4, 0) });
+	EXPECT_FALSE(map.has(IL_THREAT, 1));
+}
+
+TEST_F(InfluenceMapTest, TerrainChangeDropsCoverNearIt)
+{
+	const int near0 = map.getTileIndex(Position(1, 1, 0));
+	const int near1 = map.getTileIndex(Position(2, 1, 1));
+	const int far = map.getTileIndex(Position(8, 6, 0));
+	map.set(IL_COVER, near0, 0, 0.5f);
+	map.set(IL_COVER, near1, 0, 0.5f);
+	map.set(IL_COVER, far, 0, 0.5f);
+	ReachabilityKey key;
+	key.unitId = 1;
+	map.setExposure(key);
+	map.set(IL_EXPOSURE, far, InfluenceMap::ExposureCost, 12.0f);
+	EXPECT_TRUE(map.hasExposure(key));
+
+	map.invalidate(MapSubset({ 0, 3 }, { 0, 3 }));
+	EXPECT_FALSE(map.has(IL_COVER, near0));
+	EXPECT_FALSE(map.has(IL_COVER, near1));
+	EXPECT_TRUE(map.has(IL_COVER, far));
+	ASSERT_EQ(map.getTiles(IL_COVER).size(), 1u);
+	EXPECT_EQ(map.getTiles(IL_COVER)[0], far);
+	// paths from anywhere could go there
+	EXPECT_FALSE(map.hasExposure(key));
+	EXPECT_FALSE(map.has(IL_EXPOSURE, far));
+}
+
+TEST_F(InfluenceMapTest, UnitMoveDropsExposure)
+{
+	ReachabilityKey key;
+	key.unitId = 1;
+	map.setExposure(key);
+	map.set(IL_EXPOSURE, 3, InfluenceMap::ExposureCost, 12.0f);
+	map.set(IL_COVER, 3, 0, 0.5f);
+
+	map.invalidate(Position(7, 7, 0), 1);
+	EXPECT_FALSE(map.hasExposure(key));
+	EXPECT_FALSE(map.has(IL_EXPOSURE, 3));
+	EXPECT_TRUE(map.has(IL_COVER, 3));
+}
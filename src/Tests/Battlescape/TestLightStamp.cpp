@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include "../../Battlescape/LightStamp.h"
+#include "../../fmath.h"
+
+using namespace OpenXcom;
+
+TEST(LightStampTest, MatchesDistanceFalloff)
+{
+	for (int power = 1; power < 16; ++power)
+	{
+		LightStamp stamp(power);
+		for (int z = -power - 1; z <= power + 1; ++z)
+		{
+			for (int y = -power - 1; y <= power + 1; ++y)
+			{
+				for (int x = -power - 1; x <= power + 1; ++x)
+				{
+					const Position diff(x, y, z);
+					const int distance = (int)Round(Position::distance(diff.toVoxel(), Position(0, 0, 0)) / Position::TileXY);
+					EXPECT_EQ(stamp.get(diff), std::max(0, power - distance)) << power << " " << x << " " << y << " " << z;
+				}
+			}
+		}
+	}
+}
+
+TEST(LightStampTest, RowMatchesGet)
+{
+	LightStamp stamp(6);
+	const Uint8* row = stamp.getRow(-2, 1);
+	for (int x = -stamp.getRadius(); x <= stamp.getRadius(); ++x)
+	{
+		EXPECT_EQ(row[x + stamp.getRadius()], stamp.get(Position(x, -2, 1)));
+	}
+}
+
+TEST(LightStampTest, BlendRowMatchesPerTileCheck)
+{
+	const int size = 53;
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> dist(0, 15);
+
+	for (int layer = 0; layer < 4; ++layer)
+	{
+		std::vector<Uint8> data[4];
+		Uint8* layers[4];
+		for (int l = 0; l < 4; ++l)
+		{
+			data[l].resize(size + 3);
+			std::generate(data[l].begin(), data[l].end(), [&]{ return (Uint8)dist(rng); });
+			layers[l] = data[l].data();
+		}
+		std::vector<Uint8> light(size);
+		std::generate(light.begin(), light.end(), [&]{ return (Uint8)dist(rng); });
+
+		std::vector<Uint8> expected = data[layer];
+		for (int i = 0; i < size; ++i)
+		{
+			int multi = 0;
+			for (int l = 0; l <= layer; ++l)
+			{
+				multi = std::max<int>(multi, data[l][i + 3]);
+			}
+			if (light[i] > multi)
+			{
+				expected[i + 3] = light[i];
+			}
+		}
+
+		LightStamp::blendRow(layers, layer, 3, light.data(), size);
+		EXPECT_EQ(data[layer], expected) << "layer " << layer;
+	}
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "../../Battlescape/PathfindingOpenSet.h"
+#include "../../Battlescape/PathfindingNode.h"
+
+using namespace OpenXcom;
+
+TEST(PathfindingOpenSetTest, PopsInCostOrder)
+{
+	std::vector<PathfindingNode> nodes;
+	for (int i = 0; i < 20; ++i)
+	{
+		nodes.emplace_back(Position(i, 0, 0));
+	}
+
+	PathfindingOpenSet set;
+	for (int i = 0; i < 20; ++i)
+	{
+		nodes[i].reset(1);
+		nodes[i].connect({ (i * 7) % 20, 0 }, nullptr, 0);
+		set.push(&nodes[i]);
+		EXPECT_TRUE(nodes[i].inOpenSet());
+	}
+
+	int last = -1;
+	while (!set.empty())
+	{
+		PathfindingNode* n = set.pop();
+		EXPECT_FALSE(n->inOpenSet());
+		EXPECT_LE(last, n->getTUCost(false).time);
+		last = n->getTUCost(false).time;
+	}
+}
+
+TEST(PathfindingOpenSetTest, DecreaseKeyMovesNode)
+{
+	PathfindingNode a(Position(0, 0, 0)), b(Position(1, 0, 0)), c(Position(2, 0, 0));
+	a.reset(1);
+	b.reset(1);
+	c.reset(1);
+
+	PathfindingOpenSet set;
+	a.connect({ 5, 0 }, nullptr, 0);
+	b.connect({ 10, 0 }, nullptr, 0);
+	c.connect({ 15, 0 }, nullptr, 0);
+	set.push(&a);
+	set.push(&b);
+	set.push(&c);
+
+	// node already in set is updated in place, not added second time
+	c.connect({ 1, 0 }, nullptr, 0);
+	set.push(&c);
+
+	EXPECT_EQ(set.pop(), &c);
+	EXPECT_EQ(set.pop(), &a);
+	EXPECT_EQ(set.pop(), &b);
+	EXPECT_TRUE(set.empty());
+}
+
+TEST(PathfindingOpenSetTest, ClearKeepsNodesConsistent)
+{
+	PathfindingNode a(Position(0, 0, 0)), b(Position(1, 0, 0));
+	a.reset(1);
+	b.reset(1);
+
+	PathfindingOpenSet set;
+	set.push(&a);
+	set.push(&b);
+	set.clear();
+
+	EXPECT_TRUE(set.empty());
+	EXPECT_FALSE(a.inOpenSet());
+	EXPECT_FALSE(b.inOpenSet());
+}
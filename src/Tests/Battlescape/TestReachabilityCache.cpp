@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include "../../Battlescape/ReachabilityCache.h"
+#include "../../Battlescape/PathfindingNode.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+const int SizeX = 10, SizeY = 10, SizeZ = 2;
+
+int index(Position p)
+{
+	return p.z * SizeX * SizeY + p.y * SizeX + p.x;
+}
+
+struct ReachabilityCacheTest : public ::testing::Test
+{
+	ReachabilityCache cache;
+	std::vector<PathfindingNode> nodes;
+	std::vector<PathfindingNode*> reachable;
+
+	void SetUp() override
+	{
+		cache.init(SizeX, SizeY, SizeZ);
+
+		// small area around (4,4,0) with cost growing with distance
+		nodes.reserve(9);
+		for (int x = 3; x <= 5; ++x)
+		{
+			for (int y = 3; y <= 5; ++y)
+			{
+				nodes.emplace_back(Position(x, y, 0));
+				nodes.back().connect({ 4 * (std::abs(x - 4) + std::abs(y - 4)), 0 }, nullptr, 0);
+			}
+		}
+		for (auto& n : nodes)
+		{
+			reachable.push_back(&n);
+		}
+	}
+
+	ReachabilityKey key(int unitId)
+	{
+		ReachabilityKey k;
+		k.unitId = unitId;
+		k.startIndex = index(Position(4, 4, 0));
+		k.tuMax = 50;
+		return k;
+	}
+};
+
+}
+
+TEST_F(ReachabilityCacheTest, StoreAndFind)
+{
+	EXPECT_EQ(cache.find(key(1)), nullptr);
+
+	const auto area = cache.store(key(1), reachable, 50, true);
+	EXPECT_EQ(area->size(), 9u);
+	EXPECT_TRUE(area->getRanOutOfTUs());
+	EXPECT_TRUE(area->isReachable(index(Position(4, 4, 0))));
+	EXPECT_EQ(area->getTULeft(index(Position(4, 4, 0))), 50);
+	EXPECT_EQ(area->getTULeft(index(Position(3, 3, 0))), 42);
+	EXPECT_FALSE(area->isReachable(index(Position(7, 7, 0))));
+
+	EXPECT_EQ(cache.find(key(1)), area);
+	EXPECT_EQ(cache.find(key(2)), nullptr);
+
+	auto other = key(1);
+	other.ignoreFriends = true;
+	EXPECT_EQ(cache.find(other), nullptr);
+}
+
+TEST_F(ReachabilityCacheTest, IterationOrderMatchesPositionComparator)
+{
+	const auto area = cache.store(key(1), reachable, 50, false);
+	Position last(-1, -1, -1);
+	for (const auto& p : *area)
+	{
+		if (last != Position(-1, -1, -1))
+		{
+			EXPECT_TRUE(PositionComparator{}(last, p.first));
+		}
+		EXPECT_EQ(p.second, area->getTULeft(index(p.first)));
+		last = p.first;
+	}
+}
+
+TEST_F(ReachabilityCacheTest, UnitMoveInvalidatesNearbyAreas)
+{
+	cache.store(key(1), reachable, 50, false);
+
+	// far away unit does not change anything
+	cache.invalidate(Position(8, 8, 0), 1);
+	EXPECT_NE(cache.find(key(1)), nullptr);
+
+	// unit next to the area can block its border
+	cache.invalidate(Position(6, 4, 0), 1);
+	EXPECT_EQ(cache.find(key(1)), nullptr);
+	EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(ReachabilityCacheTest, BigUnitMoveInvalidatesByAllParts)
+{
+	cache.store(key(1), reachable, 50, false);
+
+	cache.invalidate(Position(1, 1, 0), 1);
+	EXPECT_NE(cache.find(key(1)), nullptr);
+
+	// part at (2, 2) is next to the area
+	cache.invalidate(Position(1, 1, 0), 2);
+	EXPECT_EQ(cache.find(key(1)), nullptr);
+}
+
+TEST_F(ReachabilityCacheTest, TerrainChangeAndClear)
+{
+	cache.store(key(1), reachable, 50, false);
+	cache.store(key(2), reachable, 50, false);
+	EXPECT_EQ(cache.size(), 2u);
+
+	cache.invalidate(MapSubset({ 7, 10 }, { 7, 10 }));
+	EXPECT_EQ(cache.size(), 2u);
+
+	cache.invalidate(MapSubset({ 0, 3 }, { 0, 3 }));
+	EXPECT_EQ(cache.size(), 0u);
+
+	cache.store(key(1), reachable, 50, false);
+	cache.clear();
+	EXPECT_EQ(cache.find(key(1)), nullptr);
+}
+
+TEST_F(ReachabilityCacheTest, FillAndInsert)
+{
+	cache.store(key(1), reachable, 50, false);
+	cache.clear();
+
+	auto area = std::make_unique<ReachableArea>();
+	cache.fill(*area, key(2), reachable, 40, true);
+	EXPECT_EQ(cache.find(key(2)), nullptr);
+
+	const ReachableArea* filled = area.get();
+	const auto stored = cache.insert(std::move(area));
+	EXPECT_EQ(stored.get(), filled);
+	EXPECT_EQ(cache.find(key(2)).get(), filled);
+	EXPECT_EQ(cache.size(), 1u);
+	EXPECT_TRUE(stored->getRanOutOfTUs());
+	EXPECT_EQ(stored->getTULeft(index(Position(4, 4, 0))), 40);
+
+	// area with same key is replaced
+	auto again = std::make_unique<ReachableArea>();
+	cache.fill(*again, key(2), reachable, 30, false);
+	cache.insert(std::move(again));
+	EXPECT_EQ(cache.size(), 1u);
+	EXPECT_EQ(cache.find(key(2))->getTULeft(index(Position(4, 4, 0))), 30);
+}
+
+TEST_F(ReachabilityCacheTest, HeldAreaSurviveReplace)
+{
+	const auto held = cache.store(key(1), reachable, 50, false);
+	cache.store(key(1), reachable, 20, false);
+	EXPECT_EQ(held->getTULeft(index(Position(4, 4, 0))), 50);
+	EXPECT_EQ(cache.find(key(1))->getTULeft(index(Position(4, 4, 0))), 20);
+
+	// dropped area that is still held is not reused for new search
+	const auto current = cache.find(key(1));
+	cache.clear();
+	const auto again = cache.store(key(2), reachable, 30, false);
+	EXPECT_NE(again, current);
+	EXPECT_EQ(current->getTULeft(index(Position(4, 4, 0))), 20);
+}
+
+TEST_F(ReachabilityCacheTest, NumberOfAreasIsLimited)
+{
+	const auto first = cache.store(key(0), reachable, 50, false);
+	for (int i = 1; i <= (int)ReachabilityCache::capacity(); ++i)
+	{
+		cache.store(key(i), reachable, 50, false);
+	}
+	EXPECT_EQ(cache.size(), ReachabilityCache::capacity());
+	// oldest one was replaced, but still can be used by holder
+	EXPECT_EQ(cache.find(key(0)), nullptr);
+	EXPECT_NE(cache.find(key(1)), nullptr);
+	EXPECT_EQ(first->size(), 9u);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "../../Battlescape/VisibilityCache.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+	constexpr int SizeX = 10;
+	constexpr int SizeY = 10;
+	constexpr int SizeZ = 4;
+
+	int index(int x, int y, int z)
+	{
+		return z * SizeX * SizeY + y * SizeX + x;
+	}
+}
+
+TEST(VisibilityCacheTest, SetAndGet)
+{
+	VisibilityCache cache;
+	cache.init(SizeX, SizeY, SizeZ);
+
+	bool visible = false;
+	EXPECT_FALSE(cache.get(index(0, 0, 0), index(5, 5, 0), visible));
+
+	cache.set(index(0, 0, 0), index(5, 5, 0), true);
+	cache.set(index(1, 0, 0), index(5, 5, 0), false);
+
+	EXPECT_TRUE(cache.get(index(0, 0, 0), index(5, 5, 0), visible));
+	EXPECT_TRUE(visible);
+	EXPECT_TRUE(cache.get(index(1, 0, 0), index(5, 5, 0), visible));
+	EXPECT_FALSE(visible);
+	EXPECT_FALSE(cache.has(index(5, 5, 0), index(0, 0, 0)));
+	EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(VisibilityCacheTest, FirstValueIsKept)
+{
+	VisibilityCache cache;
+	cache.init(SizeX, SizeY, SizeZ);
+
+	cache.set(index(0, 0, 0), index(5, 5, 0), true);
+	cache.set(index(0, 0, 0), index(5, 5, 0), false);
+
+	bool visible = false;
+	EXPECT_TRUE(cache.get(index(0, 0, 0), index(5, 5, 0), visible));
+	EXPECT_TRUE(visible);
+}
+
+TEST(VisibilityCacheTest, Clear)
+{
+	VisibilityCache cache;
+	cache.init(SizeX, SizeY, SizeZ);
+
+	cache.set(index(0, 0, 0), index(5, 5, 0), true);
+	cache.clear();
+
+	EXPECT_FALSE(cache.has(index(0, 0, 0), index(5, 5, 0)));
+	EXPECT_EQ(cache.size(), 0u);
+
+	cache.set(index(0, 0, 0), index(5, 5, 0), false);
+	bool visible = true;
+	EXPECT_TRUE(cache.get(index(0, 0, 0), index(5, 5, 0), visible));
+	EXPECT_FALSE(visible);
+}
+
+TEST(VisibilityCacheTest, InvalidateOnlyCrossingLines)
+{
+	VisibilityCache cache;
+	cache.init(SizeX, SizeY, SizeZ);
+
+	cache.set(index(0, 0, 0), index(4, 4, 0), true);
+	cache.set(index(0, 0, 1), index(2, 2, 3), true);
+	cache.set(index(6, 6, 0), index(9, 9, 0), true);
+
+	// change at tile (3, 3), on any level
+	cache.invalidate(MapSubset{ std::make_pair(3, 4), std::make_pair(3, 4) });
+
+	EXPECT_FALSE(cache.has(index(0, 0, 0), index(4, 4, 0)));
+	EXPECT_TRUE(cache.has(index(0, 0, 1), index(2, 2, 3)));
+	EXPECT_TRUE(cache.has(index(6, 6, 0), index(9, 9, 0)));
+
+	// stale entry can be filled again
+	cache.set(index(0, 0, 0), index(4, 4, 0), false);
+	bool visible = true;
+	EXPECT_TRUE(cache.get(index(0, 0, 0), index(4, 4, 0), visible));
+	EXPECT_FALSE(visible);
+}
+
+TEST(VisibilityCacheTest, Grow)
+{
+	VisibilityCache cache;
+	cache.init(SizeX, SizeY, SizeZ);
+
+	const int tiles = SizeX * SizeY * SizeZ;
+	for (int from = 0; from < tiles; ++from)
+	{
+		for (int to = 0; to < 8; ++to)
+		{
+			cache.set(from, to, (from + to) % 2 == 0);
+		}
+	}
+	EXPECT_EQ(cache.size(), size_t(tiles * 8));
+
+	bool visible = false;
+	EXPECT_TRUE(cache.get(123, 5, visible));
+	EXPECT_TRUE(visible);
+	EXPECT_TRUE(cache.get(124, 5, visible));
+	EXPECT_FALSE(visible);
+}
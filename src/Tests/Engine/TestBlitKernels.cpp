@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include "../../Engine/BlitKernels.h"
+#include "../../Engine/SurfaceSpans.h"
+#include "../../Engine/ShaderDraw.h"
+#include "../../Engine/ShaderMove.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+std::vector<Uint8> makePixels(size_t size, std::mt19937& rng)
+{
+	std::vector<Uint8> pixels(size);
+	for (auto& p : pixels)
+	{
+		p = (rng() % 4) ? (Uint8)(rng() % 256) : 0;
+	}
+	return pixels;
+}
+
+}
+
+TEST(BlitKernelsTest, RowsMatchScalarHelpers)
+{
+	std::mt19937 rng(4321);
+	const BlitKernels::Level best = BlitKernels::getBestLevel();
+	for (int level = BlitKernels::BK_SCALAR; level <= best; ++level)
+	{
+		ASSERT_EQ(BlitKernels::setLevel((BlitKernels::Level)level), level);
+		for (int size = 0; size < 100; size += 7)
+		{
+			const std::vector<Uint8> src = makePixels(size, rng);
+			const std::vector<Uint8> background = makePixels(size, rng);
+			for (int shade : { -3, 0, 1, 7, 15, 200 })
+			{
+				std::vector<Uint8> expected = background;
+				std::vector<Uint8> actual = background;
+				for (int i = 0; i < size; ++i)
+				{
+					helper::StandardShade::func(expected[i], src[i], shade);
+				}
+				BlitKernels::shadeRow(actual.data(), src.data(), size, shade);
+				ASSERT_EQ(actual, expected) << level << " " << size << " " << shade;
+
+				for (int newColor : { 0x00, 0x40, 0xF0 })
+				{
+					expected = background;
+					actual = background;
+					for (int i = 0; i < size; ++i)
+					{
+						helper::ColorReplace::func(expected[i], src[i], shade, newColor);
+					}
+					BlitKernels::replaceRow(actual.data(), src.data(), size, shade, newColor);
+					ASSERT_EQ(actual, expected) << level << " " << size << " " << shade << " " << newColor;
+				}
+			}
+		}
+	}
+	BlitKernels::setLevel(best);
+}
+
+TEST(BlitKernelsTest, SpanRowsMatchShaderDraw)
+{
+	const int width = 32, height = 40;
+	const int destWidth = 70, destHeight = 45;
+	std::mt19937 rng(1234);
+	std::vector<Uint8> sprite = makePixels(width * height, rng);
+	for (int y = 0; y < height; ++y)
+	{
+		sprite[y * width] = 0;
+		sprite[y * width + width - 1] = 0;
+	}
+	SurfaceRaw<const Uint8> src(sprite, width, height);
+	SurfaceSpans spans(src);
+	const std::vector<Uint8> background = makePixels(destWidth * destHeight, rng);
+	const GraphSubset area{ std::make_pair(10, 60), std::make_pair(5, 40) };
+
+	for (int shade : { 0, 5, 15 })
+	{
+		for (int x = -35; x <= destWidth; x += 7)
+		{
+			for (int y = -42; y <= destHeight; y += 9)
+			{
+				std::vector<Uint8> expected = background;
+				ShaderMove<Uint8> dest(SurfaceRaw<Uint8>(expected, destWidth, destHeight));
+				dest.setDomain(area);
+				ShaderDraw<helper::StandardShade>(dest, ShaderMove<const Uint8>(src, x, y), ShaderScalar(shade));
+
+				auto rowFunc = [&](Uint8* d, const Uint8* s, int size){ BlitKernels::shadeRow(d, s, size, shade); };
+
+				std::vector<Uint8> actual = background;
+				spans.drawRows(SurfaceRaw<Uint8>(actual, destWidth, destHeight), src, x, y, area, rowFunc);
+				ASSERT_EQ(actual, expected) << shade << " " << x << " " << y;
+
+				actual = background;
+				BlitKernels::drawRows(SurfaceRaw<Uint8>(actual, destWidth, destHeight), src, x, y, area, rowFunc);
+				ASSERT_EQ(actual, expected) << shade << " " << x << " " << y;
+			}
+		}
+	}
+}
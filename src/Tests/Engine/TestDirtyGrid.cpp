@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include "../../Engine/DirtyGrid.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+std::vector<GraphSubset> collectRuns(const DirtyGrid& grid, bool dirty)
+{
+	std::vector<GraphSubset> runs;
+	grid.forEachRun(dirty, [&](const GraphSubset& area){ runs.push_back(area); });
+	return runs;
+}
+
+}
+
+TEST(DirtyGridTest, StartsAllDirtyAfterResize)
+{
+	DirtyGrid grid;
+	grid.resize(40, 20);
+	EXPECT_TRUE(grid.isAllDirty());
+	EXPECT_TRUE(grid.intersects(GraphSubset(1, 1)));
+
+	// runs are clipped to size of grid
+	auto runs = collectRuns(grid, true);
+	ASSERT_EQ(runs.size(), 2u);
+	EXPECT_EQ(runs[0], GraphSubset(std::make_pair(0, 40), std::make_pair(0, 16)));
+	EXPECT_EQ(runs[1], GraphSubset(std::make_pair(0, 40), std::make_pair(16, 20)));
+
+	grid.clear();
+	EXPECT_TRUE(grid.isClean());
+	EXPECT_FALSE(grid.intersects(GraphSubset(40, 20)));
+	EXPECT_TRUE(collectRuns(grid, true).empty());
+}
+
+TEST(DirtyGridTest, InvalidatesCellsTouchedByArea)
+{
+	DirtyGrid grid;
+	grid.resize(64, 64);
+	grid.clear();
+
+	// area partly outside of grid and touching two cells
+	grid.invalidate(GraphSubset(std::make_pair(-10, 17), std::make_pair(20, 30)));
+	EXPECT_FALSE(grid.isClean());
+	EXPECT_FALSE(grid.isAllDirty());
+	EXPECT_FLOAT_EQ(grid.getDirtyRatio(), 2.0f / 16.0f);
+
+	EXPECT_TRUE(grid.intersects(GraphSubset(std::make_pair(31, 40), std::make_pair(31, 40))));
+	EXPECT_FALSE(grid.intersects(GraphSubset(std::make_pair(32, 40), std::make_pair(0, 64))));
+	EXPECT_FALSE(grid.intersects(GraphSubset(std::make_pair(0, 64), std::make_pair(32, 64))));
+
+	auto dirty = collectRuns(grid, true);
+	ASSERT_EQ(dirty.size(), 1u);
+	EXPECT_EQ(dirty[0], GraphSubset(std::make_pair(0, 32), std::make_pair(16, 32)));
+
+	// clean runs cover everything else
+	int cleanPixels = 0;
+	for (const auto& area : collectRuns(grid, false))
+	{
+		cleanPixels += area.size_x() * area.size_y();
+	}
+	EXPECT_EQ(cleanPixels, 64 * 64 - 32 * 16);
+
+	// areas fully outside change nothing
+	grid.invalidate(GraphSubset(std::make_pair(64, 100), std::make_pair(0, 64)));
+	EXPECT_FLOAT_EQ(grid.getDirtyRatio(), 2.0f / 16.0f);
+}
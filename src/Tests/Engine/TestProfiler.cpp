@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../../Engine/Profiler.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+std::string captureTrace()
+{
+	Profiler::stopCapture();
+	std::ostringstream out;
+	Profiler::writeTrace(out);
+	return out.str();
+}
+
+size_t countOf(const std::string& text, const std::string& part)
+{
+	size_t count = 0;
+	for (size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1))
+	{
+		++count;
+	}
+	return count;
+}
+
+}
+
+TEST(ProfilerTest, CapturesZonesOfAllThreads)
+{
+	Profiler::startCapture(0);
+	EXPECT_TRUE(Profiler::isCapturing());
+	{
+		Profiler::Zone outer("TestOuter");
+		Profiler::Zone inner("TestInner");
+	}
+	std::thread worker([]
+	{
+		Profiler::Zone zone("TestWorker");
+	});
+	worker.join();
+	Profiler::frameMark();
+	{
+		Profiler::Zone zone("TestAfterFrame");
+	}
+
+	// zones finished before stop are included even without frame mark
+	const std::string trace = captureTrace();
+	EXPECT_FALSE(Profiler::isCapturing());
+	EXPECT_EQ(countOf(trace, "\"name\":\"TestOuter\""), 1u);
+	EXPECT_EQ(countOf(trace, "\"name\":\"TestInner\""), 1u);
+	EXPECT_EQ(countOf(trace, "\"name\":\"TestWorker\""), 1u);
+	EXPECT_EQ(countOf(trace, "\"name\":\"TestAfterFrame\""), 1u);
+	EXPECT_EQ(countOf(trace, "\"ph\":\"X\""), 4u);
+	EXPECT_EQ(trace.substr(0, 1), "{");
+	EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+}
+
+TEST(ProfilerTest, IgnoresZonesWhenInactive)
+{
+	ASSERT_FALSE(Profiler::isCapturing());
+	ASSERT_FALSE(Profiler::isOverlay());
+	{
+		Profiler::Zone zone("TestInactive");
+	}
+
+	Profiler::startCapture(0);
+	{
+		Profiler::Zone zone("TestActive");
+	}
+	const std::string trace = captureTrace();
+	EXPECT_EQ(countOf(trace, "TestInactive"), 0u);
+	EXPECT_EQ(countOf(trace, "\"name\":\"TestActive\""), 1u);
+	EXPECT_EQ(countOf(trace, "\"ph\":\"X\""), 1u);
+}
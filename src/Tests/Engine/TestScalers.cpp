@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <random>
+#include <vector>
+#include "../../Engine/Scalers/hqx.h"
+#include "../../Engine/Scalers/scalebit.h"
+#include "../../Engine/Scalers/xbrz.h"
+
+namespace
+{
+
+const int Width = 41, Height = 37;
+
+/// Bands with different heights, including one row band next to image border.
+const int Bands[] = { 0, 1, 6, 7, 20, 36, Height };
+
+using FullFunc = std::function<void(const uint32_t* src, uint32_t* dest)>;
+using SliceFunc = std::function<void(const uint32_t* src, uint32_t* dest, int yFirst, int yLast)>;
+
+/// Image made from few colors, so scalers find many edges and patterns.
+std::vector<uint32_t> makeImage()
+{
+	const uint32_t colors[] = { 0x000000, 0xFFFFFF, 0x20A040, 0x2030C0, 0x22A244 };
+	std::mt19937 rng(7);
+	std::vector<uint32_t> image(Width * Height);
+	for (auto& p : image)
+	{
+		p = colors[rng() % std::size(colors)];
+	}
+	return image;
+}
+
+/// Scales whole image by full frame function and by bands, both results need be same.
+void expectSameBanded(int factor, const FullFunc& full, const SliceFunc& slice)
+{
+	const auto src = makeImage();
+	std::vector<uint32_t> fullOutput(Width * Height * factor * factor, 0xDEADBEEF);
+	std::vector<uint32_t> bandedOutput(Width * Height * factor * factor, 0xDEADBEEF);
+
+	full(src.data(), fullOutput.data());
+	// backward order, band can't depend on output of previous ones
+	for (int i = (int)std::size(Bands) - 1; i > 0; --i)
+	{
+		slice(src.data(), bandedOutput.data(), Bands[i - 1], Bands[i]);
+	}
+	EXPECT_EQ(fullOutput, bandedOutput) << "factor " << factor;
+}
+
+}
+
+TEST(ScalersTest, HqxBandedMatchFullFrame)
+{
+	hqxInit();
+	const uint32_t pitch = Width * 4;
+	expectSameBanded(2,
+		[&](const uint32_t* src, uint32_t* dest) { hq2x_32_rb(src, pitch, dest, pitch * 2, Width, Height); },
+		[&](const uint32_t* src, uint32_t* dest, int yFirst, int yLast) { hq2x_32_rb_slice(src, pitch, dest, pitch * 2, Width, Height, yFirst, yLast); });
+	expectSameBanded(3,
+		[&](const uint32_t* src, uint32_t* dest) { hq3x_32_rb(src, pitch, dest, pitch * 3, Width, Height); },
+		[&](const uint32_t* src, uint32_t* dest, int yFirst, int yLast) { hq3x_32_rb_slice(src, pitch, dest, pitch * 3, Width, Height, yFirst, yLast); });
+	expectSameBanded(4,
+		[&](const uint32_t* src, uint32_t* dest) { hq4x_32_rb(src, pitch, dest, pitch * 4, Width, Height); },
+		[&](const uint32_t* src, uint32_t* dest, int yFirst, int yLast) { hq4x_32_rb_slice(src, pitch, dest, pitch * 4, Width, Height, yFirst, yLast); });
+}
+
+TEST(ScalersTest, ScaleBitBandedMatchFullFrame)
+{
+	const unsigned pitch = Width * 4;
+	for (unsigned factor = 2; factor <= 4; ++factor)
+	{
+		ASSERT_EQ(scale_precondition(factor, 4, Width, Height), 0);
+		expectSameBanded(factor,
+			[&](const uint32_t* src, uint32_t* dest) { scale(factor, dest, pitch * factor, src, pitch, 4, Width, Height); },
+			[&](const uint32_t* src, uint32_t* dest, int yFirst, int yLast) { scale_slice(factor, dest, pitch * factor, src, pitch, 4, Width, Height, yFirst, yLast); });
+	}
+}
+
+TEST(ScalersTest, XbrzBandedMatchFullFrame)
+{
+	for (size_t factor = 2; factor <= 4; ++factor)
+	{
+		expectSameBanded(factor,
+			[&](const uint32_t* src, uint32_t* dest) { xbrz::scale(factor, src, dest, Width, Height, xbrz::RGB); },
+			[&](const uint32_t* src, uint32_t* dest, int yFirst, int yLast) { xbrz::scale(factor, src, dest, Width, Height, xbrz::RGB, xbrz::ScalerCfg(), yFirst, yLast); });
+	}
+}
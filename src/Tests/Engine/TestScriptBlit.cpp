@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include "../../Engine/Script.h"
+#include "../../Engine/Surface.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+struct TestBlitParser : ScriptParser<ScriptWorkerBlit::Output, int>
+{
+	TestBlitParser(ScriptGlobal* shared) : ScriptParser(shared, "test", "new_pixel", "old_pixel", "shade")
+	{
+	}
+};
+
+const int Width = 24, Height = 20;
+
+/// Fill surface with few colors, so same pairs of pixels repeat many times.
+void fillSurface(Surface& surface, std::mt19937& rng, bool withHoles)
+{
+	for (int y = 0; y < Height; ++y)
+	{
+		for (int x = 0; x < Width; ++x)
+		{
+			Uint8 color = (Uint8)(16 * (rng() % 6) + rng() % 3);
+			if (withHoles && rng() % 4 == 0)
+			{
+				color = 0;
+			}
+			surface.setPixel(x, y, color);
+		}
+	}
+}
+
+}
+
+TEST(ScriptBlitTest, CachedResultsMatchUncached)
+{
+	ScriptGlobal global;
+	TestBlitParser parser(&global);
+	TestBlitParser::Container script;
+	script.load("test", "var int c; set c new_pixel; div c 16; if eq c 2; add new_pixel shade; return new_pixel; end; if lt old_pixel 32; return 0; end; add new_pixel old_pixel; return new_pixel;", parser);
+	ASSERT_TRUE(script);
+	ASSERT_TRUE(script.isPure());
+
+	std::mt19937 rng(42);
+	Surface src(Width, Height);
+	Surface background(Width, Height);
+	fillSurface(src, rng, true);
+	fillSurface(background, rng, false);
+
+	const int shade = 3;
+	Surface dest(Width, Height);
+	dest.copy(&background);
+	ScriptWorkerBlit blit;
+	blit.update(script, shade);
+	blit.executeBlit(&src, &dest, 0, 0, shade);
+
+	// every pixel run separately, without any reuse of results
+	TestBlitParser::Worker worker{ shade };
+	for (int y = 0; y < Height; ++y)
+	{
+		for (int x = 0; x < Width; ++x)
+		{
+			const Uint8 srcPixel = src.getPixel(x, y);
+			const Uint8 destPixel = background.getPixel(x, y);
+			Uint8 expected = destPixel;
+			if (srcPixel)
+			{
+				TestBlitParser::Output output{ srcPixel, destPixel };
+				worker.execute(script, output);
+				expected = output.getFirst() ? (Uint8)output.getFirst() : destPixel;
+			}
+			EXPECT_EQ(dest.getPixel(x, y), expected) << "x " << x << " y " << y;
+		}
+	}
+}
+
+TEST(ScriptBlitTest, DebugOperationsAreImpure)
+{
+	ScriptGlobal global;
+	TestBlitParser parser(&global);
+
+	TestBlitParser::Container pure;
+	pure.load("test", "add new_pixel shade; return new_pixel;", parser);
+	ASSERT_TRUE(pure);
+	EXPECT_TRUE(pure.isPure());
+
+	TestBlitParser::Container debug;
+	debug.load("test", "debug_impl new_pixel; return new_pixel;", parser);
+	ASSERT_TRUE(debug);
+	EXPECT_FALSE(debug.isPure());
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "../../Engine/Script.h"
+#include "../../Engine/Options.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+struct TestScriptParser : ScriptParser<ScriptOutputArgs<int&>, int>
+{
+	TestScriptParser(ScriptGlobal* shared) : ScriptParser(shared, "test", "result", "input")
+	{
+	}
+};
+
+int runScript(const std::string& code, int input, bool optimize)
+{
+	const bool old = Options::oxceScriptOptimizer;
+	Options::oxceScriptOptimizer = optimize;
+
+	ScriptGlobal global;
+	TestScriptParser parser(&global);
+	TestScriptParser::Container script;
+	script.load("test", code, parser);
+
+	Options::oxceScriptOptimizer = old;
+
+	TestScriptParser::Output output{ -1 };
+	TestScriptParser::Worker worker{ input };
+	worker.execute(script, output);
+	return output.getFirst();
+}
+
+void expectSameResults(const std::string& code)
+{
+	for (int input = -5; input <= 20; ++input)
+	{
+		EXPECT_EQ(runScript(code, input, true), runScript(code, input, false)) << code << " input: " << input;
+	}
+}
+
+}
+
+TEST(ScriptOptimizerTest, ArithmeticOnSameRegister)
+{
+	EXPECT_EQ(runScript("var int x; set x input; add x 5; mul x 3; add x input; return x;", 2, true), 23);
+
+	expectSameResults("var int x; set x input; add x 5; mul x 3; add x input; return x;");
+	expectSameResults("var int x; set x 4; add x 5; sub x 2; mul x input; add x 0; mul x 1; return x;");
+	expectSameResults("var int x; var int y 7; set x y; sub x input; set y x; mul y input; add y 3; return y;");
+	expectSameResults("var int x; set x input; add x x; set x x; return x;");
+}
+
+TEST(ScriptOptimizerTest, ConstantConditions)
+{
+	expectSameResults("var int x 3; if lt 1 2; set x 10; else; set x 20; end; add x input; return x;");
+	expectSameResults("var int x 3; if eq 1 2; set x 10; else; set x 20; end; add x input; return x;");
+	expectSameResults("if ge input input; return 1; end; return 2;");
+	expectSameResults("var int x; if gt input 4; if lt input 10; set x 1; else; set x 2; end; end; return x;");
+}
+
+TEST(ScriptOptimizerTest, Loops)
+{
+	expectSameResults(
+		"var int sum 0;"
+		"loop var i input;"
+		"  if eq i 3; continue; end;"
+		"  if gt i 12; break; end;"
+		"  set sum sum; mul sum 2; add sum i;"
+		"end;"
+		"return sum;"
+	);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include "../../Engine/SurfaceSpans.h"
+#include "../../Engine/ShaderDraw.h"
+#include "../../Engine/ShaderMove.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/// Sprite with transparent border and random holes, similar to terrain frames.
+std::vector<Uint8> makeSprite(int width, int height, std::mt19937& rng)
+{
+	std::vector<Uint8> sprite(width * height, 0);
+	for (int y = 2; y < height - 2; ++y)
+	{
+		for (int x = 3; x < width - 3; ++x)
+		{
+			sprite[y * width + x] = (rng() % 3) ? (Uint8)(rng() % 256) : 0;
+		}
+	}
+	return sprite;
+}
+
+}
+
+TEST(SurfaceSpansTest, CountsOpaquePixels)
+{
+	std::vector<Uint8> sprite = {
+		0, 1, 2, 0, 0, 3,
+		0, 0, 0, 0, 0, 0,
+		4, 5, 6, 7, 8, 9,
+	};
+	SurfaceSpans spans(SurfaceRaw<const Uint8>(sprite, 6, 3));
+	EXPECT_EQ(spans.getHeight(), 3);
+	EXPECT_EQ(spans.getOpaquePixels(), 9u);
+	EXPECT_EQ(spans.rowEnd(0) - spans.rowBegin(0), 2);
+	EXPECT_EQ(spans.rowEnd(1) - spans.rowBegin(1), 0);
+	EXPECT_EQ(spans.rowEnd(2) - spans.rowBegin(2), 1);
+	EXPECT_EQ(spans.rowBegin(2)->length, 6);
+}
+
+TEST(SurfaceSpansTest, MatchesShaderDraw)
+{
+	const int width = 32, height = 40;
+	const int destWidth = 50, destHeight = 45;
+	std::mt19937 rng(1234);
+	std::vector<Uint8> sprite = makeSprite(width, height, rng);
+	SurfaceRaw<const Uint8> src(sprite, width, height);
+	SurfaceSpans spans(src);
+
+	std::vector<Uint8> background(destWidth * destHeight);
+	for (auto& p : background)
+	{
+		p = (Uint8)(rng() % 256);
+	}
+
+	const GraphSubset areas[] = {
+		GraphSubset{ destWidth, destHeight },
+		GraphSubset{ std::make_pair(10, 30), std::make_pair(5, 20) },
+	};
+	for (int shade : { 0, 5, 15 })
+	{
+		for (int x = -35; x <= destWidth; x += 7)
+		{
+			for (int y = -42; y <= destHeight; y += 9)
+			{
+				for (const GraphSubset& area : areas)
+				{
+					std::vector<Uint8> expected = background;
+					std::vector<Uint8> actual = background;
+
+					ShaderMove<Uint8> dest(SurfaceRaw<Uint8>(expected, destWidth, destHeight));
+					dest.setDomain(area);
+					ShaderDraw<helper::StandardShade>(dest, ShaderMove<const Uint8>(src, x, y), ShaderScalar(shade));
+
+					spans.draw(SurfaceRaw<Uint8>(actual, destWidth, destHeight), src, x, y, area,
+						[&](Uint8& d, const Uint8& s){ helper::StandardShade::func(d, s, shade); });
+
+					ASSERT_EQ(actual, expected) << shade << " " << x << " " << y;
+				}
+			}
+		}
+	}
+}
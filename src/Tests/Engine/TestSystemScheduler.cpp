@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include "../../Engine/Timer.h"
+#include "../../Entity/Engine/Drawable.h"
+#include "../../Entity/Engine/SystemScheduler.h"
+#include "../../Entity/Engine/Tickable.h"
+#include "../../Entity/Interface/Window.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace OpenXcom;
+
+namespace
+{
+
+struct Position { int x; };
+struct Velocity { int dx; };
+
+std::mutex logMutex;
+std::vector<std::string> updateLog;
+
+void logUpdate(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(logMutex);
+	updateLog.push_back(name);
+}
+
+struct MoveSystem
+{
+	using Reads = SystemAccess<Velocity>;
+	using Writes = SystemAccess<Position>;
+	void update() { logUpdate("move"); }
+};
+
+struct AccelerateSystem
+{
+	using Writes = SystemAccess<Velocity>;
+	void update() { logUpdate("accelerate"); }
+};
+
+struct ClockSystem
+{
+	using Writes = SystemAccess<>;
+	void update() { logUpdate("clock"); }
+};
+
+struct RenderSystem
+{
+	using Reads = SystemAccess<Position, ClockSystem>;
+	void update() { logUpdate("render"); }
+};
+
+struct LegacySystem
+{
+	void update() { logUpdate("legacy"); }
+};
+
+struct NoUpdateSystem
+{
+};
+
+}
+
+TEST(SystemSchedulerTest, BuildsStages)
+{
+	TypeErasedUpdatePtr move(new MoveSystem), accelerate(new AccelerateSystem), clock(new ClockSystem), render(new RenderSystem), legacy(new LegacySystem), none(new NoUpdateSystem);
+
+	SystemScheduler scheduler;
+	scheduler.add<MoveSystem>(move);
+	scheduler.add<ClockSystem>(clock);
+	scheduler.add<AccelerateSystem>(accelerate);
+	scheduler.add<RenderSystem>(render);
+	scheduler.add<NoUpdateSystem>(none);
+	scheduler.add<LegacySystem>(legacy);
+
+	// move + clock, then accelerate (writes what move reads) + render (reads what move and clock write), then legacy alone
+	const auto& stages = scheduler.getStages();
+	ASSERT_EQ(stages.size(), 3u);
+	EXPECT_EQ(stages[0], std::vector<size_t>({ 0, 1 }));
+	EXPECT_EQ(stages[1], std::vector<size_t>({ 2, 3 }));
+	EXPECT_EQ(stages[2], std::vector<size_t>({ 4 }));
+
+	updateLog.clear();
+	scheduler.update();
+	ASSERT_EQ(updateLog.size(), 5u);
+	EXPECT_EQ(updateLog[4], "legacy");
+	auto pos = [](const std::string& name) { return std::find(updateLog.begin(), updateLog.end(), name) - updateLog.begin(); };
+	EXPECT_LT(pos("move"), pos("accelerate"));
+	EXPECT_LT(pos("move"), pos("render"));
+	EXPECT_LT(pos("clock"), pos("render"));
+}
+
+TEST(SystemSchedulerTest, EngineSystemsShareStages)
+{
+	entt::registry registry;
+	TimeSystem* timeSystem = new TimeSystem;
+	TypeErasedUpdatePtr tickable(new TickableSystem), drawable(new DrawableSystem), time(timeSystem), progress(new ProgressTimerSystem(registry, *timeSystem)), interval(new IntervalTimerSystem);
+
+	// same order as in ECS
+	SystemScheduler scheduler;
+	scheduler.add<TickableSystem>(tickable);
+	scheduler.add<DrawableSystem>(drawable);
+	scheduler.add<TimeSystem>(time);
+	scheduler.add<ProgressTimerSystem>(progress);
+	scheduler.add<IntervalTimerSystem>(interval);
+
+	// systems without update are skipped, progress timers wait for the clock, so no stage needs workers
+	const auto& stages = scheduler.getStages();
+	ASSERT_EQ(stages.size(), 2u);
+	EXPECT_EQ(stages[0], std::vector<size_t>({ 0 }));
+	EXPECT_EQ(stages[1], std::vector<size_t>({ 1 }));
+}
+
+TEST(SystemSchedulerTest, ParallelEachVisitsEveryEntity)
+{
+	entt::registry registry;
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto e = registry.create();
+		registry.emplace<Position>(e, i);
+		if (i % 3 == 0)
+		{
+			registry.emplace<Velocity>(e, 2);
+		}
+	}
+
+	std::atomic<int> visited = 0;
+	parallelEach<Position, Velocity>(registry, [&](entt::entity, Position& p, Velocity& v)
+	{
+		p.x += v.dx;
+		++visited;
+	}, 16);
+
+	EXPECT_EQ(visited, 334);
+	for (auto [e, p] : registry.view<Position>().each())
+	{
+		EXPECT_EQ(p.x, (int)e + ((int)e % 3 == 0 ? 2 : 0));
+	}
+}
+
+TEST(SystemSchedulerTest, SystemNamesAreReadable)
+{
+	EXPECT_STREQ(getSystemName<TimeSystem>(), "TimeSystem");
+	EXPECT_STREQ(getSystemName<ProgressTimerSystem>(), "ProgressTimerSystem");
+	EXPECT_EQ(getSystemName<TimeSystem>(), getSystemName<TimeSystem>());
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "../../Engine/ThreadPool.h"
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace OpenXcom;
+
+TEST(ThreadPoolTest, CallsEveryIndexOnce)
+{
+	ThreadPool pool(3);
+	EXPECT_EQ(pool.getWorkerCount(), 4u);
+
+	std::vector<int> calls(1000, 0);
+	pool.parallelFor(calls.size(), [&](size_t index, size_t worker)
+	{
+		EXPECT_LT(worker, pool.getWorkerCount());
+		calls[index] += 1;
+	});
+
+	for (int c : calls)
+	{
+		EXPECT_EQ(c, 1);
+	}
+}
+
+TEST(ThreadPoolTest, ManyJobsInRow)
+{
+	ThreadPool pool(2);
+
+	std::atomic<size_t> sum = 0;
+	for (int job = 0; job < 100; ++job)
+	{
+		pool.parallelFor(10, [&](size_t index, size_t worker) { sum += index; });
+	}
+	EXPECT_EQ(sum, 100u * 45u);
+}
+
+TEST(ThreadPoolTest, WithoutThreads)
+{
+	ThreadPool pool(0);
+	EXPECT_EQ(pool.getWorkerCount(), 1u);
+
+	size_t sum = 0;
+	pool.parallelFor(10, [&](size_t index, size_t worker)
+	{
+		EXPECT_EQ(worker, 0u);
+		sum += index;
+	});
+	EXPECT_EQ(sum, 45u);
+}
+
+TEST(ThreadPoolTest, NestedCallRunsSerially)
+{
+	ThreadPool pool(2);
+
+	std::atomic<size_t> sum = 0;
+	pool.parallelFor(4, [&](size_t index, size_t worker)
+	{
+		pool.parallelFor(4, [&](size_t innerIndex, size_t innerWorker) { sum += innerIndex; });
+	});
+	EXPECT_EQ(sum, 4u * 6u);
+}
+
+TEST(ThreadPoolTest, ExceptionIsRethrown)
+{
+	ThreadPool pool(2);
+
+	EXPECT_THROW(
+		pool.parallelFor(100, [&](size_t index, size_t worker)
+		{
+			if (index == 42)
+			{
+				throw std::runtime_error("test");
+			}
+		}),
+		std::runtime_error);
+
+	// pool is still usable
+	std::atomic<size_t> count = 0;
+	pool.parallelFor(10, [&](size_t index, size_t worker) { ++count; });
+	EXPECT_EQ(count, 10u);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "../../Geoscape/GeoIndex.h"
+#include "../../fmath.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/// Same distance as `Target::getDistance`.
+double distance(double lon1, double lat1, double lon2, double lat2)
+{
+	return acos(std::clamp(cos(lat1) * cos(lat2) * cos(lon2 - lon1) + sin(lat1) * sin(lat2), -1.0, 1.0));
+}
+
+}
+
+TEST(GeoIndexTest, EmptyIndex)
+{
+	GeoIndex index;
+	std::vector<int> result = { 1, 2 };
+	index.query(0.5, 0.5, 1.0, result);
+	EXPECT_TRUE(result.empty());
+}
+
+TEST(GeoIndexTest, FindsNearPoints)
+{
+	GeoIndex index;
+	index.insert(0, Deg2Rad(10), Deg2Rad(10));
+	index.insert(1, Deg2Rad(200), Deg2Rad(-40));
+	index.insert(2, Deg2Rad(359), Deg2Rad(0));
+
+	std::vector<int> result;
+	index.query(Deg2Rad(12), Deg2Rad(9), Deg2Rad(5), result);
+	EXPECT_EQ(result, std::vector<int>({ 0 }));
+	// crossing 0 longitude
+	index.query(Deg2Rad(1), Deg2Rad(0), Deg2Rad(3), result);
+	EXPECT_EQ(result, std::vector<int>({ 2 }));
+	index.query(Deg2Rad(100), Deg2Rad(0), Deg2Rad(2), result);
+	EXPECT_TRUE(result.empty());
+
+	index.clear();
+	EXPECT_EQ(index.size(), 0u);
+	index.query(Deg2Rad(12), Deg2Rad(9), Deg2Rad(5), result);
+	EXPECT_TRUE(result.empty());
+}
+
+TEST(GeoIndexTest, SameAsLinearSearch)
+{
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<double> lonDist(-M_PI, 3 * M_PI), latDist(-M_PI_2, M_PI_2), radiusDist(0, 0.8);
+
+	std::vector<std::pair<double, double>> points;
+	GeoIndex index;
+	for (int i = 0; i < 500; ++i)
+	{
+		points.push_back({ lonDist(rng), latDist(rng) });
+		index.insert(i, points.back().first, points.back().second);
+	}
+	// near poles
+	points.push_back({ 1.0, M_PI_2 });
+	index.insert(500, 1.0, M_PI_2);
+	points.push_back({ 4.0, -M_PI_2 + 0.01 });
+	index.insert(501, 4.0, -M_PI_2 + 0.01);
+
+	std::vector<int> result;
+	for (int i = 0; i < 5000; ++i)
+	{
+		double lon = lonDist(rng), lat = latDist(rng), radius = radiusDist(rng);
+		index.query(lon, lat, radius, result);
+		ASSERT_TRUE(std::is_sorted(result.begin(), result.end()));
+		size_t found = 0;
+		for (int id = 0; id < (int)points.size(); ++id)
+		{
+			bool inside = distance(lon, lat, points[id].first, points[id].second) <= radius;
+			bool listed = std::binary_search(result.begin(), result.end(), id);
+			ASSERT_TRUE(!inside || listed) << "lon " << lon << " lat " << lat << " radius " << radius << " id " << id;
+			found += listed;
+		}
+		EXPECT_EQ(found, result.size());
+	}
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+#include "../../Geoscape/GeoscapeState.h"
+#include "../../Mod/RuleCraft.h"
+#include "../../Mod/RuleUfo.h"
+#include "../../Savegame/Craft.h"
+#include "../../Savegame/GameTime.h"
+#include "../../Savegame/Ufo.h"
+#include "../../Savegame/Waypoint.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/**
+ * Clock, UFOs and crafts of quiet geoscape, the only state that 5 second steps change there.
+ */
+struct IdleGeoscape
+{
+	GameTime time = GameTime(1, 1, 1, 1999, 12, 3, 25);
+	std::vector<std::unique_ptr<Ufo>> storage;
+	// crafts must go before UFOs they follow
+	std::vector<std::unique_ptr<Craft>> craftStorage;
+	std::vector<Ufo*> ufos;
+	std::vector<Craft*> crafts;
+
+	void addUfo(const RuleUfo& rule, Ufo::UfoStatus status, size_t seconds)
+	{
+		storage.push_back(std::make_unique<Ufo>(rule, (int)storage.size() + 1));
+		Ufo* ufo = storage.back().get();
+		ufo->setStatus(status);
+		ufo->setSecondsRemaining(seconds);
+		ufo->setDetected(true);
+		ufos.push_back(ufo);
+	}
+
+	void addFlyingUfo(const RuleUfo& rule, double lon, int speed)
+	{
+		addUfo(rule, Ufo::FLYING, 0);
+		Ufo* ufo = ufos.back();
+		ufo->setShield(0);
+		ufo->setLongitude(lon);
+		// UFO deletes waypoint it flies to
+		ufo->setDestination(new Waypoint());
+		ufo->setSpeed(speed);
+	}
+
+	void addCraft(const RuleCraft& rule, double lon, Target* destination, int takeoff, int speed)
+	{
+		craftStorage.push_back(std::make_unique<Craft>(&rule, nullptr, (int)craftStorage.size() + 1));
+		Craft* craft = craftStorage.back().get();
+		RuleCraftStats stats;
+		stats.damageMax = 100;
+		craft->addCraftStats(stats);
+		craft->setDamage(0);
+		craft->setLongitude(lon);
+		craft->setDestination(destination);
+		craft->setTakeoff(takeoff);
+		craft->setSpeed(speed);
+		crafts.push_back(craft);
+	}
+
+	/// Same changes as `GeoscapeState::time5Seconds()` do when nothing arrives.
+	void step()
+	{
+		EXPECT_EQ(time.advance(), TIME_5SEC);
+		for (Ufo* ufo : ufos)
+		{
+			ufo->think();
+			if (ufo->getStatus() == Ufo::FLYING)
+			{
+				EXPECT_FALSE(ufo->reachedDestination());
+			}
+			else
+			{
+				EXPECT_GT(ufo->getSecondsRemaining(), 0u);
+			}
+		}
+		for (Craft* craft : crafts)
+		{
+			EXPECT_FALSE(craft->think());
+			EXPECT_FALSE(craft->reachedDestination());
+		}
+	}
+
+	int count(int limit)
+	{
+		return GeoscapeState::countQuietSteps(time, ufos, crafts, limit);
+	}
+
+	int skip(int steps)
+	{
+		return GeoscapeState::skipQuietSteps(time, ufos, crafts, steps);
+	}
+};
+
+struct GeoscapeQuietStepsTest : public ::testing::Test
+{
+	RuleUfo rule = RuleUfo("STR_TEST_UFO");
+	RuleCraft craftRule = RuleCraft("STR_TEST_CRAFT", 0);
+	IdleGeoscape skipped, stepped;
+
+	void addUfo(Ufo::UfoStatus status, size_t seconds)
+	{
+		skipped.addUfo(rule, status, seconds);
+		stepped.addUfo(rule, status, seconds);
+	}
+
+	void addFlyingUfo(double lon, int speed)
+	{
+		skipped.addFlyingUfo(rule, lon, speed);
+		stepped.addFlyingUfo(rule, lon, speed);
+	}
+
+	/// Craft chasing UFO with given index.
+	void addCraft(double lon, size_t ufo, int takeoff, int speed)
+	{
+		skipped.addCraft(craftRule, lon, skipped.ufos[ufo], takeoff, speed);
+		stepped.addCraft(craftRule, lon, stepped.ufos[ufo], takeoff, speed);
+	}
+
+	void expectSame()
+	{
+		EXPECT_EQ(skipped.time.getSecond(), stepped.time.getSecond());
+		EXPECT_EQ(skipped.time.getMinute(), stepped.time.getMinute());
+		EXPECT_EQ(skipped.time.getHour(), stepped.time.getHour());
+		EXPECT_EQ(skipped.time.getDay(), stepped.time.getDay());
+		for (size_t i = 0; i < skipped.ufos.size(); ++i)
+		{
+			EXPECT_EQ(skipped.ufos[i]->getStatus(), stepped.ufos[i]->getStatus());
+			EXPECT_EQ(skipped.ufos[i]->getSecondsRemaining(), stepped.ufos[i]->getSecondsRemaining());
+			EXPECT_EQ(skipped.ufos[i]->getDetected(), stepped.ufos[i]->getDetected());
+			EXPECT_EQ(skipped.ufos[i]->getLongitude(), stepped.ufos[i]->getLongitude());
+			EXPECT_EQ(skipped.ufos[i]->getLatitude(), stepped.ufos[i]->getLatitude());
+		}
+		for (size_t i = 0; i < skipped.crafts.size(); ++i)
+		{
+			EXPECT_EQ(skipped.crafts[i]->getTakeoff(), stepped.crafts[i]->getTakeoff());
+			EXPECT_EQ(skipped.crafts[i]->getLongitude(), stepped.crafts[i]->getLongitude());
+			EXPECT_EQ(skipped.crafts[i]->getLatitude(), stepped.crafts[i]->getLatitude());
+		}
+	}
+};
+
+}
+
+TEST_F(GeoscapeQuietStepsTest, SkipStopsBeforeTenMinutes)
+{
+	const int steps = skipped.count(1000);
+	// 12:03:25, last quiet step ends at 12:09:55
+	EXPECT_EQ(steps, 78);
+
+	EXPECT_EQ(skipped.skip(steps), steps);
+	for (int i = 0; i < steps; ++i)
+	{
+		stepped.step();
+	}
+	expectSame();
+	EXPECT_EQ(skipped.count(1000), 0);
+	EXPECT_EQ(stepped.time.advance(), TIME_10MIN);
+}
+
+TEST_F(GeoscapeQuietStepsTest, SkipMatchesSteppingWithLandedUfos)
+{
+	addUfo(Ufo::LANDED, 300);
+	addUfo(Ufo::LANDED, 1200);
+	addUfo(Ufo::CRASHED, 3000);
+
+	const int steps = skipped.count(1000);
+	// step that lifts first UFO is not quiet
+	EXPECT_EQ(steps, 59);
+
+	EXPECT_EQ(skipped.skip(steps), steps);
+	for (int i = 0; i < steps; ++i)
+	{
+		stepped.step();
+	}
+	expectSame();
+	EXPECT_EQ(skipped.ufos[0]->getSecondsRemaining(), 5u);
+	EXPECT_EQ(skipped.count(1000), 0);
+}
+
+TEST_F(GeoscapeQuietStepsTest, LimitAndUnsteadyShield)
+{
+	addUfo(Ufo::LANDED, 1200);
+	EXPECT_EQ(skipped.count(10), 10);
+
+	// first step initializes shield of new UFO
+	addUfo(Ufo::FLYING, 0);
+	EXPECT_EQ(skipped.ufos.back()->getShield(), -1);
+	EXPECT_EQ(skipped.count(10), 0);
+}
+
+TEST_F(GeoscapeQuietStepsTest, FlyingStopsBeforeArrival)
+{
+	// UFO flies to waypoint 0.02 radian away, 4e-4 radian per step, with craft taking off behind it
+	addFlyingUfo(0.02, 1000);
+	addCraft(0.04, 0, 10, 2000);
+
+	const int steps = skipped.count(1000);
+	EXPECT_GT(steps, 0);
+	EXPECT_LT(steps, 78);
+
+	EXPECT_EQ(skipped.skip(steps), steps);
+	for (int i = 0; i < steps; ++i)
+	{
+		stepped.step();
+	}
+	expectSame();
+	EXPECT_EQ(skipped.crafts[0]->getTakeoff(), 0);
+	EXPECT_LT(skipped.crafts[0]->getLongitude(), 0.04);
+
+	// craft estimate was pessimistic, skipping continues until UFO gets close to waypoint
+	const int more = skipped.skip(1000);
+	EXPECT_GT(more, 0);
+	EXPECT_LT(more, 1000);
+	for (int i = 0; i < more; ++i)
+	{
+		stepped.step();
+	}
+	expectSame();
+	EXPECT_EQ(skipped.count(1000), 0);
+}
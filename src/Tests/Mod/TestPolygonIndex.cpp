@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include "../../Mod/PolygonIndex.h"
+#include "../../Mod/Polygon.h"
+#include "../../fmath.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/// Linear search that globe used before index.
+Polygon* linearFind(const std::list<Polygon*>& polygons, double lon, double lat)
+{
+	const double zDiscard = 0.75f;
+	double coslat = cos(lat);
+	double sinlat = sin(lat);
+
+	for (auto* polygon : polygons)
+	{
+		double x, y, z, x2, y2;
+		double clat, clon;
+		z = 0;
+		for (int j = 0; j < polygon->getPoints(); ++j)
+		{
+			z = coslat * cos(polygon->getLatitude(j)) * cos(polygon->getLongitude(j) - lon) + sinlat * sin(polygon->getLatitude(j));
+			if (z < zDiscard) break;
+		}
+		if (z < zDiscard) continue;
+
+		bool odd = false;
+		clat = polygon->getLatitude(0);
+		clon = polygon->getLongitude(0);
+		x = cos(clat) * sin(clon - lon);
+		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+		for (int j = 0; j < polygon->getPoints(); ++j)
+		{
+			int k = (j + 1) % polygon->getPoints();
+			clat = polygon->getLatitude(k);
+			clon = polygon->getLongitude(k);
+			x2 = cos(clat) * sin(clon - lon);
+			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+			if (((y > 0) != (y2 > 0)) && (0 < (x2 - x) * (0 - y) / (y2 - y) + x))
+				odd = !odd;
+			x = x2;
+			y = y2;
+		}
+		if (odd) return polygon;
+	}
+	return nullptr;
+}
+
+struct PolygonIndexTest : public ::testing::Test
+{
+	std::list<Polygon*> polygons;
+	PolygonIndex index;
+
+	void add(std::initializer_list<double> lonLatDeg, int texture)
+	{
+		auto* polygon = new Polygon((int)lonLatDeg.size() / 2);
+		int i = 0;
+		for (auto it = lonLatDeg.begin(); it != lonLatDeg.end(); it += 2, ++i)
+		{
+			polygon->setLongitude(i, Deg2Rad(*it));
+			polygon->setLatitude(i, Deg2Rad(*(it + 1)));
+		}
+		polygon->setTexture(texture);
+		polygons.push_back(polygon);
+	}
+
+	void TearDown() override
+	{
+		for (auto* polygon : polygons)
+		{
+			delete polygon;
+		}
+	}
+};
+
+}
+
+TEST_F(PolygonIndexTest, EmptyIndex)
+{
+	EXPECT_EQ(index.find(0.5, 0.5), nullptr);
+	index.build(polygons);
+	EXPECT_EQ(index.find(0.5, 0.5), nullptr);
+}
+
+TEST_F(PolygonIndexTest, FindsPolygon)
+{
+	add({ 10, 10, 20, 10, 20, 20, 10, 20 }, 1);
+	add({ 100, -40, 110, -40, 105, -30 }, 2);
+	index.build(polygons);
+
+	Polygon* p = index.find(Deg2Rad(15), Deg2Rad(15));
+	ASSERT_NE(p, nullptr);
+	EXPECT_EQ(p->getTexture(), 1);
+	p = index.find(Deg2Rad(105), Deg2Rad(-35));
+	ASSERT_NE(p, nullptr);
+	EXPECT_EQ(p->getTexture(), 2);
+	EXPECT_EQ(index.find(Deg2Rad(50), Deg2Rad(0)), nullptr);
+	EXPECT_EQ(index.getCandidates(Deg2Rad(200), Deg2Rad(0)), 0u);
+}
+
+TEST_F(PolygonIndexTest, SameAsLinearSearch)
+{
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<double> lonDist(0, 360), latDist(-89, 89), sizeDist(1, 12);
+
+	// polygon around pole is first, so it wins over random ones overlapping it
+	add({ 0, 85, 120, 85, 240, 85 }, 1000);
+	// random quads, also crossing 0 longitude and near poles, some overlapping
+	for (int i = 0; i < 300; ++i)
+	{
+		double lon = lonDist(rng), lat = latDist(rng), w = sizeDist(rng), h = sizeDist(rng);
+		add({ lon, lat, lon + w, lat, lon + w, std::min(lat + h, 90.0), lon, std::min(lat + h, 90.0) }, i);
+	}
+	index.build(polygons);
+
+	int hits = 0;
+	for (int i = 0; i < 20000; ++i)
+	{
+		double lon = Deg2Rad(lonDist(rng)), lat = Deg2Rad(latDist(rng));
+		Polygon* found = index.find(lon, lat);
+		ASSERT_EQ(found, linearFind(polygons, lon, lat)) << "lon " << lon << " lat " << lat;
+		hits += found != nullptr;
+	}
+	EXPECT_GT(hits, 1000);
+	Polygon* pole = index.find(0.3, Deg2Rad(89.5));
+	ASSERT_NE(pole, nullptr);
+	EXPECT_EQ(pole->getTexture(), 1000);
+}
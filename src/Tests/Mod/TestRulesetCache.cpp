@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include "../../Mod/RulesetCache.h"
+#include "../TestYamlHelpers.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+struct RulesetCacheTest : public ::testing::Test
+{
+	std::string path = "test_rulesets.cache";
+
+	void TearDown() override
+	{
+		std::remove(path.c_str());
+	}
+
+	std::vector<YAML::Node> docs()
+	{
+		return {
+			YAML::Load("items:\n  - type: STR_A\n    power: 50\n    tags: [1, 2, 3]\n  - type: STR_B\n    name: \"quoted\"\nunits: !add\n  - a\n  - ~\n"),
+			YAML::Load(""),
+			YAML::Load("extended:\n  tags:\n    RuleItem:\n      ITEM_TAG: int\nempty: {}\n"),
+		};
+	}
+};
+
+}
+
+TEST_F(RulesetCacheTest, RoundTrip)
+{
+	RulesetCache cache;
+	cache.record(42);
+	for (auto& doc : docs())
+	{
+		cache.add(doc);
+	}
+	ASSERT_TRUE(cache.save(path));
+
+	RulesetCache loaded;
+	ASSERT_TRUE(loaded.load(path, 42, 3));
+	EXPECT_TRUE(loaded.isLoaded());
+	EXPECT_FALSE(loaded.isRecording());
+	ASSERT_EQ(loaded.size(), 3u);
+
+	auto original = docs();
+	for (size_t i = 0; i < original.size(); ++i)
+	{
+		EXPECT_TRUE(sameTree(loaded.get(i), original[i])) << "document " << i;
+	}
+
+	YAML::Node first = loaded.get(0);
+	EXPECT_EQ(first["items"][0]["power"].as<int>(), 50);
+	EXPECT_EQ(first["items"][1]["name"].as<std::string>(), "quoted");
+	EXPECT_EQ(first["units"].Tag(), "!add");
+	EXPECT_TRUE(first["units"][1].IsNull());
+	EXPECT_EQ(first["items"].Tag(), original[0]["items"].Tag());
+}
+
+TEST_F(RulesetCacheTest, RejectsMismatch)
+{
+	RulesetCache cache;
+	cache.record(42);
+	for (auto& doc : docs())
+	{
+		cache.add(doc);
+	}
+	ASSERT_TRUE(cache.save(path));
+
+	RulesetCache loaded;
+	EXPECT_FALSE(loaded.load(path, 43, 3));
+	EXPECT_FALSE(loaded.load(path, 42, 2));
+	EXPECT_FALSE(loaded.load("missing_rulesets.cache", 42, 3));
+	EXPECT_FALSE(loaded.isLoaded());
+
+	// flip one byte of payload
+	{
+		std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekg(0, std::ios::end);
+		const std::streamoff size = file.tellg();
+		file.seekg(size - 2);
+		char c;
+		file.read(&c, 1);
+		c ^= 0x55;
+		file.seekp(size - 2);
+		file.write(&c, 1);
+	}
+	EXPECT_FALSE(loaded.load(path, 42, 3));
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include "../../Savegame/BinarySave.h"
+#include "../../Engine/Exception.h"
+#include "../TestYamlHelpers.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+struct BinarySaveTest : public ::testing::Test
+{
+	std::string binaryPath = "test_binary.sav";
+	std::string yamlPath = "test_yaml.sav";
+	std::string convertedPath = "test_converted.sav";
+
+	YAML::Node brief = YAML::Load("name: test\nversion: \"8.0\"\nmods: [xcom1]\ntime: {second: 5, day: 1}\n");
+	YAML::Node doc = YAML::Load(
+		"difficulty: 2\n"
+		"funds: [1000000, 1200000]\n"
+		"ids: {STR_UFO: 12, STR_CRAFT: 3}\n"
+		"bases:\n  - name: \"Base One\"\n    lon: 1.5\n    soldiers: !tag\n      - ~\n      - {id: 1, name: \"J. Doe\"}\n"
+		"userNotes: []\n");
+
+	void TearDown() override
+	{
+		std::remove(binaryPath.c_str());
+		std::remove(yamlPath.c_str());
+		std::remove(convertedPath.c_str());
+	}
+};
+
+}
+
+TEST_F(BinarySaveTest, RoundTrip)
+{
+	for (bool compress : { false, true })
+	{
+		BinarySave::save(binaryPath, brief, doc, compress);
+		ASSERT_TRUE(BinarySave::isBinary(binaryPath));
+
+		EXPECT_TRUE(sameTree(BinarySave::loadBrief(binaryPath), brief));
+
+		YAML::Node loadedBrief, loadedDoc;
+		BinarySave::load(binaryPath, loadedBrief, loadedDoc);
+		EXPECT_TRUE(sameTree(loadedBrief, brief));
+		EXPECT_TRUE(sameTree(loadedDoc, doc));
+		EXPECT_EQ(loadedDoc["bases"][0]["soldiers"].Tag(), "!tag");
+		EXPECT_EQ(loadedDoc["funds"][1].as<int>(), 1200000);
+	}
+}
+
+TEST_F(BinarySaveTest, ConvertBothWays)
+{
+	BinarySave::saveYaml(yamlPath, brief, doc);
+	EXPECT_FALSE(BinarySave::isBinary(yamlPath));
+
+	BinarySave::convert(yamlPath, binaryPath, BinarySave::SF_BINARY_COMPRESSED);
+	BinarySave::convert(binaryPath, convertedPath, BinarySave::SF_YAML);
+
+	YAML::Node yamlBrief, yamlDoc, binaryBrief, binaryDoc, convertedBrief, convertedDoc;
+	BinarySave::loadAny(yamlPath, yamlBrief, yamlDoc);
+	BinarySave::loadAny(binaryPath, binaryBrief, binaryDoc);
+	BinarySave::loadAny(convertedPath, convertedBrief, convertedDoc);
+	EXPECT_TRUE(sameTree(binaryBrief, yamlBrief));
+	EXPECT_TRUE(sameTree(binaryDoc, yamlDoc));
+	EXPECT_TRUE(sameTree(convertedBrief, yamlBrief));
+	EXPECT_TRUE(sameTree(convertedDoc, yamlDoc));
+	EXPECT_EQ(convertedDoc["ids"]["STR_UFO"].as<int>(), 12);
+}
+
+TEST_F(BinarySaveTest, RejectsCorruption)
+{
+	BinarySave::save(binaryPath, brief, doc, false);
+	{
+		std::fstream file(binaryPath, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekg(0, std::ios::end);
+		const std::streamoff size = file.tellg();
+		file.seekg(size - 20);
+		char c;
+		file.read(&c, 1);
+		c ^= 0x55;
+		file.seekp(size - 20);
+		file.write(&c, 1);
+	}
+	YAML::Node loadedBrief, loadedDoc;
+	EXPECT_THROW(BinarySave::load(binaryPath, loadedBrief, loadedDoc), Exception);
+}
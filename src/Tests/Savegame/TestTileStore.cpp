@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "../../Savegame/TileStore.h"
+
+using namespace OpenXcom;
+
+namespace
+{
+
+struct TileStoreTest : public ::testing::Test
+{
+	TileStore store;
+
+	void SetUp() override
+	{
+		store.init(100);
+	}
+};
+
+}
+
+TEST_F(TileStoreTest, InitResetsValues)
+{
+	store.setSmoke(3, 5);
+	store.setFire(3, 2);
+	store.setLight(3, LL_UNITS, 9);
+	store.setDiscovered(3, O_FLOOR, true);
+	store.setUnit(3, reinterpret_cast<BattleUnit*>(&store));
+
+	store.init(50);
+	EXPECT_EQ(store.size(), 50u);
+	EXPECT_EQ(store.getSmoke(3), 0);
+	EXPECT_EQ(store.getFire(3), 0);
+	EXPECT_EQ(store.getLight(3, LL_UNITS), 0);
+	EXPECT_FALSE(store.isDiscovered(3, O_FLOOR));
+	EXPECT_EQ(store.getUnit(3), nullptr);
+}
+
+TEST_F(TileStoreTest, LayersArePacked)
+{
+	store.setLight(10, LL_FIRE, 7);
+	store.setLight(11, LL_FIRE, 8);
+	store.setSmoke(10, 4);
+
+	const Uint8* fire = store.getLightData(LL_FIRE);
+	EXPECT_EQ(fire[10], 7);
+	EXPECT_EQ(fire[11], 8);
+	EXPECT_EQ(store.getLightData(LL_AMBIENT)[10], 0);
+	EXPECT_EQ(store.getSmokeData()[10], 4);
+	EXPECT_EQ(store.getSmokeData()[11], 0);
+}
+
+TEST_F(TileStoreTest, DiscoveredBitsAreIndependent)
+{
+	store.setDiscovered(7, O_WESTWALL, true);
+	store.setDiscovered(7, O_NORTHWALL, true);
+	store.setDiscovered(7, O_WESTWALL, false);
+
+	EXPECT_FALSE(store.isDiscovered(7, O_WESTWALL));
+	EXPECT_TRUE(store.isDiscovered(7, O_NORTHWALL));
+	EXPECT_FALSE(store.isDiscovered(7, O_FLOOR));
+	EXPECT_FALSE(store.isDiscovered(8, O_NORTHWALL));
+}
+
+TEST_F(TileStoreTest, TUCost)
+{
+	store.setTUCost(20, O_OBJECT, { 4, 300, -1 });
+
+	EXPECT_EQ(store.getTUCost(20, O_OBJECT, MT_WALK), 4);
+	EXPECT_EQ(store.getTUCost(20, O_OBJECT, MT_FLY), 255);
+	EXPECT_EQ(store.getTUCost(20, O_OBJECT, MT_SLIDE), 0);
+	EXPECT_EQ(store.getTUCost(20, O_OBJECT, MT_FLOAT), 0);
+	EXPECT_EQ(store.getTUCost(20, O_FLOOR, MT_WALK), 0);
+	EXPECT_EQ(store.getTUCost(21, O_OBJECT, MT_WALK), 0);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/// Compares structure, tags and values of two node trees, formatting style is ignored.
+inline bool sameTree(const YAML::Node &a, const YAML::Node &b)
+{
+	if (a.Type() != b.Type() || (a.Type() != YAML::NodeType::Null && a.Tag() != b.Tag()))
+		return false;
+	if (a.IsScalar())
+		return a.Scalar() == b.Scalar();
+	if (a.size() != b.size())
+		return false;
+	if (a.IsSequence())
+	{
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			if (!sameTree(a[i], b[i]))
+				return false;
+		}
+	}
+	if (a.IsMap())
+	{
+		for (YAML::const_iterator i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j)
+		{
+			if (!sameTree(i->first, j->first) || !sameTree(i->second, j->second))
+				return false;
+		}
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <exception>
+#include <SDL.h>
+#include <yaml-cpp/yaml.h>
+#include "version.h"
+#include "Engine/Logger.h"
+#include "Engine/CrossPlatform.h"
+#include "Engine/Game.h"
+#include "Engine/Options.h"
+#include "Engine/FileMap.h"
+#include "Geoscape/GeoscapeSimulator.h"
+#include "Lua/LuaMod.h"
+#include "Lua/GameScript.h"
+#include "Savegame/SavedGame.h"
+
+/**
+ * Headless geoscape simulator, loads saved game and runs strategic layer
+ * for given number of months without drawing anything or asking the player.
+ *
+ * Usage: openxcom_geosim -save FILE [-months N] [OPTION]...
+ * All other options are same as for the game itself (-data, -user, -KEY VALUE).
+ */
+
+using namespace OpenXcom;
+
+int main(int argc, char *argv[])
+{
+	CrossPlatform::processArgs(argc, argv);
+
+	std::string saveName;
+	int months = 1;
+	const auto& args = CrossPlatform::getArgs();
+	for (size_t i = 1; i + 1 < args.size(); ++i)
+	{
+		if (args[i] == "-save")
+		{
+			saveName = args[++i];
+		}
+		else if (args[i] == "-months")
+		{
+			months = std::max(1, std::atoi(args[++i].c_str()));
+		}
+	}
+	if (saveName.empty())
+	{
+		std::cerr << "Usage: openxcom_geosim -save FILE [-months N] [OPTION]..." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (!Options::init())
+		return EXIT_SUCCESS;
+
+	// nothing is ever shown or played
+	SDL_putenv((char *)"SDL_VIDEODRIVER=dummy");
+	SDL_putenv((char *)"SDL_AUDIODRIVER=dummy");
+	Options::useOpenGL = false;
+	Options::fullscreen = false;
+	Options::baseXResolution = Options::baseXGeoscape;
+	Options::baseYResolution = Options::baseYGeoscape;
+
+	int result = EXIT_SUCCESS;
+	Game *game = 0;
+	try
+	{
+		std::ostringstream title;
+		title << "OpenXcom " << OPENXCOM_VERSION_SHORT << OPENXCOM_VERSION_GIT;
+		game = new Game(title.str());
+		Options::mute = true;
+
+		Options::updateMods();
+		game->loadMods();
+		game->loadLanguages();
+
+		SavedGame *save = new SavedGame();
+		YAML::Node doc;
+		save->load(saveName, game->getMod(), game->getLanguage(), doc);
+		game->setSavedGame(save);
+		game->getLuaMod().getGameScript().onLoadGame().dispatchCallback(doc);
+		if (save->getSavedBattle() != 0)
+		{
+			Log(LOG_WARNING) << "Saved game is in battle, battle is ignored.";
+		}
+
+		GeoscapeSimulator simulator(game);
+		simulator.run(months);
+		simulator.report(std::cout);
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		result = EXIT_FAILURE;
+	}
+
+	delete game;
+	FileMap::clear(true, false);
+
+	return result;
+}
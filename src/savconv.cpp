@@ -0,0 +1,83 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdlib>
+#include <iostream>
+#include <exception>
+#include <string>
+#include "Savegame/BinarySave.h"
+
+/**
+ * Converts savegames between YAML and binary format, conversion is lossless in both directions.
+ *
+ * Usage: openxcom_savconv [-yaml|-binary|-compressed] IN OUT
+ * Without format option binary saves are converted to YAML and YAML saves to compressed binary.
+ */
+
+using namespace OpenXcom;
+
+int main(int argc, char *argv[])
+{
+	std::string format, from, to;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "-yaml" || arg == "-binary" || arg == "-compressed")
+		{
+			format = arg;
+		}
+		else if (from.empty())
+		{
+			from = arg;
+		}
+		else if (to.empty())
+		{
+			to = arg;
+		}
+		else
+		{
+			from.clear();
+			break;
+		}
+	}
+	if (from.empty() || to.empty())
+	{
+		std::cerr << "Usage: openxcom_savconv [-yaml|-binary|-compressed] IN OUT" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		BinarySave::SaveFormat saveFormat;
+		if (format == "-yaml")
+			saveFormat = BinarySave::SF_YAML;
+		else if (format == "-binary")
+			saveFormat = BinarySave::SF_BINARY;
+		else if (format == "-compressed")
+			saveFormat = BinarySave::SF_BINARY_COMPRESSED;
+		else
+			saveFormat = BinarySave::isBinary(from) ? BinarySave::SF_YAML : BinarySave::SF_BINARY_COMPRESSED;
+		BinarySave::convert(from, to, saveFormat);
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}